@@ -0,0 +1,315 @@
+// Parallel algorithm benchmarks
+// Every algorithm of ParallelAlgorithms is compared with its standard counterpart on 1M, 10M and 100M elements,
+// with 1, 2, 4 ... hardware_concurrency standard threads, and one JSON object per line is printed
+// The output of every parallel algorithm is compared with the standard one, a mismatch fails the run
+//
+// Usage: AlgorithmsBenchmark [--quick] [--max-threads N] [--max-elements N] [--filter Name]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "MultithreadingModule.h"
+#include "ParallelAlgorithms.h"
+
+struct BenchmarkOptions
+{
+	bool bQuick;
+	unsigned int MaxNumOfThreads;
+	size_t MaxNumOfElements;
+	std::string Filter;
+
+	BenchmarkOptions() : bQuick(false), MaxNumOfThreads(0), MaxNumOfElements(100000000) {}
+};
+
+typedef std::vector<std::pair<std::string, double>> BenchmarkValues;
+
+static unsigned long long GetTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void PrintResult(const std::string& Benchmark, unsigned int NumOfThreads, const BenchmarkValues& Values)
+{
+	std::ostringstream Line;
+	Line << "{\"benchmark\":\"" << Benchmark << "\",\"threads\":" << NumOfThreads;
+	for (size_t i = 0; i < Values.size(); i++)
+	{
+		Line << ",\"" << Values[i].first << "\":" << Values[i].second;
+	}
+	Line << "}\n";
+
+	std::cout << Line.str() << std::flush;
+}
+
+static void SetNumOfThreads(MultithreadingModule& Module, unsigned int NumOfThreads)
+{
+	Module.SetMaxNumOfThreads(NumOfThreads);
+	Module.ChangeNumOfRunningThreads(NumOfThreads);
+
+	while (Module.GetNumOfThreads() != NumOfThreads)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// Runs the parallel and the standard version on copies of the same input and prints the best times of both
+// @param Prepare - restores the input before each run, it is not measured
+// @param Result - output written by both versions, the outputs of the first sample are compared
+// @return false if the parallel output differs from the standard one
+template<typename PrepareFunction, typename ParallelFunction, typename StandardFunction, typename Container>
+static bool CompareWithStandard(const std::string& Benchmark, unsigned int NumOfThreads, size_t NumOfElements, unsigned int NumOfSamples,
+	PrepareFunction Prepare, ParallelFunction Parallel, StandardFunction Standard, const Container& Result)
+{
+	unsigned long long ParallelTime = 0;
+	unsigned long long StandardTime = 0;
+	bool bMatches = true;
+
+	for (unsigned int i = 0; i < NumOfSamples; i++)
+	{
+		Prepare();
+		unsigned long long Start = GetTime();
+		Parallel();
+		const unsigned long long CurrentParallelTime = GetTime() - Start;
+
+		Container ParallelResult;
+		if (i == 0)
+		{
+			ParallelResult = Result;
+		}
+
+		Prepare();
+		Start = GetTime();
+		Standard();
+		const unsigned long long CurrentStandardTime = GetTime() - Start;
+
+		if (i == 0 && !(ParallelResult == Result))
+		{
+			std::cerr << Benchmark << ": the parallel output differs from the standard one with " << NumOfThreads << " threads and "
+				<< NumOfElements << " elements\n";
+			bMatches = false;
+		}
+
+		if (i == 0 || CurrentParallelTime < ParallelTime)
+		{
+			ParallelTime = CurrentParallelTime;
+		}
+		if (i == 0 || CurrentStandardTime < StandardTime)
+		{
+			StandardTime = CurrentStandardTime;
+		}
+	}
+
+	BenchmarkValues Values;
+	Values.push_back(std::make_pair("elements", static_cast<double>(NumOfElements)));
+	Values.push_back(std::make_pair("parallel_min_ns", static_cast<double>(ParallelTime)));
+	Values.push_back(std::make_pair("std_min_ns", static_cast<double>(StandardTime)));
+	Values.push_back(std::make_pair("speedup", ParallelTime != 0 ? static_cast<double>(StandardTime) / ParallelTime : 0.0));
+	PrintResult(Benchmark, NumOfThreads, Values);
+
+	return bMatches;
+}
+
+
+// Sorting of random keys, such as the sort keys of a draw list
+static bool BenchmarkSort(MultithreadingModule& Module, size_t NumOfElements, unsigned int NumOfSamples, unsigned int NumOfThreads)
+{
+	std::vector<unsigned int> Input(NumOfElements);
+	std::mt19937 Random(1);
+	for (size_t i = 0; i < Input.size(); i++)
+	{
+		Input[i] = Random();
+	}
+
+	std::vector<unsigned int> Data;
+	return CompareWithStandard("sort", NumOfThreads, NumOfElements, NumOfSamples,
+		[&]() { Data = Input; },
+		[&]() { ParallelAlgorithms::Sort(&Module, Data.begin(), Data.end()); },
+		[&]() { std::sort(Data.begin(), Data.end()); },
+		Data);
+}
+
+// Prefix sums of the flags of a compaction
+static bool BenchmarkScan(MultithreadingModule& Module, size_t NumOfElements, unsigned int NumOfSamples, unsigned int NumOfThreads)
+{
+	std::vector<unsigned int> Input(NumOfElements);
+	std::mt19937 Random(2);
+	for (size_t i = 0; i < Input.size(); i++)
+	{
+		Input[i] = Random() & 1;
+	}
+
+	std::vector<unsigned int> Output(NumOfElements);
+	const bool bInclusiveMatches = CompareWithStandard("inclusive_scan", NumOfThreads, NumOfElements, NumOfSamples,
+		[]() {},
+		[&]() { ParallelAlgorithms::InclusiveScan(&Module, Input.begin(), Input.end(), Output.begin()); },
+		[&]() { std::partial_sum(Input.begin(), Input.end(), Output.begin()); },
+		Output);
+
+	// The standard exclusive scan is not available before C++17, so it is written by hand
+	const bool bExclusiveMatches = CompareWithStandard("exclusive_scan", NumOfThreads, NumOfElements, NumOfSamples,
+		[]() {},
+		[&]() { ParallelAlgorithms::ExclusiveScan(&Module, Input.begin(), Input.end(), Output.begin(), 0u); },
+		[&]()
+		{
+			unsigned int Sum = 0;
+			for (size_t i = 0; i < Input.size(); i++)
+			{
+				Output[i] = Sum;
+				Sum += Input[i];
+			}
+		},
+		Output);
+
+	return bInclusiveMatches && bExclusiveMatches;
+}
+
+// Partitioning of objects into visible and hidden ones
+static bool BenchmarkPartition(MultithreadingModule& Module, size_t NumOfElements, unsigned int NumOfSamples, unsigned int NumOfThreads)
+{
+	std::vector<unsigned int> Input(NumOfElements);
+	std::mt19937 Random(3);
+	for (size_t i = 0; i < Input.size(); i++)
+	{
+		Input[i] = Random();
+	}
+
+	std::vector<unsigned int> Data;
+	auto IsVisible = [](unsigned int Value) { return (Value & 3) != 0; };
+	return CompareWithStandard("stable_partition", NumOfThreads, NumOfElements, NumOfSamples,
+		[&]() { Data = Input; },
+		[&]() { ParallelAlgorithms::StablePartition(&Module, Data.begin(), Data.end(), IsVisible); },
+		[&]() { std::stable_partition(Data.begin(), Data.end(), IsVisible); },
+		Data);
+}
+
+static bool BenchmarkTransform(MultithreadingModule& Module, size_t NumOfElements, unsigned int NumOfSamples, unsigned int NumOfThreads)
+{
+	std::vector<float> Input(NumOfElements);
+	for (size_t i = 0; i < Input.size(); i++)
+	{
+		Input[i] = static_cast<float>(i);
+	}
+
+	std::vector<float> Output(NumOfElements);
+	auto Operation = [](float Value) { return Value * 0.5f + 1.0f; };
+	return CompareWithStandard("transform", NumOfThreads, NumOfElements, NumOfSamples,
+		[]() {},
+		[&]() { ParallelAlgorithms::Transform(&Module, Input.begin(), Input.end(), Output.begin(), Operation); },
+		[&]() { std::transform(Input.begin(), Input.end(), Output.begin(), Operation); },
+		Output);
+}
+
+
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& Options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--quick") == 0)
+		{
+			Options.bQuick = true;
+		}
+		else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc)
+		{
+			Options.MaxNumOfThreads = static_cast<unsigned int>(std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--max-elements") == 0 && i + 1 < argc)
+		{
+			Options.MaxNumOfElements = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			Options.Filter = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--quick] [--max-threads N] [--max-elements N] [--filter Name]\n";
+			return false;
+		}
+	}
+
+	if (Options.MaxNumOfThreads == 0)
+	{
+		Options.MaxNumOfThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// The quick run only checks that the benchmarks work
+	if (Options.bQuick)
+	{
+		Options.MaxNumOfElements = std::min<size_t>(Options.MaxNumOfElements, 1000000);
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions Options;
+	if (!ParseOptions(argc, argv, Options))
+	{
+		return 1;
+	}
+
+	typedef bool (*Benchmark)(MultithreadingModule&, size_t, unsigned int, unsigned int);
+	const std::pair<const char*, Benchmark> Benchmarks[] =
+	{
+		{ "sort", &BenchmarkSort },
+		{ "scan", &BenchmarkScan },
+		{ "partition", &BenchmarkPartition },
+		{ "transform", &BenchmarkTransform }
+	};
+
+	std::vector<size_t> NumsOfElements;
+	for (size_t NumOfElements = 1000000; NumOfElements <= Options.MaxNumOfElements; NumOfElements *= 10)
+	{
+		NumsOfElements.push_back(NumOfElements);
+	}
+
+	// 1, 2, 4 ... and the number of hardware threads itself
+	std::vector<unsigned int> NumsOfThreads;
+	for (unsigned int NumOfThreads = 1; NumOfThreads < Options.MaxNumOfThreads; NumOfThreads *= 2)
+	{
+		NumsOfThreads.push_back(NumOfThreads);
+	}
+	NumsOfThreads.push_back(Options.MaxNumOfThreads);
+
+	const unsigned int NumOfSamples = Options.bQuick ? 1 : 3;
+
+	MultithreadingModule Module;
+	Module.StartThreads();
+
+	bool bAllMatch = true;
+
+	for (size_t i = 0; i < NumsOfThreads.size(); i++)
+	{
+		SetNumOfThreads(Module, NumsOfThreads[i]);
+
+		for (size_t j = 0; j < NumsOfElements.size(); j++)
+		{
+			for (const std::pair<const char*, Benchmark>& CurrentBenchmark : Benchmarks)
+			{
+				if (!Options.Filter.empty() && std::string(CurrentBenchmark.first).find(Options.Filter) == std::string::npos)
+				{
+					continue;
+				}
+
+				if (!CurrentBenchmark.second(Module, NumsOfElements[j], NumOfSamples, NumsOfThreads[i]))
+				{
+					bAllMatch = false;
+				}
+			}
+		}
+	}
+
+	Module.StopThreads();
+
+	return bAllMatch ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+// Scheduler benchmarks
+// Every benchmark runs with 1, 2, 4 ... hardware_concurrency standard threads and prints one JSON object per line,
+// so that the results of two builds can be compared line by line
+//
+// Usage: SchedulerBenchmark [--quick] [--max-threads N] [--filter Name]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "MultithreadingModule.h"
+#include "ThreadFunctionTask.h"
+
+struct BenchmarkOptions
+{
+	bool bQuick;
+	unsigned int MaxNumOfThreads;
+	std::string Filter;
+
+	BenchmarkOptions() : bQuick(false), MaxNumOfThreads(0) {}
+};
+
+typedef std::vector<std::pair<std::string, double>> BenchmarkValues;
+
+static unsigned long long GetTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void PrintResult(const std::string& Benchmark, unsigned int NumOfThreads, const BenchmarkValues& Values)
+{
+	std::ostringstream Line;
+	Line << "{\"benchmark\":\"" << Benchmark << "\",\"threads\":" << NumOfThreads;
+	for (size_t i = 0; i < Values.size(); i++)
+	{
+		Line << ",\"" << Values[i].first << "\":" << Values[i].second;
+	}
+	Line << "}\n";
+
+	std::cout << Line.str() << std::flush;
+}
+
+// Adds the mean, minimum and percentiles of the samples to the values
+static void AddSummary(BenchmarkValues& Values, const std::string& Prefix, std::vector<unsigned long long> Samples)
+{
+	if (Samples.empty())
+	{
+		return;
+	}
+
+	std::sort(Samples.begin(), Samples.end());
+
+	double Sum = 0.0;
+	for (size_t i = 0; i < Samples.size(); i++)
+	{
+		Sum += static_cast<double>(Samples[i]);
+	}
+
+	Values.push_back(std::make_pair(Prefix + "_mean_ns", Sum / Samples.size()));
+	Values.push_back(std::make_pair(Prefix + "_min_ns", static_cast<double>(Samples.front())));
+	Values.push_back(std::make_pair(Prefix + "_p50_ns", static_cast<double>(Samples[Samples.size() / 2])));
+	Values.push_back(std::make_pair(Prefix + "_p99_ns", static_cast<double>(Samples[(Samples.size() * 99) / 100])));
+}
+
+static bool AreAllThreadsStarted(MultithreadingModule& Module, unsigned int NumOfThreads)
+{
+	std::vector<ThreadState> States = Module.GetThreadsStates();
+	if (States.size() != NumOfThreads)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < States.size(); i++)
+	{
+		if (States[i] == ThreadState::NotReadyToStart || States[i] == ThreadState::ReadyToStart)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void SetNumOfThreads(MultithreadingModule& Module, unsigned int NumOfThreads)
+{
+	Module.SetMaxNumOfThreads(NumOfThreads);
+	Module.ChangeNumOfRunningThreads(NumOfThreads);
+
+	while (!AreAllThreadsStarted(Module, NumOfThreads))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+
+// Duration of Tick with empty Tick tasks
+static void BenchmarkEmptyTick(MultithreadingModule& Module, const BenchmarkOptions& Options, unsigned int NumOfThreads)
+{
+	const unsigned int NumsOfTickTasks[] = { 0, 1000, 100000 };
+
+	for (unsigned int NumOfTickTasks : NumsOfTickTasks)
+	{
+		for (unsigned int i = 0; i < NumOfTickTasks; i++)
+		{
+			Module.AddTask(new ThreadFunctionTask([](const float&) {}));
+		}
+
+		unsigned int NumOfIterations = NumOfTickTasks >= 100000 ? 20 : 200;
+		if (Options.bQuick)
+		{
+			NumOfIterations /= 10;
+		}
+
+		// Warm up
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			Module.Tick(0.0f);
+		}
+
+		std::vector<unsigned long long> Samples;
+		for (unsigned int i = 0; i < NumOfIterations; i++)
+		{
+			const unsigned long long Start = GetTime();
+			Module.Tick(0.0f);
+			Samples.push_back(GetTime() - Start);
+		}
+
+		Module.RemoveAllTickTasks();
+
+		BenchmarkValues Values;
+		Values.push_back(std::make_pair("tick_tasks", static_cast<double>(NumOfTickTasks)));
+		Values.push_back(std::make_pair("iterations", static_cast<double>(NumOfIterations)));
+		AddSummary(Values, "tick", Samples);
+		PrintResult("empty_tick", NumOfThreads, Values);
+	}
+}
+
+// Number of executed Once tasks per second when several threads add them at the same time
+static void BenchmarkOnceThroughput(MultithreadingModule& Module, const BenchmarkOptions& Options, unsigned int NumOfThreads)
+{
+	const unsigned int NumOfTasks = Options.bQuick ? 20000 : 200000;
+
+	for (unsigned int NumOfProducers = 1; NumOfProducers <= Options.MaxNumOfThreads; NumOfProducers *= 2)
+	{
+		std::atomic<unsigned int> NumOfExecutedTasks(0);
+		std::atomic<bool> bStart(false);
+
+		std::vector<std::thread> Producers;
+		for (unsigned int i = 0; i < NumOfProducers; i++)
+		{
+			const unsigned int NumOfProducerTasks = NumOfTasks / NumOfProducers + (i < NumOfTasks % NumOfProducers ? 1 : 0);
+
+			Producers.push_back(std::thread([&Module, &NumOfExecutedTasks, &bStart, NumOfProducerTasks]()
+			{
+				while (!bStart.load())
+				{
+					std::this_thread::yield();
+				}
+
+				for (unsigned int j = 0; j < NumOfProducerTasks; j++)
+				{
+					Module.AddTask(new ThreadFunctionTask([&NumOfExecutedTasks]() { NumOfExecutedTasks.fetch_add(1, std::memory_order_relaxed); }));
+				}
+			}));
+		}
+
+		const unsigned long long Start = GetTime();
+		bStart.store(true);
+
+		for (size_t i = 0; i < Producers.size(); i++)
+		{
+			Producers[i].join();
+		}
+		const unsigned long long SubmissionEnd = GetTime();
+
+		while (NumOfExecutedTasks.load() < NumOfTasks)
+		{
+			std::this_thread::yield();
+		}
+		const unsigned long long End = GetTime();
+
+		BenchmarkValues Values;
+		Values.push_back(std::make_pair("producers", static_cast<double>(NumOfProducers)));
+		Values.push_back(std::make_pair("tasks", static_cast<double>(NumOfTasks)));
+		Values.push_back(std::make_pair("submission_ns", static_cast<double>(SubmissionEnd - Start)));
+		Values.push_back(std::make_pair("total_ns", static_cast<double>(End - Start)));
+		Values.push_back(std::make_pair("tasks_per_second", NumOfTasks / ((End - Start) / 1e9)));
+		PrintResult("once_throughput", NumOfThreads, Values);
+	}
+}
+
+// Time from adding a Once task to an idle pool to the start of its execution
+static void BenchmarkWakeLatency(MultithreadingModule& Module, const BenchmarkOptions& Options, unsigned int NumOfThreads)
+{
+	const unsigned int NumOfSamples = Options.bQuick ? 20 : 200;
+
+	std::vector<unsigned long long> Samples;
+	for (unsigned int i = 0; i < NumOfSamples; i++)
+	{
+		// Let the threads fall asleep
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		std::atomic<unsigned long long> ExecutionStart(0);
+		const unsigned long long Start = GetTime();
+		Module.AddTask(new ThreadFunctionTask([&ExecutionStart]() { ExecutionStart.store(GetTime()); }));
+
+		while (ExecutionStart.load() == 0)
+		{
+			std::this_thread::yield();
+		}
+
+		Samples.push_back(ExecutionStart.load() - Start);
+	}
+
+	BenchmarkValues Values;
+	Values.push_back(std::make_pair("samples", static_cast<double>(NumOfSamples)));
+	AddSummary(Values, "latency", Samples);
+	PrintResult("wake_latency", NumOfThreads, Values);
+}
+
+// Time until all standard threads are running after StartThreads, and duration of StopThreads
+static void BenchmarkStartStop(MultithreadingModule& Module, const BenchmarkOptions& Options, unsigned int NumOfThreads)
+{
+	const unsigned int NumOfSamples = Options.bQuick ? 3 : 20;
+
+	std::vector<unsigned long long> StartSamples;
+	std::vector<unsigned long long> StopSamples;
+	for (unsigned int i = 0; i < NumOfSamples; i++)
+	{
+		const unsigned long long StopStart = GetTime();
+		Module.StopThreads();
+		StopSamples.push_back(GetTime() - StopStart);
+
+		const unsigned long long StartStart = GetTime();
+		Module.StartThreads();
+		while (!AreAllThreadsStarted(Module, NumOfThreads))
+		{
+			std::this_thread::yield();
+		}
+		StartSamples.push_back(GetTime() - StartStart);
+	}
+
+	BenchmarkValues Values;
+	Values.push_back(std::make_pair("samples", static_cast<double>(NumOfSamples)));
+	AddSummary(Values, "start", StartSamples);
+	AddSummary(Values, "stop", StopSamples);
+	PrintResult("start_stop", NumOfThreads, Values);
+}
+
+// Time from adding a dedicated task to the start of its execution
+static void BenchmarkDedicatedSpawn(MultithreadingModule& Module, const BenchmarkOptions& Options, unsigned int NumOfThreads)
+{
+	const unsigned int NumOfSamples = Options.bQuick ? 20 : 200;
+
+	std::vector<unsigned long long> Samples;
+	for (unsigned int i = 0; i < NumOfSamples; i++)
+	{
+		std::atomic<unsigned long long> ExecutionStart(0);
+		std::atomic<bool> bCompleted(false);
+
+		const unsigned long long Start = GetTime();
+		Module.AddTask(new ThreadFunctionTask([&ExecutionStart, &bCompleted](const TaskStopSignal&)
+		{
+			ExecutionStart.store(GetTime());
+			bCompleted.store(true);
+		}));
+
+		while (!bCompleted.load())
+		{
+			std::this_thread::yield();
+		}
+
+		Samples.push_back(ExecutionStart.load() - Start);
+	}
+
+	BenchmarkValues Values;
+	Values.push_back(std::make_pair("samples", static_cast<double>(NumOfSamples)));
+	Values.push_back(std::make_pair("pool_hit_rate", Module.GetDedicatedThreadsPoolHitRate()));
+	AddSummary(Values, "spawn", Samples);
+	PrintResult("dedicated_spawn", NumOfThreads, Values);
+}
+
+
+static bool ParseOptions(int argc, char** argv, BenchmarkOptions& Options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--quick") == 0)
+		{
+			Options.bQuick = true;
+		}
+		else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc)
+		{
+			Options.MaxNumOfThreads = static_cast<unsigned int>(std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			Options.Filter = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--quick] [--max-threads N] [--filter Name]\n";
+			return false;
+		}
+	}
+
+	if (Options.MaxNumOfThreads == 0)
+	{
+		Options.MaxNumOfThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions Options;
+	if (!ParseOptions(argc, argv, Options))
+	{
+		return 1;
+	}
+
+	typedef void (*Benchmark)(MultithreadingModule&, const BenchmarkOptions&, unsigned int);
+	const std::pair<const char*, Benchmark> Benchmarks[] =
+	{
+		{ "empty_tick", &BenchmarkEmptyTick },
+		{ "once_throughput", &BenchmarkOnceThroughput },
+		{ "wake_latency", &BenchmarkWakeLatency },
+		{ "start_stop", &BenchmarkStartStop },
+		{ "dedicated_spawn", &BenchmarkDedicatedSpawn }
+	};
+
+	// 1, 2, 4 ... and the number of hardware threads itself
+	std::vector<unsigned int> NumsOfThreads;
+	for (unsigned int NumOfThreads = 1; NumOfThreads < Options.MaxNumOfThreads; NumOfThreads *= 2)
+	{
+		NumsOfThreads.push_back(NumOfThreads);
+	}
+	NumsOfThreads.push_back(Options.MaxNumOfThreads);
+
+	MultithreadingModule Module;
+	Module.StartThreads();
+
+	for (size_t i = 0; i < NumsOfThreads.size(); i++)
+	{
+		SetNumOfThreads(Module, NumsOfThreads[i]);
+
+		for (const std::pair<const char*, Benchmark>& CurrentBenchmark : Benchmarks)
+		{
+			if (!Options.Filter.empty() && std::string(CurrentBenchmark.first).find(Options.Filter) == std::string::npos)
+			{
+				continue;
+			}
+
+			CurrentBenchmark.second(Module, Options, NumsOfThreads[i]);
+		}
+	}
+
+	Module.StopThreads();
+
+	return 0;
+}
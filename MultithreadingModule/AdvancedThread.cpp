@@ -1,32 +1,49 @@
 #include "AdvancedThread.h"
 
-unsigned int AdvancedThread::MaxTickTasksPerIteration = 2000;
-std::mutex AdvancedThread::MaxTickTasksPerIterationMutex;
-unsigned int AdvancedThread::MaxOnceTasksPerIteration = 1;
-std::mutex AdvancedThread::MaxOnceTasksPerIterationMutex;
+TaskErrorSink AdvancedThread::ErrorSink;
+thread_local AdvancedThread* AdvancedThread::CurrentThread = nullptr;
+std::mutex AdvancedThread::ErrorSinkMutex;
 
 AdvancedThread::AdvancedThread() :
     ControlledThread(nullptr),
     bCanBeDestroyed(true),
-    bIsDedicatedThread(false),
-    TaskForDedicatedExecution(nullptr),
     bMustStop(false), bMustSleep(false),
     State(ThreadState::NotReadyToStart),
+    bIsDedicatedThread(false),
+    TaskForDedicatedExecution(nullptr),
+    bIsPooledDedicatedThread(false),
     bThreadCompletedTick(false),
-    OnceTasksRef(nullptr), OnceTasksMutexRef(nullptr),
+    bMustPark(false),
+    BusyTime(0),
+    TickCompletionTime(0),
+    AverageTickTaskDuration(0.0f), AverageOnceTaskDuration(0.0f), BlockingDepth(0), ScratchArenaFrame(0), NumOfStarts(0),
+    NumOfTaskExceptionsRef(nullptr), FrameIndexRef(nullptr), LifecycleHooksRef(nullptr), LifecycleHooksMutexRef(nullptr),
+    OnceTasksRef(nullptr), OnceTasksMutexRef(nullptr), OnceTasksSpaceConditionRef(nullptr),
     TickTasksRef(nullptr), TickTasksMutexRef(nullptr),
     bThreadCompletedTickTasksRef(nullptr), ThreadCompletedTickTasksMutexRef(nullptr), ThreadCompletedTickTasksConditionRef(nullptr),
-    DeltaTickRef(nullptr), DeltaTickMutexRef(nullptr) {}
+    DeltaTickRef(nullptr), DeltaTickMutexRef(nullptr),
+    MaxTickTasksPerIterationRef(nullptr), MaxTickTasksPerIterationMutexRef(nullptr),
+    MaxOnceTasksPerIterationRef(nullptr), MaxOnceTasksPerIterationMutexRef(nullptr),
+    ChunkingRef(nullptr), ChunkingMutexRef(nullptr),
+    NumOfThreadsRef(nullptr), NumOfThreadsMutexRef(nullptr) {}
 
 AdvancedThread::~AdvancedThread()
 {
     StopWithWaiting();
 }
 
-void AdvancedThread::Initialize(std::queue<ThreadTask*>* OnceTasks, std::mutex* OnceTasksMutex,
+void AdvancedThread::Initialize(OnceTaskQueue* OnceTasks, std::mutex* OnceTasksMutex, std::condition_variable* OnceTasksSpaceCondition,
     std::queue<ThreadTask*>* TickTasks, std::mutex* TickTasksMutex,
     bool* bThreadCompletedTickTasks, std::mutex* ThreadCompletedTickTasksMutex, std::condition_variable* ThreadCompletedTickTasksCondition,
-    float* DeltaTick, std::mutex* DeltaTickMutex)
+    float* DeltaTick, std::mutex* DeltaTickMutex,
+    unsigned int* MaxTickTasksPerIteration, std::mutex* MaxTickTasksPerIterationMutex,
+    unsigned int* MaxOnceTasksPerIteration, std::mutex* MaxOnceTasksPerIterationMutex,
+    ChunkingPolicy* Chunking, std::mutex* ChunkingMutex,
+    unsigned int* NumOfThreads, std::mutex* NumOfThreadsMutex,
+    std::atomic<unsigned long long>* NumOfTaskExceptions,
+    const std::atomic<unsigned long long>* FrameIndex,
+    const WorkerLifecycleHooks* LifecycleHooks, std::mutex* LifecycleHooksMutex,
+    const ThreadBlockingCallback& NewBlockingCallback)
 {
     // If the thread is running, then we forbid initialization
     if (!(GetState() == ThreadState::Stopped || GetState() == ThreadState::NotReadyToStart))
@@ -34,7 +51,7 @@ void AdvancedThread::Initialize(std::queue<ThreadTask*>* OnceTasks, std::mutex*
         return;
     }
 
-    if (OnceTasks == nullptr || OnceTasksMutex == nullptr)
+    if (OnceTasks == nullptr || OnceTasksMutex == nullptr || OnceTasksSpaceCondition == nullptr)
     {
         return;
     }
@@ -50,6 +67,22 @@ void AdvancedThread::Initialize(std::queue<ThreadTask*>* OnceTasks, std::mutex*
     {
         return;
     }
+    if (MaxTickTasksPerIteration == nullptr || MaxTickTasksPerIterationMutex == nullptr)
+    {
+        return;
+    }
+    if (MaxOnceTasksPerIteration == nullptr || MaxOnceTasksPerIterationMutex == nullptr)
+    {
+        return;
+    }
+    if (Chunking == nullptr || ChunkingMutex == nullptr)
+    {
+        return;
+    }
+    if (NumOfThreads == nullptr || NumOfThreadsMutex == nullptr)
+    {
+        return;
+    }
     
     if (ControlledThread != nullptr)
     {
@@ -60,6 +93,7 @@ void AdvancedThread::Initialize(std::queue<ThreadTask*>* OnceTasks, std::mutex*
 
     OnceTasksRef = OnceTasks;
     OnceTasksMutexRef = OnceTasksMutex;
+    OnceTasksSpaceConditionRef = OnceTasksSpaceCondition;
 
     TickTasksRef = TickTasks;
     TickTasksMutexRef = TickTasksMutex;
@@ -71,6 +105,35 @@ void AdvancedThread::Initialize(std::queue<ThreadTask*>* OnceTasks, std::mutex*
     DeltaTickRef = DeltaTick;
     DeltaTickMutexRef = DeltaTickMutex;
 
+    MaxTickTasksPerIterationRef = MaxTickTasksPerIteration;
+    MaxTickTasksPerIterationMutexRef = MaxTickTasksPerIterationMutex;
+
+    MaxOnceTasksPerIterationRef = MaxOnceTasksPerIteration;
+    MaxOnceTasksPerIterationMutexRef = MaxOnceTasksPerIterationMutex;
+
+    ChunkingRef = Chunking;
+    ChunkingMutexRef = ChunkingMutex;
+
+    NumOfThreadsRef = NumOfThreads;
+    NumOfThreadsMutexRef = NumOfThreadsMutex;
+
+    AverageTickTaskDuration = 0.0f;
+    AverageOnceTaskDuration = 0.0f;
+
+    BlockingCallback = NewBlockingCallback;
+    BlockingDepth = 0;
+
+    FrameIndexRef = FrameIndex;
+    ScratchArenaFrame = FrameIndex != nullptr ? FrameIndex->load() : 0;
+    ScratchArena.Reset();
+
+    LifecycleHooksRef = LifecycleHooks;
+    LifecycleHooksMutexRef = LifecycleHooksMutex;
+
+    NumOfTaskExceptionsRef = NumOfTaskExceptions;
+
+    Counters.Reset();
+
     SetIsDedicated(false);
     SetState(ThreadState::ReadyToStart);
 }
@@ -98,7 +161,44 @@ void AdvancedThread::Initialize(ThreadTask* Task)
     std::lock_guard<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
     TaskForDedicatedExecution = Task;
 
+    NumOfTaskExceptionsRef = nullptr;
+
+    FrameIndexRef = nullptr;
+    ScratchArena.Reset();
+
+    LifecycleHooksRef = nullptr;
+    LifecycleHooksMutexRef = nullptr;
+
     SetIsDedicated(true);
+    SetIsPooledDedicated(false);
+    SetState(ThreadState::ReadyToStart);
+}
+
+void AdvancedThread::InitializeDedicatedPool(std::atomic<unsigned long long>* NumOfTaskExceptions, const WorkerLifecycleHooks* LifecycleHooks, std::mutex* LifecycleHooksMutex)
+{
+    // If the thread is running, then we forbid initialization
+    if (!(GetState() == ThreadState::Stopped || GetState() == ThreadState::NotReadyToStart))
+    {
+        return;
+    }
+
+    if (ControlledThread != nullptr)
+    {
+        ControlledThread->join();
+        delete ControlledThread;
+        ControlledThread = nullptr;
+    }
+
+    NumOfTaskExceptionsRef = NumOfTaskExceptions;
+
+    FrameIndexRef = nullptr;
+    ScratchArena.Reset();
+
+    LifecycleHooksRef = LifecycleHooks;
+    LifecycleHooksMutexRef = LifecycleHooksMutex;
+
+    SetIsDedicated(true);
+    SetIsPooledDedicated(true);
     SetState(ThreadState::ReadyToStart);
 }
 
@@ -114,6 +214,12 @@ bool AdvancedThread::IsDedicated()
     return bIsDedicatedThread;
 }
 
+bool AdvancedThread::IsPooledDedicated()
+{
+    std::lock_guard<std::mutex> Lock(IsPooledDedicatedThreadMutex);
+    return bIsPooledDedicatedThread;
+}
+
 
 void AdvancedThread::Start()
 {
@@ -136,14 +242,28 @@ void AdvancedThread::Start()
 
 void AdvancedThread::Stop()
 {
-    std::lock_guard<std::mutex> Lock(MustStopMutex);
+    if (!IsDedicated())
+    {
+        MustStopMutex.lock();
+        bMustStop = true;
+        MustStopMutex.unlock();
+        return;
+    }
+
+    // The flag is set under the task mutex, so that a pooled dedicated thread that is about to wait for a task cannot miss the notification
+    std::lock_guard<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
+
+    MustStopMutex.lock();
     bMustStop = true;
+    MustStopMutex.unlock();
 
-    if (IsDedicated())
+    // A pooled dedicated thread may not have a task at the moment
+    if (TaskForDedicatedExecution != nullptr)
     {
-        std::lock_guard<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
         TaskForDedicatedExecution->StopDedicatedExecution();
     }
+
+    DedicatedTaskAssignedCondition.notify_all();
 }
 
 void AdvancedThread::StopWithWaiting()
@@ -202,7 +322,7 @@ void AdvancedThread::SleepExecution()
         MustSleepCondition.wait_for(LockMustSleep, std::chrono::milliseconds(5));
 
         // If we need to perform some tasks or stop, then exit the sleep
-        if (GetNeedToCompleteOnceTasks() || !GetThreadCompletedTick() || GetMustStop())
+        if ((!IsParked() && GetNeedToCompleteOnceTasks()) || !GetThreadCompletedTick() || GetMustStop())
         {
             LockMustSleep.unlock();
             WakeUp();
@@ -212,28 +332,262 @@ void AdvancedThread::SleepExecution()
 }
 
 
-void AdvancedThread::SetMaxTickTasksPerIteration(unsigned int NewMax)
+bool AdvancedThread::AssignDedicatedTask(ThreadTask* Task)
 {
-    std::unique_lock<std::mutex> Lock(MaxTickTasksPerIterationMutex);
-    MaxTickTasksPerIteration = NewMax;
+    if (Task == nullptr || !IsPooledDedicated())
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
+
+    if (TaskForDedicatedExecution != nullptr || GetMustStop())
+    {
+        return false;
+    }
+
+    TaskForDedicatedExecution = Task;
+    LockTask.unlock();
+
+    DedicatedTaskAssignedCondition.notify_all();
+
+    return true;
 }
 
-unsigned int AdvancedThread::GetMaxTickTasksPerIteration()
+bool AdvancedThread::IsAwaitingDedicatedTask()
 {
-    std::unique_lock<std::mutex> Lock(MaxTickTasksPerIterationMutex);
-    return MaxTickTasksPerIteration;
+    if (!IsPooledDedicated() || GetState() != ThreadState::Awaiting || GetMustStop())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
+    return TaskForDedicatedExecution == nullptr;
 }
 
-void AdvancedThread::SetMaxOnceTasksPerIteration(unsigned int NewMax)
+
+unsigned int AdvancedThread::GetMaxTickTasksPerIteration()
 {
-    std::unique_lock<std::mutex> Lock(MaxOnceTasksPerIterationMutex);
-    MaxOnceTasksPerIteration = NewMax;
+    std::unique_lock<std::mutex> Lock(*MaxTickTasksPerIterationMutexRef);
+    return *MaxTickTasksPerIterationRef;
 }
 
 unsigned int AdvancedThread::GetMaxOnceTasksPerIteration()
 {
-    std::unique_lock<std::mutex> Lock(MaxOnceTasksPerIterationMutex);
-    return MaxOnceTasksPerIteration;
+    std::unique_lock<std::mutex> Lock(*MaxOnceTasksPerIterationMutexRef);
+    return *MaxOnceTasksPerIterationRef;
+}
+
+ChunkingPolicy AdvancedThread::GetChunkingPolicy()
+{
+    std::unique_lock<std::mutex> Lock(*ChunkingMutexRef);
+    return *ChunkingRef;
+}
+
+unsigned int AdvancedThread::GetNumOfRunningThreads()
+{
+    std::unique_lock<std::mutex> Lock(*NumOfThreadsMutexRef);
+    return *NumOfThreadsRef;
+}
+
+bool AdvancedThread::ExecuteTask(ThreadTask* Task, const float& DeltaTime)
+{
+    // A task marked as blocking holds the blocking section for its whole execution
+    const bool bBlocking = Task->GetBlocking() && BeginBlocking();
+
+    std::exception_ptr Exception;
+    try
+    {
+        Task->Execute(DeltaTime);
+    }
+    catch (...)
+    {
+        Exception = std::current_exception();
+    }
+
+    if (bBlocking)
+    {
+        EndBlocking();
+    }
+
+    if (!Exception)
+    {
+        return true;
+    }
+
+    Task->ReportException(Exception);
+
+    // The sink is copied so that it can be replaced while it is running
+    const TaskErrorSink Sink = GetTaskErrorSink();
+    if (Sink)
+    {
+        // An exception from the sink itself must not stop the thread either
+        try
+        {
+            Sink(Task, Exception);
+        }
+        catch (...)
+        {
+        }
+    }
+
+    return false;
+}
+
+void AdvancedThread::SetTaskErrorSink(const TaskErrorSink& NewSink)
+{
+    std::unique_lock<std::mutex> Lock(ErrorSinkMutex);
+    ErrorSink = NewSink;
+}
+
+bool AdvancedThread::BeginBlocking()
+{
+    AdvancedThread* Thread = CurrentThread;
+    if (Thread == nullptr || !Thread->BlockingCallback)
+    {
+        return false;
+    }
+
+    if (Thread->BlockingDepth++ == 0)
+    {
+        Thread->BlockingCallback(true);
+    }
+    return true;
+}
+
+void AdvancedThread::EndBlocking()
+{
+    AdvancedThread* Thread = CurrentThread;
+    if (Thread == nullptr || Thread->BlockingDepth == 0)
+    {
+        return;
+    }
+
+    if (--Thread->BlockingDepth == 0 && Thread->BlockingCallback)
+    {
+        Thread->BlockingCallback(false);
+    }
+}
+
+LinearArena& AdvancedThread::GetScratchArena()
+{
+    if (CurrentThread != nullptr)
+    {
+        return CurrentThread->ScratchArena;
+    }
+
+    static thread_local LinearArena ThreadArena;
+    return ThreadArena;
+}
+
+void AdvancedThread::ResetCallerScratchArena()
+{
+    // A Tick called by a task of another pool must not reset the memory of that task
+    if (CurrentThread == nullptr)
+    {
+        GetScratchArena().Reset();
+    }
+}
+
+bool AdvancedThread::IsServingQueue(const OnceTaskQueue* OnceTasks)
+{
+    return CurrentThread != nullptr && CurrentThread->OnceTasksRef == OnceTasks && !CurrentThread->IsDedicated();
+}
+
+WorkerLocalStorage& AdvancedThread::GetWorkerLocalStorage()
+{
+    if (CurrentThread != nullptr)
+    {
+        return CurrentThread->LocalStorage;
+    }
+
+    static thread_local WorkerLocalStorage ThreadStorage;
+    return ThreadStorage;
+}
+
+void AdvancedThread::RunLifecycleHook(bool bStart)
+{
+    if (bStart)
+    {
+        NumOfStarts++;
+    }
+
+    WorkerLifecycleHook Hook;
+    if (LifecycleHooksRef != nullptr && LifecycleHooksMutexRef != nullptr)
+    {
+        // The hook is copied so that it can be replaced while it is running
+        std::unique_lock<std::mutex> Lock(*LifecycleHooksMutexRef);
+        Hook = bStart ? LifecycleHooksRef->OnWorkerStart : LifecycleHooksRef->OnWorkerStop;
+    }
+
+    if (Hook)
+    {
+        WorkerInfo Info;
+        Info.bDedicated = IsDedicated();
+        Info.NumOfStarts = NumOfStarts;
+
+        // An exception from the hook must not stop the thread, it is passed to the sink without a task
+        try
+        {
+            Hook(Info);
+        }
+        catch (...)
+        {
+            if (NumOfTaskExceptionsRef != nullptr)
+            {
+                NumOfTaskExceptionsRef->fetch_add(1);
+            }
+
+            const TaskErrorSink Sink = GetTaskErrorSink();
+            if (Sink)
+            {
+                try
+                {
+                    Sink(nullptr, std::current_exception());
+                }
+                catch (...)
+                {
+                }
+            }
+        }
+    }
+
+    // The values of the thread are destroyed after the stop hook, so that it can still use them
+    if (!bStart)
+    {
+        LocalStorage.Clear();
+    }
+}
+
+void AdvancedThread::ResetScratchArenaOnNewFrame()
+{
+    if (FrameIndexRef == nullptr)
+    {
+        return;
+    }
+
+    const unsigned long long FrameIndex = FrameIndexRef->load(std::memory_order_acquire);
+    if (FrameIndex != ScratchArenaFrame)
+    {
+        ScratchArena.Reset();
+        ScratchArenaFrame = FrameIndex;
+    }
+}
+
+TaskErrorSink AdvancedThread::GetTaskErrorSink()
+{
+    std::unique_lock<std::mutex> Lock(ErrorSinkMutex);
+    return ErrorSink;
+}
+
+void AdvancedThread::RecordTaskException()
+{
+    Counters.RecordException();
+
+    if (NumOfTaskExceptionsRef != nullptr)
+    {
+        NumOfTaskExceptionsRef->fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 bool AdvancedThread::GetThreadCompletedTick()
@@ -248,6 +602,54 @@ void AdvancedThread::NotifyTickTaskAvailable()
     WakeUp();
 }
 
+void AdvancedThread::Park()
+{
+    MustParkMutex.lock();
+    bMustPark = true;
+    MustParkMutex.unlock();
+
+    Sleep();
+}
+
+void AdvancedThread::Unpark()
+{
+    MustParkMutex.lock();
+    bMustPark = false;
+    MustParkMutex.unlock();
+
+    WakeUp();
+}
+
+bool AdvancedThread::IsParked()
+{
+    std::lock_guard<std::mutex> Lock(MustParkMutex);
+    return bMustPark;
+}
+
+unsigned long long AdvancedThread::ConsumeBusyTime()
+{
+    return BusyTime.exchange(0, std::memory_order_relaxed);
+}
+
+WorkerStatistics AdvancedThread::GetStatistics()
+{
+    WorkerStatistics Statistics = Counters.GetStatistics(GetState());
+    Statistics.ScratchArenaHighWaterMark = ScratchArena.GetHighWaterMark();
+    Statistics.ScratchArenaCapacity = ScratchArena.GetCapacity();
+    return Statistics;
+}
+
+void AdvancedThread::ResetStatistics()
+{
+    Counters.Reset();
+    ScratchArena.ResetHighWaterMark();
+}
+
+unsigned long long AdvancedThread::GetTickCompletionTime()
+{
+    return TickCompletionTime.load(std::memory_order_relaxed);
+}
+
 
 
 void AdvancedThread::SetState(ThreadState NewState)
@@ -262,6 +664,12 @@ void AdvancedThread::SetIsDedicated(bool bNewState)
     bIsDedicatedThread = bNewState;
 }
 
+void AdvancedThread::SetIsPooledDedicated(bool bNewState)
+{
+    std::lock_guard<std::mutex> Lock(IsPooledDedicatedThreadMutex);
+    bIsPooledDedicatedThread = bNewState;
+}
+
 bool AdvancedThread::GetMustStop()
 {
     std::lock_guard<std::mutex> Lock(MustStopMutex);
@@ -278,6 +686,12 @@ bool AdvancedThread::GetMustSleep()
 void AdvancedThread::Execute() {
     SetState(ThreadState::Started);
 
+    CurrentThread = this;
+
+    TaskTracer::SetThreadName("Standard thread");
+
+    RunLifecycleHook(true);
+
     while (true)
     {
         if (GetMustStop())
@@ -289,7 +703,11 @@ void AdvancedThread::Execute() {
         {
             SetState(ThreadState::Asleep);
 
+            const unsigned long long SleepStart = GetStatisticsTime();
+            TaskTracer::Record(TraceEventType::SleepBegin, nullptr);
             SleepExecution();
+            TaskTracer::Record(TraceEventType::SleepEnd, nullptr);
+            Counters.RecordSleep(SleepStart, GetStatisticsTime());
 
             if (GetMustStop())
             {
@@ -299,6 +717,8 @@ void AdvancedThread::Execute() {
             SetState(ThreadState::Working);
         }
 
+        ResetScratchArenaOnNewFrame();
+
         std::queue<ThreadTask*> CopyOfTasks;
 
         // Execute tasks like Tick if they need to be executed
@@ -308,13 +728,18 @@ void AdvancedThread::Execute() {
             float DeltaTickCopy = *DeltaTickRef;
             DeltaTickMutexRef->unlock();
 
+            const ChunkingPolicy Chunking = GetChunkingPolicy();
+            const unsigned int NumOfRunningThreads = GetNumOfRunningThreads();
+            const unsigned int MaxTickTasksPerIteration = GetMaxTickTasksPerIteration();
+
             while (true)
             {
                 // Take part of the tasks, if they are available
                 TickTasksMutexRef->lock();
                 if (!TickTasksRef->empty())
                 {
-                    const unsigned int MaxTasksPerIteration = GetMaxTickTasksPerIteration();
+                    const unsigned int MaxTasksPerIteration = Chunking.GetNumOfTasksToTake(Chunking.TickChunking, 
+                        TickTasksRef->size(), NumOfRunningThreads, MaxTickTasksPerIteration, AverageTickTaskDuration);
                     
                     while (!TickTasksRef->empty())
                     {
@@ -328,12 +753,16 @@ void AdvancedThread::Execute() {
                     }
                     
                     TickTasksMutexRef->unlock();
+
+                    Counters.RecordSteal();
+                    TaskTracer::Record(TraceEventType::Steal, "Take Tick tasks");
                 }
                 else
                 {
                     TickTasksMutexRef->unlock();
 
                     // Otherwise, we mark that tasks of type Tick have been completed
+                    TickCompletionTime.store(GetStatisticsTime(), std::memory_order_relaxed);
                     SetThreadCompletedTick(true);
 
                     // And inform the manager that we have completed work on tasks of the Tick type
@@ -343,18 +772,50 @@ void AdvancedThread::Execute() {
                 }
 
                 // Execute assigned tasks
+                const size_t NumOfTakenTasks = CopyOfTasks.size();
+                size_t NumOfExecutedTasks = 0;
+                const std::chrono::steady_clock::time_point ExecutionStart = std::chrono::steady_clock::now();
+                const bool bTraceTasks = TaskTracer::IsEnabled();
+                // The end of a timed task is the start of the next one, so the clock is read at most once per task
+                unsigned long long TaskStart = std::chrono::duration_cast<std::chrono::nanoseconds>(ExecutionStart.time_since_epoch()).count();
+                // Cancelled Tick tasks were already left out by the manager when it queued them
                 while (!CopyOfTasks.empty())
                 {
-                    try
+                    const bool bTimeTask = bTraceTasks || Counters.ShouldSampleTask();
+                    if (bTimeTask && TaskStart == 0)
+                    {
+                        TaskStart = TaskTracer::GetTraceTime();
+                    }
+                    if (bTraceTasks)
                     {
-                        CopyOfTasks.front()->Execute(DeltaTickCopy);
+                        const char* TaskName = CopyOfTasks.front()->GetName();
+                        TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : "Tick task", TaskStart);
                     }
-                    catch (const std::exception& exc)
+
+                    const unsigned long long TaskEnqueueTime = bTimeTask ? CopyOfTasks.front()->GetEnqueueTime() : 0;
+                    // Tasks executed less often than every Tick receive the time since their previous execution
+                    if (!ExecuteTask(CopyOfTasks.front(), CopyOfTasks.front()->GetTickDeltaTime(DeltaTickCopy)))
+                    {
+                        RecordTaskException();
+                    }
+                    NumOfExecutedTasks++;
+
+                    if (bTimeTask)
+                    {
+                        const unsigned long long TaskEnd = TaskTracer::GetTraceTime();
+                        TaskTracer::Record(TraceEventType::TaskEnd, nullptr, TaskEnd);
+                        Counters.RecordTaskLatency(TaskEnqueueTime, TaskStart, TaskEnd);
+                        TaskStart = TaskEnd;
+                    }
+                    else
                     {
-                        Stop();
+                        TaskStart = 0;
                     }
                     CopyOfTasks.pop();
                 }
+                const unsigned long long ExecutionTime = AddBusyTime(ExecutionStart);
+                Counters.RecordTasks(NumOfExecutedTasks, ExecutionTime);
+                UpdateAverageTaskDuration(AverageTickTaskDuration, ExecutionTime, NumOfTakenTasks);
             }
         }
 
@@ -367,18 +828,22 @@ void AdvancedThread::Execute() {
 
 
         // Execute a portion of tasks of the Once type, if available
-        if (GetNeedToCompleteOnceTasks())
+        if (!IsParked() && GetNeedToCompleteOnceTasks())
         {
+            const ChunkingPolicy Chunking = GetChunkingPolicy();
+            const unsigned int NumOfRunningThreads = GetNumOfRunningThreads();
+            const unsigned int MaxOnceTasksPerIteration = GetMaxOnceTasksPerIteration();
+
             OnceTasksMutexRef->lock();
-            if (!OnceTasksRef->empty())
+            if (!OnceTasksRef->IsEmpty())
             {
-                const unsigned int MaxTasksPerIteration = GetMaxOnceTasksPerIteration();
+                const unsigned int MaxTasksPerIteration = Chunking.GetNumOfTasksToTake(Chunking.OnceChunking, 
+                    OnceTasksRef->Size(), NumOfRunningThreads, MaxOnceTasksPerIteration, AverageOnceTaskDuration);
 
                 // Take part of the tasks, if they are available
-                while (!OnceTasksRef->empty())
+                while (!OnceTasksRef->IsEmpty())
                 {
-                    CopyOfTasks.push(OnceTasksRef->front());
-                    OnceTasksRef->pop();
+                    CopyOfTasks.push(OnceTasksRef->Pop());
 
                     if (CopyOfTasks.size() >= MaxTasksPerIteration)
                     {
@@ -388,19 +853,68 @@ void AdvancedThread::Execute() {
 
                 OnceTasksMutexRef->unlock();
 
+                // Producers may be waiting for space in a bounded queue
+                OnceTasksSpaceConditionRef->notify_all();
+
+                Counters.RecordSteal();
+                TaskTracer::Record(TraceEventType::Steal, "Take Once tasks");
+
                 // Execute assigned tasks
+                const size_t NumOfTakenTasks = CopyOfTasks.size();
+                size_t NumOfExecutedTasks = 0;
+                const std::chrono::steady_clock::time_point ExecutionStart = std::chrono::steady_clock::now();
+                const bool bTraceTasks = TaskTracer::IsEnabled();
+                // The end of a timed task is the start of the next one, so the clock is read at most once per task
+                unsigned long long TaskStart = std::chrono::duration_cast<std::chrono::nanoseconds>(ExecutionStart.time_since_epoch()).count();
                 while (!CopyOfTasks.empty())
                 {
-                    try
+                    // Cancelled tasks are deleted without execution
+                    if (CopyOfTasks.front()->IsCancelled())
                     {
-                        CopyOfTasks.front()->Execute(0);
+                        Counters.RecordCancelledTask();
+                        delete CopyOfTasks.front();
+                        CopyOfTasks.pop();
+                        TaskStart = 0;
+                        continue;
                     }
-                    catch (const std::exception& exc)
+
+                    const bool bTimeTask = bTraceTasks || Counters.ShouldSampleTask();
+                    if (bTimeTask && TaskStart == 0)
                     {
-                        Stop();
+                        TaskStart = TaskTracer::GetTraceTime();
                     }
+                    if (bTraceTasks)
+                    {
+                        const char* TaskName = CopyOfTasks.front()->GetName();
+                        TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : "Once task", TaskStart);
+                    }
+
+                    const unsigned long long TaskEnqueueTime = bTimeTask ? CopyOfTasks.front()->GetEnqueueTime() : 0;
+                    if (!ExecuteTask(CopyOfTasks.front(), 0))
+                    {
+                        RecordTaskException();
+                    }
+                    NumOfExecutedTasks++;
+
+                    if (bTimeTask)
+                    {
+                        const unsigned long long TaskEnd = TaskTracer::GetTraceTime();
+                        TaskTracer::Record(TraceEventType::TaskEnd, nullptr, TaskEnd);
+                        Counters.RecordTaskLatency(TaskEnqueueTime, TaskStart, TaskEnd);
+                        TaskStart = TaskEnd;
+                    }
+                    else
+                    {
+                        TaskStart = 0;
+                    }
+
+                    // Once tasks belong to the thread after they are taken from the queue
+                    delete CopyOfTasks.front();
                     CopyOfTasks.pop();
                 }
+                const unsigned long long ExecutionTime = AddBusyTime(ExecutionStart);
+                Counters.RecordTasks(NumOfExecutedTasks, ExecutionTime);
+                UpdateAverageTaskDuration(AverageOnceTaskDuration, ExecutionTime, NumOfTakenTasks);
             }
             else
             {
@@ -416,6 +930,17 @@ void AdvancedThread::Execute() {
         }
     }
 
+    // A thread stopped after it was notified of Tick tasks leaves them to the other threads,
+    // but the manager is still waiting for it to report the completion of the Tick
+    if (!GetThreadCompletedTick())
+    {
+        TickCompletionTime.store(GetStatisticsTime(), std::memory_order_relaxed);
+        SetThreadCompletedTick(true);
+        NotifyManagerThreadCompletedTickTasks();
+    }
+
+    RunLifecycleHook(false);
+
     SetState(ThreadState::Stopped);
 }
 
@@ -423,21 +948,95 @@ void AdvancedThread::ExecuteDedicated()
 {
     SetState(ThreadState::Started);
 
-    // We do not use a mutex because otherwise we will not be able to tell the executor that it is necessary to stop the execution
-    // We also cannot change the task in any way, since there is protection against changes at runtime
-    // Security within an executable function must be guaranteed by the user
-    try
+    TaskTracer::SetThreadName("Dedicated thread");
+
+    CurrentThread = this;
+
+    RunLifecycleHook(true);
+
+    if (!IsPooledDedicated())
     {
-        TaskForDedicatedExecution->Execute(0);
+        const char* TaskName = TaskForDedicatedExecution->GetName();
+        TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : "Dedicated task");
+
+        // We do not use a mutex because otherwise we will not be able to tell the executor that it is necessary to stop the execution
+        // We also cannot change the task in any way, since there is protection against changes at runtime
+        // Security within an executable function must be guaranteed by the user
+        if (!TaskForDedicatedExecution->IsCancelled())
+        {
+            if (!ExecuteTask(TaskForDedicatedExecution, 0))
+            {
+                RecordTaskException();
+            }
+        }
+        TaskTracer::Record(TraceEventType::TaskEnd, nullptr);
+
+        RunLifecycleHook(false);
+
+        SetState(ThreadState::Stopped);
+        return;
     }
-    catch (const std::exception& exc)
+
+    // Pooled dedicated thread: execute the assigned tasks one by one, keeping the system thread alive between them
+    while (true)
     {
-        Stop();
+        SetState(ThreadState::Awaiting);
+
+        if (!AwaitDedicatedTask())
+        {
+            break;
+        }
+
+        SetState(ThreadState::Working);
+
+        TaskForDedicatedExecutionMutex.lock();
+        ThreadTask* Task = TaskForDedicatedExecution;
+        TaskForDedicatedExecutionMutex.unlock();
+
+        // The task is only replaced by this thread, so it can be executed without holding the mutex
+        // A task cancelled before the thread took it is only deleted
+        if (!Task->IsCancelled())
+        {
+            const char* TaskName = Task->GetName();
+            TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : "Dedicated task");
+            if (!ExecuteTask(Task, 0))
+            {
+                RecordTaskException();
+            }
+            TaskTracer::Record(TraceEventType::TaskEnd, nullptr);
+        }
+        ScratchArena.Reset();
+
+        TaskForDedicatedExecutionMutex.lock();
+        delete TaskForDedicatedExecution;
+        TaskForDedicatedExecution = nullptr;
+        TaskForDedicatedExecutionMutex.unlock();
     }
 
+    RunLifecycleHook(false);
+
     SetState(ThreadState::Stopped);
 }
 
+bool AdvancedThread::AwaitDedicatedTask()
+{
+    std::unique_lock<std::mutex> LockTask(TaskForDedicatedExecutionMutex);
+
+    while (TaskForDedicatedExecution == nullptr)
+    {
+        if (GetMustStop())
+        {
+            return false;
+        }
+
+        // Assignment and Stop change the state under the task mutex, so no notification is lost and no timeout is needed
+        DedicatedTaskAssignedCondition.wait(LockTask);
+    }
+
+    // If the thread was stopped together with the assignment, the task has already received its stop signal
+    return true;
+}
+
 
 void AdvancedThread::Deinitialize()
 {
@@ -454,6 +1053,12 @@ void AdvancedThread::Deinitialize()
     bMustSleep = false;
     MustSleepMutex.unlock();
 
+    MustParkMutex.lock();
+    bMustPark = false;
+    MustParkMutex.unlock();
+
+    BusyTime.store(0, std::memory_order_relaxed);
+
     if (IsDedicated())
     {
         TaskForDedicatedExecutionMutex.lock();
@@ -462,6 +1067,7 @@ void AdvancedThread::Deinitialize()
         TaskForDedicatedExecutionMutex.unlock();
 
         SetIsDedicated(false);
+        SetIsPooledDedicated(false);
     }
     else
     {
@@ -469,6 +1075,7 @@ void AdvancedThread::Deinitialize()
 
         OnceTasksRef = nullptr;
         OnceTasksMutexRef = nullptr;
+        OnceTasksSpaceConditionRef = nullptr;
 
         TickTasksRef = nullptr;
         TickTasksMutexRef = nullptr;
@@ -479,8 +1086,13 @@ void AdvancedThread::Deinitialize()
 
         DeltaTickRef = nullptr;
         DeltaTickMutexRef = nullptr;
+
+        BlockingCallback = nullptr;
     }
 
+    LifecycleHooksRef = nullptr;
+    LifecycleHooksMutexRef = nullptr;
+
     SetState(ThreadState::NotReadyToStart);
 }
 
@@ -502,12 +1114,39 @@ void AdvancedThread::SetThreadCompletedTick(bool bNewState)
     bThreadCompletedTick = bNewState;
 }
 
+unsigned long long AdvancedThread::AddBusyTime(std::chrono::steady_clock::time_point ExecutionStart)
+{
+    const std::chrono::nanoseconds Elapsed = std::chrono::steady_clock::now() - ExecutionStart;
+    BusyTime.fetch_add(static_cast<unsigned long long>(Elapsed.count()), std::memory_order_relaxed);
+    return static_cast<unsigned long long>(Elapsed.count());
+}
+
+void AdvancedThread::UpdateAverageTaskDuration(float& AverageTaskDuration, unsigned long long ExecutionTime, size_t NumOfTasks)
+{
+    if (NumOfTasks == 0)
+    {
+        return;
+    }
+
+    const float TaskDuration = static_cast<float>(ExecutionTime) / NumOfTasks;
+
+    // The first measurement is taken as is, later ones are smoothed so that a single slow portion does not shrink the chunks
+    if (AverageTaskDuration <= 0.0f)
+    {
+        AverageTaskDuration = TaskDuration;
+    }
+    else
+    {
+        AverageTaskDuration += (TaskDuration - AverageTaskDuration) * 0.25f;
+    }
+}
+
 
 
 bool AdvancedThread::GetNeedToCompleteOnceTasks()
 {
     std::lock_guard<std::mutex> Lock(*OnceTasksMutexRef);
-    return !OnceTasksRef->empty();
+    return !OnceTasksRef->IsEmpty();
 }
 
 void AdvancedThread::NotifyManagerThreadCompletedTickTasks()
@@ -1,10 +1,23 @@
 #pragma once
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <queue>
 #include <vector>
+#include <functional>
+#include "OnceTaskQueue.h"
 #include "ThreadState.h"
 #include "ThreadTask.h"
+#include "WorkerCounters.h"
+#include "ChunkingPolicy.h"
+#include "LinearArena.h"
+#include "WorkerLifecycleHooks.h"
+#include "WorkerLocalStorage.h"
+#include "TaskTracer.h"
+
+// Called by a standard thread when a task starts (true) or stops (false) blocking
+typedef std::function<void(bool bBlocking)> ThreadBlockingCallback;
 
 class AdvancedThread final
 {
@@ -35,6 +48,11 @@ private:
 
 	ThreadTask* TaskForDedicatedExecution;
 	std::mutex TaskForDedicatedExecutionMutex;
+	std::condition_variable DedicatedTaskAssignedCondition;
+
+	// A pooled dedicated thread is not stopped after its task is completed, it waits for the next task instead
+	bool bIsPooledDedicatedThread;
+	std::mutex IsPooledDedicatedThreadMutex;
 
 
 	// Standard type
@@ -42,17 +60,61 @@ private:
 	bool bThreadCompletedTick;
 	std::mutex ThreadCompletedTickMutex;
 
-	static unsigned int MaxTickTasksPerIteration;
-	static std::mutex MaxTickTasksPerIterationMutex;
+	// A parked thread keeps its system thread asleep and does not take Once tasks until it is unparked
+	bool bMustPark;
+	std::mutex MustParkMutex;
+
+	// Time spent executing tasks in nanoseconds, since the last ConsumeBusyTime call
+	std::atomic<unsigned long long> BusyTime;
+
+	// Statistics counters, recorded only by the controlled thread
+	WorkerCounters Counters;
+
+	// Time when the thread completed its last Tick tasks, used for statistics
+	std::atomic<unsigned long long> TickCompletionTime;
+
+	// Moving averages of the task durations in nanoseconds for adaptive chunking, used only by the controlled thread
+	float AverageTickTaskDuration;
+	float AverageOnceTaskDuration;
+
+	// Depth of nested blocking sections of the current task, used only by the controlled thread
+	unsigned int BlockingDepth;
+
+	// Scratch memory of the tasks executed by the thread, used only by the controlled thread
+	LinearArena ScratchArena;
+	// Tick of the pool during which the scratch arena was last reset
+	unsigned long long ScratchArenaFrame;
+
+	// Values of the WorkerLocal variables, used only by the controlled thread
+	WorkerLocalStorage LocalStorage;
+	// Number of times the thread has been started, used only by the controlled thread
+	unsigned int NumOfStarts;
+
+	// The thread executing the code, nullptr outside of standard threads
+	static thread_local AdvancedThread* CurrentThread;
 
-	static unsigned int MaxOnceTasksPerIteration;
-	static std::mutex MaxOnceTasksPerIterationMutex;
+	static TaskErrorSink ErrorSink;
+	static std::mutex ErrorSinkMutex;
+
+
+	// All types: External Data
+
+	// Number of exceptions thrown by the tasks of the pool that owns the thread, may be nullptr
+	std::atomic<unsigned long long>* NumOfTaskExceptionsRef;
+
+	// Number of completed Ticks of the pool, the scratch arena is reset when it changes, may be nullptr
+	const std::atomic<unsigned long long>* FrameIndexRef;
+
+	// Lifecycle hooks of the pool that owns the thread, may be nullptr
+	const WorkerLifecycleHooks* LifecycleHooksRef;
+	std::mutex* LifecycleHooksMutexRef;
 
 
 	// Standard type: External Data
 
-	std::queue<ThreadTask*>* OnceTasksRef;
+	OnceTaskQueue* OnceTasksRef;
 	std::mutex* OnceTasksMutexRef;
+	std::condition_variable* OnceTasksSpaceConditionRef;
 
 	std::queue<ThreadTask*>* TickTasksRef;
 	std::mutex* TickTasksMutexRef;
@@ -64,6 +126,21 @@ private:
 	float* DeltaTickRef;
 	std::mutex* DeltaTickMutexRef;
 
+	unsigned int* MaxTickTasksPerIterationRef;
+	std::mutex* MaxTickTasksPerIterationMutexRef;
+
+	unsigned int* MaxOnceTasksPerIterationRef;
+	std::mutex* MaxOnceTasksPerIterationMutexRef;
+
+	ChunkingPolicy* ChunkingRef;
+	std::mutex* ChunkingMutexRef;
+
+	unsigned int* NumOfThreadsRef;
+	std::mutex* NumOfThreadsMutexRef;
+
+	// Set before the thread is started and only called by the controlled thread, so it has no mutex
+	ThreadBlockingCallback BlockingCallback;
+
 public:
 	AdvancedThread();
 	~AdvancedThread();
@@ -71,6 +148,7 @@ public:
 	// Initialize as standart thread
 	// @param OnceTasks - pointer to Once task list
 	// @param OnceTasksMutex - pointer to corresponding mutex
+	// @param OnceTasksSpaceCondition - pointer to a condition variable that will be notified when the thread takes Once tasks from the list
 	// @param TickTasks - pointer to Tick task list
 	// @param OnceTasksMutex - pointer to corresponding mutex
 	// @param ThreadCompletedTickTasks - pointer to a boolean variable that indicates that the thread has finished working on Tick tasks
@@ -78,14 +156,41 @@ public:
 	// @param ThreadCompletedTickTasksCondition - pointer to a condition variable that will be notified when the thread has finished working on Tick tasks
 	// @param DeltaTick - pointer to a variable that stores the actual execution time of the previous Tick
 	// @param DeltaTickMutex - pointer to corresponding mutex
+	// @param MaxTickTasksPerIteration - pointer to the maximum number of Tick tasks executed in one iteration
+	// @param MaxTickTasksPerIterationMutex - pointer to corresponding mutex
+	// @param MaxOnceTasksPerIteration - pointer to the maximum number of Once tasks executed in one iteration
+	// @param MaxOnceTasksPerIterationMutex - pointer to corresponding mutex
+	// @param Chunking - pointer to the policy by which the thread sizes the portions of tasks
+	// @param ChunkingMutex - pointer to corresponding mutex
+	// @param NumOfThreads - pointer to the number of running standard threads
+	// @param NumOfThreadsMutex - pointer to corresponding mutex
+	// @param NumOfTaskExceptions - pointer to the counter of exceptions thrown by tasks
+	// @param FrameIndex - pointer to the number of completed Ticks of the pool
+	// @param LifecycleHooks - pointer to the hooks called when the thread starts and stops
+	// @param LifecycleHooksMutex - pointer to corresponding mutex
+	// @param NewBlockingCallback - function that lets the pool compensate for the thread while its task blocks, may be empty
 	void Initialize(
-		std::queue<ThreadTask*>* OnceTasks, std::mutex* OnceTasksMutex,
+		OnceTaskQueue* OnceTasks, std::mutex* OnceTasksMutex, std::condition_variable* OnceTasksSpaceCondition,
 		std::queue<ThreadTask*>* TickTasks, std::mutex* TickTasksMutex,
 		bool* bThreadCompletedTickTasks, std::mutex* ThreadCompletedTickTasksMutex, std::condition_variable* ThreadCompletedTickTasksCondition,
-		float* DeltaTick, std::mutex* DeltaTickMutex);
+		float* DeltaTick, std::mutex* DeltaTickMutex,
+		unsigned int* MaxTickTasksPerIteration, std::mutex* MaxTickTasksPerIterationMutex,
+		unsigned int* MaxOnceTasksPerIteration, std::mutex* MaxOnceTasksPerIterationMutex,
+		ChunkingPolicy* Chunking, std::mutex* ChunkingMutex,
+		unsigned int* NumOfThreads, std::mutex* NumOfThreadsMutex,
+		std::atomic<unsigned long long>* NumOfTaskExceptions,
+		const std::atomic<unsigned long long>* FrameIndex,
+		const WorkerLifecycleHooks* LifecycleHooks, std::mutex* LifecycleHooksMutex,
+		const ThreadBlockingCallback& NewBlockingCallback);
 	// Initialize as dedicated thread
 	// @param Task - pointer to a task for dedicated execution
 	void Initialize(ThreadTask* Task);
+	// Initialize as pooled dedicated thread
+	// The thread executes the tasks assigned by AssignDedicatedTask one by one until it is stopped
+	// @param NumOfTaskExceptions - pointer to the counter of exceptions thrown by tasks
+	// @param LifecycleHooks - pointer to the hooks called when the thread starts and stops
+	// @param LifecycleHooksMutex - pointer to corresponding mutex
+	void InitializeDedicatedPool(std::atomic<unsigned long long>* NumOfTaskExceptions, const WorkerLifecycleHooks* LifecycleHooks, std::mutex* LifecycleHooksMutex);
 
 
 	// All types
@@ -95,6 +200,8 @@ public:
 
 	// Returns true if the thread is running as dedicated
 	bool IsDedicated();
+	// Returns true if the thread is running as pooled dedicated
+	bool IsPooledDedicated();
 
 	// Runs a new thread
 	void Start();
@@ -114,6 +221,17 @@ public:
 	bool GetCanBeDestroyed();
 
 
+	// Dedicated type
+
+	// Gives the task to a pooled dedicated thread that is waiting for a new task
+	// On success, the thread takes ownership of the task and deletes it after execution
+	// @param Task - pointer to a task for dedicated execution
+	// @return false if the thread is not pooled, is busy or is stopping
+	bool AssignDedicatedTask(ThreadTask* Task);
+	// Returns true if the thread is pooled dedicated, started and has no task to execute
+	bool IsAwaitingDedicatedTask();
+
+
 	// Standard type
 
 	// Returns true if the thread completed Tick tasks
@@ -121,18 +239,59 @@ public:
 	// Notifies the thread that there are available Tick tasks
 	void NotifyTickTaskAvailable();
 
-	// Sets the maximum number of Tick tasks to be executed in one iteration
-	// @param NewMax - Updated limit
-	static void SetMaxTickTasksPerIteration(unsigned int NewMax);
-	// Returns the maximum number of Tick tasks that the thread executes in one iteration
-	static unsigned int GetMaxTickTasksPerIteration();
-
+	// Tells the thread to finish its current work and sleep without taking new Once tasks
+	// Tick tasks already assigned to the thread are still completed
+	void Park();
+	// Wakes up a parked thread so that it can take tasks again
+	void Unpark();
+	// Returns true if the thread is parked
+	bool IsParked();
+
+	// Returns the time spent executing tasks in nanoseconds since the previous call and resets it
+	unsigned long long ConsumeBusyTime();
+
+	// Returns the statistics of the thread
+	WorkerStatistics GetStatistics();
+	// Clears the statistics of the thread
+	void ResetStatistics();
+
+	// Returns the time when the thread completed its last Tick tasks, in nanoseconds from GetStatisticsTime
+	unsigned long long GetTickCompletionTime();
+
+	// Executes the task, an exception thrown by it is passed to the task handles and to the error sink instead of stopping the thread
+	// @param Task - the task to execute
+	// @param DeltaTime - passed to the task
+	// @return false if the task threw an exception
+	static bool ExecuteTask(ThreadTask* Task, const float& DeltaTime);
+
+	// Sets the function that receives every exception thrown by a task
+	// @param NewSink - the function, an empty function disables the sink
+	static void SetTaskErrorSink(const TaskErrorSink& NewSink);
+	// Returns the function that receives every exception thrown by a task
+	static TaskErrorSink GetTaskErrorSink();
+
+	// Tells the pool of the current standard thread that its task is going to block
+	// Nested calls are counted, only the outermost one is reported to the pool
+	// @return false if the code is not executed by a standard thread, then EndBlocking must not be called
+	static bool BeginBlocking();
+	// Tells the pool of the current standard thread that its task no longer blocks
+	static void EndBlocking();
+
+	// Returns the scratch arena of the current thread for temporary allocations of a task
+	// On a standard thread the memory is valid until the end of the current Tick, on a dedicated thread - until the task returns
+	// Other threads get an arena of their own that is reset at the end of every Tick they call
+	static LinearArena& GetScratchArena();
+	// Resets the arena of the calling thread if it is not a standard or dedicated thread, those threads reset their arenas themselves
+	static void ResetCallerScratchArena();
+
+	// Returns true if the code is executed by a standard thread that takes tasks from the queue
+	// @param OnceTasks - Once task queue of a pool
+	static bool IsServingQueue(const OnceTaskQueue* OnceTasks);
+
+	// Returns the values of the WorkerLocal variables of the current thread
+	// Other threads get a storage of their own, destroyed when the thread exits
+	static WorkerLocalStorage& GetWorkerLocalStorage();
 
-	// Sets the maximum number of Once tasks to be executed in one iteration
-	// @param NewMax - Updated limit
-	static void SetMaxOnceTasksPerIteration(unsigned int NewMax);
-	// Returns the maximum number of Once tasks that the thread executes in one iteration
-	static unsigned int GetMaxOnceTasksPerIteration();
 
 private:
 	// All types
@@ -141,6 +300,9 @@ private:
 
 	void SetIsDedicated(bool bNewState);
 
+	// Counts an exception thrown by a task of this thread
+	void RecordTaskException();
+
 	bool GetMustStop();
 	bool GetMustSleep();
 
@@ -157,9 +319,36 @@ private:
 
 	void SetThreadCompletedTick(bool bNewState);
 
+	// Adds the time since the start of execution to the busy time
+	// @return the added time in nanoseconds
+	unsigned long long AddBusyTime(std::chrono::steady_clock::time_point ExecutionStart);
+
+	// Adds the average duration of the tasks of a portion to a moving average
+	// @param AverageTaskDuration - the moving average to update
+	// @param ExecutionTime - time spent executing the portion in nanoseconds
+	// @param NumOfTasks - number of tasks in the portion
+	static void UpdateAverageTaskDuration(float& AverageTaskDuration, unsigned long long ExecutionTime, size_t NumOfTasks);
+
+	// Resets the scratch arena if a Tick has completed since the last reset
+	// Called only between tasks, so the memory of a running task is never reset
+	void ResetScratchArenaOnNewFrame();
+
+	// Runs the lifecycle hook of the pool on the controlled thread, the values of WorkerLocal variables are destroyed after the stop hook
+	// @param bStart - true to run OnWorkerStart, false to run OnWorkerStop
+	void RunLifecycleHook(bool bStart);
+
 	// Works with an external object
 	bool GetNeedToCompleteOnceTasks();
 
+	// Works with an external object
+	unsigned int GetMaxTickTasksPerIteration();
+	// Works with an external object
+	unsigned int GetMaxOnceTasksPerIteration();
+	// Works with an external object
+	ChunkingPolicy GetChunkingPolicy();
+	// Works with an external object
+	unsigned int GetNumOfRunningThreads();
+
 	// Works with an external object
 	void NotifyManagerThreadCompletedTickTasks();
 
@@ -167,5 +356,11 @@ private:
 	// Dedicated type
 
 	void ExecuteDedicated();
+
+	void SetIsPooledDedicated(bool bNewState);
+
+	// Suspends execution of the pooled dedicated thread until a task is assigned or the thread must stop
+	// @return false if the thread must stop
+	bool AwaitDedicatedTask();
 };
 
@@ -0,0 +1 @@
+#include "ArenaAllocator.h"
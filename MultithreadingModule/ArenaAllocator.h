@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include "LinearArena.h"
+
+// Allocator for standard containers that takes memory from a linear arena
+// Deallocation does nothing, the memory is returned when the arena is reset, so the container must not be used after that
+template<typename T>
+class ArenaAllocator
+{
+	template<typename U>
+	friend class ArenaAllocator;
+
+private:
+	LinearArena* Arena;
+
+public:
+	typedef T value_type;
+
+	ArenaAllocator() = delete;
+	// @param NewArena - the arena, it must outlive the container
+	ArenaAllocator(LinearArena& NewArena) : Arena(&NewArena) {}
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& Other) : Arena(Other.Arena) {}
+
+	T* allocate(size_t Count)
+	{
+		T* Memory = Arena->AllocateArray<T>(Count);
+		if (Memory == nullptr && Count != 0)
+		{
+			throw std::bad_alloc();
+		}
+		return Memory;
+	}
+
+	void deallocate(T*, size_t) {}
+
+	template<typename U>
+	bool operator==(const ArenaAllocator<U>& Other) const
+	{
+		return Arena == Other.Arena;
+	}
+	template<typename U>
+	bool operator!=(const ArenaAllocator<U>& Other) const
+	{
+		return Arena != Other.Arena;
+	}
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+// Describes how the Threads Manager changes the number of running standard threads depending on the load
+// The number of threads is kept between MinNumOfThreads and the maximum number of standard threads
+struct AutoscalerPolicy
+{
+	// The autoscaler does nothing while disabled
+	bool bEnabled;
+
+	// Lower limit of running standard threads
+	unsigned int MinNumOfThreads;
+
+	// The load is considered high if there are more queued Once tasks per running thread than this
+	unsigned int GrowQueueDepthPerThread;
+	// The load is considered high if the share of time the threads spend executing tasks is above this (0 - 1)
+	float GrowUtilization;
+	// The load is considered low if the share of time the threads spend executing tasks is below this (0 - 1)
+	// and the Once queue is empty
+	float ShrinkUtilization;
+	// The load is considered high if Tick takes longer than this, in seconds (0 - Tick duration is not considered)
+	float TickDurationBudget;
+
+	// Number of consecutive high load samples required to start a thread
+	unsigned int NumOfSamplesToGrow;
+	// Number of consecutive low load samples required to park a thread
+	unsigned int NumOfSamplesToShrink;
+
+	// Minimum time after any change before starting a thread, in milliseconds
+	unsigned int GrowCooldown;
+	// Minimum time after any change before parking a thread, in milliseconds
+	unsigned int ShrinkCooldown;
+
+	// Time between load samples, in milliseconds
+	unsigned int SampleInterval;
+
+	AutoscalerPolicy() :
+		bEnabled(false),
+		MinNumOfThreads(1),
+		GrowQueueDepthPerThread(8), GrowUtilization(0.85f), ShrinkUtilization(0.3f), TickDurationBudget(0.0f),
+		NumOfSamplesToGrow(2), NumOfSamplesToShrink(10),
+		GrowCooldown(200), ShrinkCooldown(2000),
+		SampleInterval(100) {}
+};
@@ -0,0 +1,12 @@
+#include "BlockingScope.h"
+#include "AdvancedThread.h"
+
+BlockingScope::BlockingScope() : bBlocking(AdvancedThread::BeginBlocking()) {}
+
+BlockingScope::~BlockingScope()
+{
+	if (bBlocking)
+	{
+		AdvancedThread::EndBlocking();
+	}
+}
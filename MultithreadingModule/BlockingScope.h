@@ -0,0 +1,18 @@
+#pragma once
+
+// Marks a blocking section of a task, such as waiting for I/O or a lock, for the lifetime of the object
+// While the section lasts, the pool of the standard thread runs a compensating thread,
+// so the number of threads executing tasks stays at the configured level
+// Has no effect outside of standard threads
+class BlockingScope
+{
+private:
+	bool bBlocking;
+
+public:
+	BlockingScope();
+	~BlockingScope();
+
+	BlockingScope(const BlockingScope&) = delete;
+	BlockingScope& operator=(const BlockingScope&) = delete;
+};
@@ -0,0 +1,124 @@
+#include "CallbackQueue.h"
+#include "AdvancedThread.h"
+
+CallbackQueue::CallbackQueue() : Head(nullptr), TakenHead(nullptr), TakenTail(nullptr)
+{
+}
+
+CallbackQueue::~CallbackQueue()
+{
+	std::lock_guard<std::mutex> Lock(TakenMutex);
+	TakePostedLocked();
+
+	while (TakenHead != nullptr)
+	{
+		DeferredCallback* Next = TakenHead->Next;
+		delete TakenHead;
+		TakenHead = Next;
+	}
+	TakenTail = nullptr;
+}
+
+void CallbackQueue::Push(const std::function<void()>& Callback)
+{
+	DeferredCallback* Posted = new DeferredCallback();
+	Posted->Callback = Callback;
+
+	DeferredCallback* OldHead = Head.load(std::memory_order_relaxed);
+	do
+	{
+		Posted->Next = OldHead;
+	} while (!Head.compare_exchange_weak(OldHead, Posted, std::memory_order_release, std::memory_order_relaxed));
+}
+
+unsigned int CallbackQueue::Dispatch(unsigned int MaxNumOfCallbacks)
+{
+	std::unique_lock<std::mutex> Lock(TakenMutex);
+	TakePostedLocked();
+
+	// Callbacks posted by the dispatched ones are taken by the next call, so the call always ends
+	DeferredCallback* const LastTaken = TakenTail;
+
+	unsigned int NumOfDispatched = 0;
+	while (TakenHead != nullptr && (MaxNumOfCallbacks == 0 || NumOfDispatched < MaxNumOfCallbacks))
+	{
+		DeferredCallback* Dispatched = TakenHead;
+		TakenHead = Dispatched->Next;
+		if (TakenHead == nullptr)
+		{
+			TakenTail = nullptr;
+		}
+
+		// The callback may post or dispatch callbacks itself
+		Lock.unlock();
+		try
+		{
+			if (Dispatched->Callback)
+			{
+				Dispatched->Callback();
+			}
+		}
+		catch (...)
+		{
+			const TaskErrorSink Sink = AdvancedThread::GetTaskErrorSink();
+			if (Sink)
+			{
+				try
+				{
+					Sink(nullptr, std::current_exception());
+				}
+				catch (...)
+				{
+				}
+			}
+		}
+		Lock.lock();
+
+		NumOfDispatched++;
+		const bool bLast = Dispatched == LastTaken;
+		delete Dispatched;
+		if (bLast)
+		{
+			break;
+		}
+	}
+
+	return NumOfDispatched;
+}
+
+bool CallbackQueue::IsEmpty()
+{
+	std::lock_guard<std::mutex> Lock(TakenMutex);
+	return TakenHead == nullptr && Head.load(std::memory_order_relaxed) == nullptr;
+}
+
+void CallbackQueue::TakePostedLocked()
+{
+	DeferredCallback* Posted = Head.exchange(nullptr, std::memory_order_acquire);
+
+	// The stack holds the newest callback first, reverse it so that callbacks are dispatched in the order they were posted
+	DeferredCallback* Reversed = nullptr;
+	DeferredCallback* ReversedTail = Posted;
+	while (Posted != nullptr)
+	{
+		DeferredCallback* Next = Posted->Next;
+		Posted->Next = Reversed;
+		Reversed = Posted;
+		Posted = Next;
+	}
+
+	if (Reversed == nullptr)
+	{
+		return;
+	}
+
+	if (TakenTail != nullptr)
+	{
+		TakenTail->Next = Reversed;
+	}
+	else
+	{
+		TakenHead = Reversed;
+	}
+	TakenTail = ReversedTail;
+}
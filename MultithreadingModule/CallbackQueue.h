@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+// A callback posted for deferred execution
+struct DeferredCallback
+{
+	std::function<void()> Callback;
+
+	DeferredCallback* Next;
+
+	DeferredCallback() : Next(nullptr) {}
+};
+
+// Queue of callbacks posted by any thread and executed in batches by the thread that dispatches them
+// Posting is lock-free, so threads never wait for the dispatching thread
+class CallbackQueue final
+{
+private:
+	// Stack of posted callbacks, the newest callback is on top
+	std::atomic<DeferredCallback*> Head;
+
+	// Callbacks taken from the stack in the order they were posted, but not dispatched yet
+	DeferredCallback* TakenHead;
+	DeferredCallback* TakenTail;
+	std::mutex TakenMutex;
+
+public:
+	CallbackQueue();
+	// Deletes the callbacks that were not dispatched
+	~CallbackQueue();
+
+	CallbackQueue(const CallbackQueue&) = delete;
+	CallbackQueue& operator=(const CallbackQueue&) = delete;
+
+	// Posts a callback, can be called from any thread
+	// @param Callback - the callback
+	void Push(const std::function<void()>& Callback);
+
+	// Executes the posted callbacks in the order they were posted on the calling thread
+	// Callbacks posted during the call are left for the next one
+	// An exception thrown by a callback is passed to the task error sink with a null task
+	// @param MaxNumOfCallbacks - maximum number of callbacks to execute, 0 - all
+	// @return number of executed callbacks
+	unsigned int Dispatch(unsigned int MaxNumOfCallbacks);
+
+	// Returns true if there are no callbacks to dispatch
+	bool IsEmpty();
+
+private:
+	// Moves the posted callbacks to the end of the taken ones, must be called under TakenMutex
+	void TakePostedLocked();
+};
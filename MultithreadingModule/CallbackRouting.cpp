@@ -0,0 +1 @@
+#include "CallbackRouting.h"
@@ -0,0 +1,10 @@
+#pragma once
+
+// Where the callback of a task is executed
+enum class CallbackRouting
+{
+	// On the thread that executed the task, right after it
+	Inline,
+	// On the thread that dispatches the callbacks of the pool, see MultithreadingModule::DispatchCallbacks
+	Deferred
+};
@@ -0,0 +1,15 @@
+#include "CancellationToken.h"
+
+CancellationToken::CancellationToken() : bCancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void CancellationToken::Cancel()
+{
+	bCancelled->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationToken::IsCancelled() const
+{
+	return bCancelled->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+// Cancels a group of tasks at once
+// Copies of the token share the cancellation state, so cancelling any copy cancels all tasks that received the token
+// Cancellation only marks the tasks, threads skip them without execution when they take them from the queue
+class CancellationToken
+{
+private:
+	std::shared_ptr<std::atomic<bool>> bCancelled;
+
+	// Creates a token without a state, tasks keep it until they receive a real one
+	explicit CancellationToken(std::nullptr_t) {}
+
+	friend class ThreadTask;
+
+public:
+	// Creates a new token that is not cancelled
+	CancellationToken();
+
+	// Cancels all tasks that received the token and have not started yet
+	void Cancel();
+	// Returns true if the token is cancelled
+	bool IsCancelled() const;
+};
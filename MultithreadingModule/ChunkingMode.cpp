@@ -0,0 +1 @@
+#include "ChunkingMode.h"
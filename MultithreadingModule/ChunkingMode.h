@@ -0,0 +1,12 @@
+#pragma once
+
+// How many tasks a thread takes from a shared queue at once
+enum class ChunkingMode
+{
+	// Always the maximum number of tasks per iteration
+	Fixed,
+	// A share of the remaining tasks, so chunks are large at the start and shrink toward the end of the queue
+	Guided,
+	// Guided, additionally limited so that a chunk takes about the target time, by the measured task cost
+	Adaptive
+};
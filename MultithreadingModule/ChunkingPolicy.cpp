@@ -0,0 +1,44 @@
+#include "ChunkingPolicy.h"
+
+unsigned int ChunkingPolicy::GetNumOfTasksToTake(ChunkingMode Mode, size_t NumOfQueuedTasks, unsigned int NumOfThreads,
+	unsigned int MaxTasksPerIteration, float AverageTaskDuration) const
+{
+	if (MaxTasksPerIteration == 0)
+	{
+		MaxTasksPerIteration = 1;
+	}
+
+	if (Mode == ChunkingMode::Fixed)
+	{
+		return MaxTasksPerIteration;
+	}
+
+	// Guided: a share of the remaining tasks, rounded up
+	const size_t NumOfChunks = static_cast<size_t>(NumOfThreads != 0 ? NumOfThreads : 1) * (ChunksPerThread != 0 ? ChunksPerThread : 1);
+	size_t NumOfTasks = (NumOfQueuedTasks + NumOfChunks - 1) / NumOfChunks;
+
+	// Adaptive: expensive tasks are taken in smaller chunks, so that no thread is left with a long tail
+	if (Mode == ChunkingMode::Adaptive && AverageTaskDuration > 0.0f)
+	{
+		const size_t NumOfTasksForTarget = static_cast<size_t>(TargetIterationDuration * 1000.0f / AverageTaskDuration);
+		if (NumOfTasksForTarget < NumOfTasks)
+		{
+			NumOfTasks = NumOfTasksForTarget;
+		}
+	}
+
+	if (NumOfTasks < MinTasksPerIteration)
+	{
+		NumOfTasks = MinTasksPerIteration;
+	}
+	if (NumOfTasks > MaxTasksPerIteration)
+	{
+		NumOfTasks = MaxTasksPerIteration;
+	}
+	if (NumOfTasks == 0)
+	{
+		NumOfTasks = 1;
+	}
+
+	return static_cast<unsigned int>(NumOfTasks);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include "ChunkingMode.h"
+
+// Describes how threads size the portions of Tick and Once tasks they take from the queues
+// The maximum number of tasks per iteration of the pool is the upper limit in all modes
+struct ChunkingPolicy
+{
+	ChunkingMode TickChunking;
+	ChunkingMode OnceChunking;
+
+	// Lower limit of a chunk in the Guided and Adaptive modes
+	unsigned int MinTasksPerIteration;
+	// Number of chunks per running thread that the remaining tasks are divided into in the Guided and Adaptive modes
+	unsigned int ChunksPerThread;
+	// Time that one chunk should take in the Adaptive mode, in microseconds
+	unsigned int TargetIterationDuration;
+
+	ChunkingPolicy() :
+		TickChunking(ChunkingMode::Guided), OnceChunking(ChunkingMode::Adaptive),
+		MinTasksPerIteration(1), ChunksPerThread(2), TargetIterationDuration(200) {}
+
+	// Returns the number of tasks to take from a queue
+	// @param Mode - chunking mode of the queue
+	// @param NumOfQueuedTasks - number of tasks in the queue
+	// @param NumOfThreads - number of running standard threads
+	// @param MaxTasksPerIteration - upper limit of the chunk
+	// @param AverageTaskDuration - measured average duration of a task from the queue in nanoseconds, 0 if unknown
+	unsigned int GetNumOfTasksToTake(ChunkingMode Mode, size_t NumOfQueuedTasks, unsigned int NumOfThreads, 
+		unsigned int MaxTasksPerIteration, float AverageTaskDuration) const;
+};
@@ -0,0 +1,111 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogramSnapshot::LatencyHistogramSnapshot() : Buckets(LatencyHistogram::NumOfBuckets, 0), Count(0), TotalTime(0), MaxTime(0)
+{
+}
+
+void LatencyHistogramSnapshot::Merge(const LatencyHistogramSnapshot& Other)
+{
+	for (size_t i = 0; i < Buckets.size() && i < Other.Buckets.size(); i++)
+	{
+		Buckets[i] += Other.Buckets[i];
+	}
+
+	Count += Other.Count;
+	TotalTime += Other.TotalTime;
+
+	if (Other.MaxTime > MaxTime)
+	{
+		MaxTime = Other.MaxTime;
+	}
+}
+
+double LatencyHistogramSnapshot::GetMean() const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	return static_cast<double>(TotalTime) / static_cast<double>(Count);
+}
+
+unsigned long long LatencyHistogramSnapshot::GetPercentile(float Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0;
+	}
+
+	const double Threshold = static_cast<double>(Count) * Percentile / 100.0;
+
+	unsigned long long Accumulated = 0;
+	for (size_t i = 0; i < Buckets.size(); i++)
+	{
+		Accumulated += Buckets[i];
+
+		if (static_cast<double>(Accumulated) >= Threshold && Accumulated != 0)
+		{
+			const unsigned long long UpperBound = 2ULL << i;
+			return UpperBound < MaxTime ? UpperBound : MaxTime;
+		}
+	}
+
+	return MaxTime;
+}
+
+
+LatencyHistogram::LatencyHistogram() : Count(0), TotalTime(0), MaxTime(0)
+{
+	for (unsigned int i = 0; i < NumOfBuckets; i++)
+	{
+		Buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::Record(unsigned long long Duration)
+{
+	// Index of the highest set bit
+	unsigned int Bucket = 0;
+	for (unsigned long long Value = Duration >> 1; Value != 0 && Bucket < NumOfBuckets - 1; Value >>= 1)
+	{
+		Bucket++;
+	}
+
+	Buckets[Bucket].store(Buckets[Bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	Count.store(Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	TotalTime.store(TotalTime.load(std::memory_order_relaxed) + Duration, std::memory_order_relaxed);
+
+	if (Duration > MaxTime.load(std::memory_order_relaxed))
+	{
+		MaxTime.store(Duration, std::memory_order_relaxed);
+	}
+}
+
+LatencyHistogramSnapshot LatencyHistogram::GetSnapshot() const
+{
+	LatencyHistogramSnapshot Snapshot;
+
+	for (unsigned int i = 0; i < NumOfBuckets; i++)
+	{
+		Snapshot.Buckets[i] = Buckets[i].load(std::memory_order_relaxed);
+	}
+
+	Snapshot.Count = Count.load(std::memory_order_relaxed);
+	Snapshot.TotalTime = TotalTime.load(std::memory_order_relaxed);
+	Snapshot.MaxTime = MaxTime.load(std::memory_order_relaxed);
+
+	return Snapshot;
+}
+
+void LatencyHistogram::Reset()
+{
+	for (unsigned int i = 0; i < NumOfBuckets; i++)
+	{
+		Buckets[i].store(0, std::memory_order_relaxed);
+	}
+
+	Count.store(0, std::memory_order_relaxed);
+	TotalTime.store(0, std::memory_order_relaxed);
+	MaxTime.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Copy of the histogram contents that can be freely read and merged
+struct LatencyHistogramSnapshot
+{
+	// Bucket i counts durations from 2^i to 2^(i+1) nanoseconds, bucket 0 also counts zero durations
+	std::vector<unsigned long long> Buckets;
+
+	unsigned long long Count;
+	unsigned long long TotalTime;
+	unsigned long long MaxTime;
+
+	LatencyHistogramSnapshot();
+
+	// Adds the contents of another snapshot to this one
+	// @param Other - Snapshot to add
+	void Merge(const LatencyHistogramSnapshot& Other);
+
+	// Returns the average duration in nanoseconds
+	double GetMean() const;
+
+	// Returns the upper bound of the bucket containing the given percentile, in nanoseconds
+	// @param Percentile - Percentile from 0 to 100
+	unsigned long long GetPercentile(float Percentile) const;
+};
+
+// Histogram of durations with power of two buckets
+// Only one thread may record, so recording uses relaxed loads and stores and does not contend with readers
+class LatencyHistogram final
+{
+public:
+	static const unsigned int NumOfBuckets = 40;
+
+private:
+	std::atomic<unsigned long long> Buckets[NumOfBuckets];
+
+	std::atomic<unsigned long long> Count;
+	std::atomic<unsigned long long> TotalTime;
+	std::atomic<unsigned long long> MaxTime;
+
+public:
+	LatencyHistogram();
+
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	// Adds a duration to the histogram
+	// @param Duration - Duration in nanoseconds
+	void Record(unsigned long long Duration);
+
+	// Returns a copy of the histogram contents
+	LatencyHistogramSnapshot GetSnapshot() const;
+
+	// Clears the histogram
+	void Reset();
+};
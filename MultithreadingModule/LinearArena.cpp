@@ -0,0 +1,123 @@
+#include "LinearArena.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+const size_t LinearArena::DefaultBlockSize;
+
+LinearArena::LinearArena() : LinearArena(DefaultBlockSize)
+{
+}
+
+LinearArena::LinearArena(size_t NewBlockSize) : CurrentBlock(0), Offset(0), BlockSize(NewBlockSize == 0 ? DefaultBlockSize : NewBlockSize),
+	UsedSize(0), HighWaterMark(0), Capacity(0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+	for (size_t i = 0; i < Blocks.size(); i++)
+	{
+		std::free(Blocks[i].Memory);
+	}
+	Blocks.clear();
+}
+
+void* LinearArena::Allocate(size_t Size, size_t Alignment)
+{
+	if (Size == 0)
+	{
+		return nullptr;
+	}
+	if (Alignment == 0)
+	{
+		Alignment = 1;
+	}
+
+	// Move to the next block until the allocation fits, adding a block if there is none
+	while (true)
+	{
+		if (CurrentBlock < Blocks.size())
+		{
+			const ArenaBlock& Block = Blocks[CurrentBlock];
+			const size_t Address = reinterpret_cast<size_t>(Block.Memory) + Offset;
+			const size_t Padding = (Alignment - (Address & (Alignment - 1))) & (Alignment - 1);
+
+			if (Offset + Padding + Size <= Block.Size)
+			{
+				void* Memory = Block.Memory + Offset + Padding;
+				Offset += Padding + Size;
+
+				const size_t NewUsedSize = UsedSize.load(std::memory_order_relaxed) + Padding + Size;
+				UsedSize.store(NewUsedSize, std::memory_order_relaxed);
+				if (NewUsedSize > HighWaterMark.load(std::memory_order_relaxed))
+				{
+					HighWaterMark.store(NewUsedSize, std::memory_order_relaxed);
+				}
+				return Memory;
+			}
+
+			if (CurrentBlock + 1 < Blocks.size() && Blocks[CurrentBlock + 1].Size >= Size + Alignment)
+			{
+				CurrentBlock++;
+				Offset = 0;
+				continue;
+			}
+		}
+
+		AddBlock(Size + Alignment);
+	}
+}
+
+void LinearArena::Reset()
+{
+#if MULTITHREADING_ARENA_POISON
+	for (size_t i = 0; i < Blocks.size() && i <= CurrentBlock; i++)
+	{
+		std::memset(Blocks[i].Memory, 0xDD, i == CurrentBlock ? Offset : Blocks[i].Size);
+	}
+#endif
+
+	CurrentBlock = 0;
+	Offset = 0;
+	UsedSize.store(0, std::memory_order_relaxed);
+}
+
+size_t LinearArena::GetUsedSize() const
+{
+	return UsedSize.load(std::memory_order_relaxed);
+}
+
+size_t LinearArena::GetHighWaterMark() const
+{
+	return HighWaterMark.load(std::memory_order_relaxed);
+}
+
+size_t LinearArena::GetCapacity() const
+{
+	return Capacity.load(std::memory_order_relaxed);
+}
+
+void LinearArena::ResetHighWaterMark()
+{
+	HighWaterMark.store(UsedSize.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void LinearArena::AddBlock(size_t MinSize)
+{
+	ArenaBlock Block;
+	Block.Size = MinSize > BlockSize ? MinSize : BlockSize;
+	Block.Memory = static_cast<unsigned char*>(std::malloc(Block.Size));
+	if (Block.Memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	// The new block is used right away, the following blocks stay for the next allocations
+	const size_t Position = Blocks.empty() ? 0 : CurrentBlock + 1;
+	Blocks.insert(Blocks.begin() + Position, Block);
+	CurrentBlock = Position;
+	Offset = 0;
+
+	Capacity.fetch_add(Block.Size, std::memory_order_relaxed);
+}
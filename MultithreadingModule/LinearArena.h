@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <atomic>
+#include <vector>
+#include "MultithreadingConfig.h"
+
+// Bump-pointer allocator for short-lived memory
+// Allocation only moves a pointer, memory is not freed one by one but all at once by Reset
+// Blocks are kept after Reset, so an arena that reached its working size no longer calls malloc
+// Only one thread may allocate and reset, the metrics can be read from any thread
+class LinearArena final
+{
+private:
+	struct ArenaBlock
+	{
+		unsigned char* Memory;
+		size_t Size;
+	};
+
+	std::vector<ArenaBlock> Blocks;
+	// Block that allocations are taken from and the offset of the free memory in it
+	size_t CurrentBlock;
+	size_t Offset;
+
+	// Size of regular blocks, larger allocations get a block of their own size
+	size_t BlockSize;
+
+	// Bytes given out since the last Reset, including alignment padding
+	std::atomic<size_t> UsedSize;
+	// Maximum of UsedSize since the creation or the last ResetHighWaterMark
+	std::atomic<size_t> HighWaterMark;
+	// Total size of the blocks
+	std::atomic<size_t> Capacity;
+
+public:
+	// Default size of a block in bytes
+	static const size_t DefaultBlockSize = 64 * 1024;
+
+	LinearArena();
+	// @param NewBlockSize - size of a block in bytes
+	explicit LinearArena(size_t NewBlockSize);
+	~LinearArena();
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	// Allocates memory that stays valid until the next Reset
+	// @param Size - size in bytes
+	// @param Alignment - alignment in bytes, a power of two
+	// @return the memory, or nullptr if Size is 0
+	void* Allocate(size_t Size, size_t Alignment);
+
+	// Allocates an array of objects without constructing them
+	// Objects are never destroyed, so only trivially destructible types should be placed in the arena
+	// @param Count - number of objects
+	template<typename T>
+	T* AllocateArray(size_t Count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * Count, alignof(T)));
+	}
+
+	// Frees all allocations at once, the blocks are kept for reuse
+	// With MULTITHREADING_ARENA_POISON the freed memory is filled with 0xDD
+	void Reset();
+
+	// Returns the number of bytes allocated since the last Reset
+	size_t GetUsedSize() const;
+	// Returns the maximum number of bytes that were allocated at once
+	size_t GetHighWaterMark() const;
+	// Returns the total size of the blocks of the arena
+	size_t GetCapacity() const;
+
+	// Starts measuring the high water mark from the current usage
+	void ResetHighWaterMark();
+
+private:
+	// Adds a block that fits the allocation after the current one
+	// @param MinSize - minimum size of the block
+	void AddBlock(size_t MinSize);
+};
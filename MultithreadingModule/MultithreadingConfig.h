@@ -0,0 +1,23 @@
+#pragma once
+
+// Compile-time switches of the module, they can be overridden from the build settings
+
+// Collection of runtime statistics by the threads (0 - disabled, GetStatistics returns empty statistics)
+#ifndef MULTITHREADING_ENABLE_STATISTICS
+#define MULTITHREADING_ENABLE_STATISTICS 1
+#endif
+
+// Recording of task trace events into per-thread ring buffers (0 - disabled, dumps are empty)
+#ifndef MULTITHREADING_ENABLE_TRACING
+#define MULTITHREADING_ENABLE_TRACING 1
+#endif
+
+// Filling of the memory of linear arenas with a pattern when they are reset, to catch its use after the reset
+// (0 - disabled, enabled by default in debug builds)
+#ifndef MULTITHREADING_ARENA_POISON
+#ifdef NDEBUG
+#define MULTITHREADING_ARENA_POISON 0
+#else
+#define MULTITHREADING_ARENA_POISON 1
+#endif
+#endif
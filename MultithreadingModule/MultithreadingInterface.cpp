@@ -1 +1,5 @@
 #include "MultithreadingInterface.h"
+
+MultithreadingInterface::~MultithreadingInterface()
+{
+}
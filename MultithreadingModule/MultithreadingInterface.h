@@ -1,7 +1,7 @@
 #pragma once
 #include "TaskStopSignal.h"
 
-class MultithreadingInterface final
+class MultithreadingInterface
 {
 public:
 	virtual ~MultithreadingInterface() = 0;
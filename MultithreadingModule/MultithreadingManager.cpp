@@ -1,15 +1,61 @@
 #include "MultithreadingManager.h"
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
 
-unsigned int MultithreadingManager::MaxNumOfThreads = 4;
-std::mutex MultithreadingManager::MaxNumOfThreadsMutex;
+bool MultithreadingManager::bDeterministicExecution = false;
+unsigned int MultithreadingManager::DeterministicExecutionSeed = 0;
+std::mutex MultithreadingManager::DeterministicExecutionMutex;
 
-unsigned int MultithreadingManager::MaxNumOfStoppedThreads = 8;
-std::mutex MultithreadingManager::MaxNumOfStoppedThreadsMutex;
+// Returns the value of an environment variable, or an empty string if it is not set
+static std::string ReadEnvironmentVariable(const char* Name)
+{
+#ifdef _MSC_VER
+	char* Value = nullptr;
+	size_t Length = 0;
+	if (_dupenv_s(&Value, &Length, Name) != 0 || Value == nullptr)
+	{
+		return std::string();
+	}
+
+	std::string Result(Value);
+	free(Value);
+	return Result;
+#else
+	const char* Value = std::getenv(Name);
+	return Value != nullptr ? std::string(Value) : std::string();
+#endif
+}
 
 
 
-MultithreadingManager::MultithreadingManager() : ThreadsManager(nullptr), NumOfThreads(0), DeltaTime(0.0f), bThreadCompletedTickTasks(false)
+MultithreadingManager::MultithreadingManager(const MultithreadingPoolConfig& Config) : Name(Config.Name), ThreadsManager(nullptr), NumOfThreads(0),
+	MaxNumOfThreads(1), MaxTickTasksPerIteration(Config.MaxTickTasksPerIteration), MaxOnceTasksPerIteration(Config.MaxOnceTasksPerIteration),
+	Chunking(Config.Chunking), LifecycleHooks(Config.WorkerHooks),
+	NumOfHighLoadSamples(0), NumOfLowLoadSamples(0), MaxTickDuration(0.0f),
+	MinNumOfIdleDedicatedThreads(Config.MinNumOfIdleDedicatedThreads), MaxNumOfIdleDedicatedThreads(Config.MaxNumOfIdleDedicatedThreads),
+	NumOfDedicatedPoolHits(0), NumOfDedicatedPoolMisses(0), MaxNumOfStoppedThreads(Config.MaxNumOfStoppedThreads), 
+	OnceTasksCapacity(Config.OnceQueueCapacity), OnceTasksOverflow(Config.OnceQueueOverflow), OnceTasksPeakSize(0), NumOfBlockedSubmissions(0), NumOfRejectedTasks(0), NumOfDroppedTasks(0),
+	NumOfTickPhases(0), NumOfTickScheduleBuilds(0),
+	bDispatchCallbacksInTick(Config.bDispatchCallbacksInTick), MaxCallbacksPerTick(Config.MaxCallbacksPerTick),
+	FrameIndex(0), CurrentFrameArena(0),
+	DeltaTime(0.0f), bThreadCompletedTickTasks(false),
+	NumOfDeterministicTicks(0), NumOfTaskExceptions(0), NumOfBlockedThreads(0), NumOfCompensatingThreads(0), bManagerWakeUpRequested(false), NumOfTicks(0)
 {
+	// The setter keeps the limit valid
+	SetMaxNumOfThreads(Config.MaxNumOfThreads);
+	SetAutoscalerPolicy(Config.Autoscaler);
+
+	// Deterministic execution can be enabled without changing the code, for profiling
+	const std::string DeterministicSeed = ReadEnvironmentVariable("MULTITHREADING_DETERMINISTIC_SEED");
+	if (!DeterministicSeed.empty())
+	{
+		SetDeterministicExecution(true, static_cast<unsigned int>(std::strtoul(DeterministicSeed.c_str(), nullptr, 10)));
+	}
+
+	LastAutoscalerSampleTime = std::chrono::steady_clock::now();
+	LastAutoscalerResizeTime = LastAutoscalerSampleTime;
+
 	// Starting Threads Manager
 	ThreadMethodTask<MultithreadingManager>* ThreadsManagerTask = new ThreadMethodTask<MultithreadingManager>(this, &MultithreadingManager::ThreadsManagerExecution);
 	ThreadsManager = new AdvancedThread();
@@ -27,29 +73,176 @@ MultithreadingManager::~MultithreadingManager()
 	RemoveAllTasks();
 }
 
+const std::string& MultithreadingManager::GetName() const
+{
+	return Name;
+}
+
+void MultithreadingManager::SetConfig(const MultithreadingPoolConfig& NewConfig)
+{
+	SetMaxNumOfThreads(NewConfig.MaxNumOfThreads);
+	SetMaxNumOfStoppedThreads(NewConfig.MaxNumOfStoppedThreads);
+	SetMinNumOfIdleDedicatedThreads(NewConfig.MinNumOfIdleDedicatedThreads);
+	SetMaxNumOfIdleDedicatedThreads(NewConfig.MaxNumOfIdleDedicatedThreads);
+	SetMaxTickTasksPerIteration(NewConfig.MaxTickTasksPerIteration);
+	SetMaxOnceTasksPerIteration(NewConfig.MaxOnceTasksPerIteration);
+	SetOnceQueueCapacity(NewConfig.OnceQueueCapacity, NewConfig.OnceQueueOverflow);
+	SetAutoscalerPolicy(NewConfig.Autoscaler);
+	SetChunkingPolicy(NewConfig.Chunking);
+	SetWorkerHooks(NewConfig.WorkerHooks);
+	SetDispatchCallbacksInTick(NewConfig.bDispatchCallbacksInTick, NewConfig.MaxCallbacksPerTick);
+}
+
+MultithreadingPoolConfig MultithreadingManager::GetConfig()
+{
+	MultithreadingPoolConfig Config(Name);
+	Config.MaxNumOfThreads = GetMaxNumOfThreads();
+	Config.MaxNumOfStoppedThreads = GetMaxNumOfStoppedThreads();
+	Config.MinNumOfIdleDedicatedThreads = GetMinNumOfIdleDedicatedThreads();
+	Config.MaxNumOfIdleDedicatedThreads = GetMaxNumOfIdleDedicatedThreads();
+	Config.MaxTickTasksPerIteration = GetMaxTickTasksPerIteration();
+	Config.MaxOnceTasksPerIteration = GetMaxOnceTasksPerIteration();
+	Config.OnceQueueCapacity = GetOnceQueueCapacity();
+	Config.OnceQueueOverflow = GetOnceQueueOverflow();
+	Config.Autoscaler = GetAutoscalerPolicy();
+	Config.Chunking = GetChunkingPolicy();
+	Config.WorkerHooks = GetWorkerHooks();
+	Config.bDispatchCallbacksInTick = GetDispatchCallbacksInTick();
+	Config.MaxCallbacksPerTick = GetMaxCallbacksPerTick();
+	return Config;
+}
+
 
 void MultithreadingManager::Tick(float DeltaTime)
 {
+	if (GetDeterministicExecution())
+	{
+		TickDeterministic(DeltaTime);
+		return;
+	}
+
+	const std::chrono::steady_clock::time_point TickStart = std::chrono::steady_clock::now();
+
 	SetTickDeltaTime(DeltaTime);
 
+	// Batch Tick tasks are split into chunks by the number of threads
+	const unsigned int NumOfExecutingThreads = GetNumOfThreads();
+
 	std::unique_lock<std::mutex> LockTickTasks(TickTasksMutex);
+
+	ApplyTickTaskChanges();
 	
 	// If a request was made to execute Tick tasks, but there are no such tasks, then we stop the execution
-	if (TickTasks.empty())
+	if (TickTasks.IsEmpty())
 	{
+		LockTickTasks.unlock();
+		DispatchCallbacksInTick();
+		AdvanceFrame();
 		return;
 	}
 
-	// Copy all tasks to the execution queue
-	std::unique_lock<std::mutex> LockTickTasksForExecution(TickTasksForExecutionMutex);
-	for (size_t i = 0; i < TickTasks.size(); i++)
+	TaskTracer::Record(TraceEventType::TickBegin, nullptr);
+	TaskTracer::Record(TraceEventType::TickPhaseBegin, "Fork");
+
+	const size_t NumOfPhases = SelectTickTasks(DeltaTime, FrameIndex.load(std::memory_order_relaxed));
+	LockTickTasks.unlock();
+
+	// Conflicting tasks are in different phases, each phase waits for the previous one
+	bool bFirstPhase = true;
+	for (size_t Phase = 0; Phase < NumOfPhases; Phase++)
+	{
+		if (!PushTickPhase(Phase, NumOfExecutingThreads))
+		{
+			continue;
+		}
+
+		if (!bFirstPhase)
+		{
+			TaskTracer::Record(TraceEventType::TickPhaseBegin, "Fork");
+		}
+
+		ExecuteTickPhase(TickStart, bFirstPhase);
+		bFirstPhase = false;
+	}
+
+	// Every task can be waiting for its interval, then no phase is executed
+	if (bFirstPhase)
 	{
-		TickTasksForExecution.push(TickTasks[i]);
+		TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+	}
+
+#if MULTITHREADING_ENABLE_STATISTICS
+	NumOfTicks.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+	// Callbacks of the Tick tasks are delivered in the same Tick
+	DispatchCallbacksInTick();
+	AdvanceFrame();
+
+	TaskTracer::Record(TraceEventType::TickEnd, nullptr);
+
+	RecordTickDuration(std::chrono::duration<float>(std::chrono::steady_clock::now() - TickStart).count());
+}
+
+size_t MultithreadingManager::SelectTickTasks(float DeltaTime, unsigned long long TickIndex)
+{
+	const std::vector<std::vector<ThreadTask*>>& Phases = TickTasksSchedule.GetPhases();
+	NumOfTickPhases.store(static_cast<unsigned int>(Phases.size()), std::memory_order_relaxed);
+	NumOfTickScheduleBuilds.store(TickTasksSchedule.GetNumOfBuilds(), std::memory_order_relaxed);
+
+	if (TickPhaseTasks.size() < Phases.size())
+	{
+		TickPhaseTasks.resize(Phases.size());
+	}
+
+	const unsigned long long EnqueueTime = GetStatisticsTime();
+	for (size_t Phase = 0; Phase < Phases.size(); Phase++)
+	{
+		TickPhaseTasks[Phase].clear();
+
+		for (size_t i = 0; i < Phases[Phase].size(); i++)
+		{
+			ThreadTask* Task = Phases[Phase][i];
+
+			// Dormant tasks and tasks waiting for their interval are not queued
+			if (!Task->ScheduleTick(DeltaTime, TickIndex))
+			{
+				continue;
+			}
+
+			// Cancelled Tick tasks stay registered until they are removed, but are no longer executed
+			if (Task->IsCancelled())
+			{
+				continue;
+			}
+
+			Task->SetEnqueueTime(EnqueueTime);
+			TickPhaseTasks[Phase].push_back(Task);
+		}
 	}
-	LockTickTasks.unlock();
-	LockTickTasksForExecution.unlock();
 
+	return Phases.size();
+}
+
+bool MultithreadingManager::PushTickPhase(size_t Phase, unsigned int NumOfThreads)
+{
+	const std::vector<ThreadTask*>& Tasks = TickPhaseTasks[Phase];
+	if (Tasks.empty())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> LockTickTasksForExecution(TickTasksForExecutionMutex);
+	for (size_t i = 0; i < Tasks.size(); i++)
+	{
+		Tasks[i]->PushTickEntries(TickTasksForExecution, NumOfThreads);
+	}
 
+	return true;
+}
+
+void MultithreadingManager::ExecuteTickPhase(const std::chrono::steady_clock::time_point& TickStart, bool bFirstPhase)
+{
 	std::vector<AdvancedThread*> ExecutingThreads;
 
 	// Telling all threads to execute Tick tasks
@@ -63,6 +256,16 @@ void MultithreadingManager::Tick(float DeltaTime)
 	}
 	LockStandardWorkers.unlock();
 
+#if MULTITHREADING_ENABLE_STATISTICS
+	if (bFirstPhase)
+	{
+		TickForkTime.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TickStart).count());
+	}
+#endif
+
+	TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+	TaskTracer::Record(TraceEventType::TickPhaseBegin, "Wait for threads");
+
 	// Waiting for end of execution
 	while (true)
 	{
@@ -98,6 +301,23 @@ void MultithreadingManager::Tick(float DeltaTime)
 
 		if (bExit)
 		{
+#if MULTITHREADING_ENABLE_STATISTICS
+			unsigned long long LastTickCompletionTime = 0;
+			for (size_t i = 0; i < ExecutingThreads.size(); i++)
+			{
+				if (ExecutingThreads[i]->GetTickCompletionTime() > LastTickCompletionTime)
+				{
+					LastTickCompletionTime = ExecutingThreads[i]->GetTickCompletionTime();
+				}
+			}
+
+			const unsigned long long TickEnd = GetStatisticsTime();
+			if (LastTickCompletionTime != 0 && LastTickCompletionTime <= TickEnd)
+			{
+				TickJoinTime.Record(TickEnd - LastTickCompletionTime);
+			}
+#endif
+
 			for (size_t i = 0; i < ExecutingThreads.size(); i++)
 			{
 				ExecutingThreads[i]->SetCanBeDestroyed(true);
@@ -106,13 +326,15 @@ void MultithreadingManager::Tick(float DeltaTime)
 			break;
 		}
 	}
+
+	TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
 }
 
 void MultithreadingManager::StartThreads()
 {
 	std::unique_lock<std::mutex> Lock(StandardWorkersMutex);
 
-	if (!StandardWorkers.empty())
+	if (!StandardWorkers.empty() || GetDeterministicExecution())
 	{
 		return;
 	}
@@ -131,6 +353,8 @@ void MultithreadingManager::StopThreads()
 	{
 		StopOneThread();
 	}
+
+	StopParkedThreads();
 }
 
 void MultithreadingManager::StopThreadsWithWaiting()
@@ -139,11 +363,14 @@ void MultithreadingManager::StopThreadsWithWaiting()
 	{
 		StopOneThreadWithWaiting();
 	}
+
+	StopParkedThreadsWithWaiting();
 }
 
 void MultithreadingManager::StopDedicatedThreads()
 {
 	std::lock_guard<std::mutex> LockDedicatedWorkers(DedicatedWorkersMutex);
+	std::lock_guard<std::mutex> LockIdleDedicatedWorkers(IdleDedicatedWorkersMutex);
 	std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
 	while (DedicatedWorkers.size() != 0)
 	{
@@ -151,11 +378,18 @@ void MultithreadingManager::StopDedicatedThreads()
 		PendingStopWorkers.push_back(DedicatedWorkers.back());
 		DedicatedWorkers.pop_back();
 	}
+	while (IdleDedicatedWorkers.size() != 0)
+	{
+		IdleDedicatedWorkers.back()->Stop();
+		PendingStopWorkers.push_back(IdleDedicatedWorkers.back());
+		IdleDedicatedWorkers.pop_back();
+	}
 }
 
 void MultithreadingManager::StopDedicatedThreadsWithWaiting()
 {
 	std::lock_guard<std::mutex> LockDedicatedWorkers(DedicatedWorkersMutex);
+	std::lock_guard<std::mutex> LockIdleDedicatedWorkers(IdleDedicatedWorkersMutex);
 	std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
 	while (DedicatedWorkers.size() != 0)
 	{
@@ -163,6 +397,12 @@ void MultithreadingManager::StopDedicatedThreadsWithWaiting()
 		PendingStopWorkers.push_back(DedicatedWorkers.back());
 		DedicatedWorkers.pop_back();
 	}
+	while (IdleDedicatedWorkers.size() != 0)
+	{
+		IdleDedicatedWorkers.back()->StopWithWaiting();
+		PendingStopWorkers.push_back(IdleDedicatedWorkers.back());
+		IdleDedicatedWorkers.pop_back();
+	}
 }
 
 std::vector<ThreadState> MultithreadingManager::GetDedicatedThreadsStates()
@@ -179,6 +419,48 @@ std::vector<ThreadState> MultithreadingManager::GetDedicatedThreadsStates()
 	return States;
 }
 
+unsigned int MultithreadingManager::GetNumOfIdleDedicatedThreads()
+{
+	std::unique_lock<std::mutex> Lock(IdleDedicatedWorkersMutex);
+	return IdleDedicatedWorkers.size();
+}
+
+void MultithreadingManager::SetMinNumOfIdleDedicatedThreads(unsigned int NewMin)
+{
+	std::unique_lock<std::mutex> Lock(MinNumOfIdleDedicatedThreadsMutex);
+	MinNumOfIdleDedicatedThreads = NewMin;
+}
+
+unsigned int MultithreadingManager::GetMinNumOfIdleDedicatedThreads()
+{
+	std::unique_lock<std::mutex> Lock(MinNumOfIdleDedicatedThreadsMutex);
+	return MinNumOfIdleDedicatedThreads;
+}
+
+void MultithreadingManager::SetMaxNumOfIdleDedicatedThreads(unsigned int NewMax)
+{
+	std::unique_lock<std::mutex> Lock(MaxNumOfIdleDedicatedThreadsMutex);
+	MaxNumOfIdleDedicatedThreads = NewMax;
+}
+
+unsigned int MultithreadingManager::GetMaxNumOfIdleDedicatedThreads()
+{
+	std::unique_lock<std::mutex> Lock(MaxNumOfIdleDedicatedThreadsMutex);
+	return MaxNumOfIdleDedicatedThreads;
+}
+
+float MultithreadingManager::GetDedicatedThreadsPoolHitRate()
+{
+	std::unique_lock<std::mutex> Lock(DedicatedPoolStatisticsMutex);
+
+	if (NumOfDedicatedPoolHits + NumOfDedicatedPoolMisses == 0)
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(NumOfDedicatedPoolHits) / static_cast<float>(NumOfDedicatedPoolHits + NumOfDedicatedPoolMisses);
+}
+
 void MultithreadingManager::ChangeNumOfRunningThreads(unsigned int NewNumOfStandardThreads)
 {
 	if (NewNumOfStandardThreads == GetNumOfThreads())
@@ -196,6 +478,11 @@ void MultithreadingManager::ChangeNumOfRunningThreads(unsigned int NewNumOfStand
 	}
 	else
 	{
+		if (GetDeterministicExecution())
+		{
+			return;
+		}
+
 		if (NewNumOfStandardThreads > GetMaxNumOfThreads())
 		{
 			NewNumOfStandardThreads = GetMaxNumOfThreads();
@@ -229,6 +516,131 @@ unsigned int MultithreadingManager::GetNumOfThreads()
 	return NumOfThreads;
 }
 
+unsigned int MultithreadingManager::GetNumOfParkedThreads()
+{
+	std::unique_lock<std::mutex> Lock(ParkedWorkersMutex);
+	return ParkedWorkers.size();
+}
+
+unsigned int MultithreadingManager::GetNumOfBlockedThreads()
+{
+	return NumOfBlockedThreads.load();
+}
+
+void MultithreadingManager::SetAutoscalerPolicy(const AutoscalerPolicy& NewPolicy)
+{
+	std::unique_lock<std::mutex> Lock(AutoscalerMutex);
+	Autoscaler = NewPolicy;
+}
+
+AutoscalerPolicy MultithreadingManager::GetAutoscalerPolicy()
+{
+	std::unique_lock<std::mutex> Lock(AutoscalerMutex);
+	return Autoscaler;
+}
+
+void MultithreadingManager::SetChunkingPolicy(const ChunkingPolicy& NewPolicy)
+{
+	std::unique_lock<std::mutex> Lock(ChunkingMutex);
+	Chunking = NewPolicy;
+}
+
+ChunkingPolicy MultithreadingManager::GetChunkingPolicy()
+{
+	std::unique_lock<std::mutex> Lock(ChunkingMutex);
+	return Chunking;
+}
+
+MultithreadingStatistics MultithreadingManager::GetStatistics()
+{
+	MultithreadingStatistics Statistics;
+
+	StandardWorkersMutex.lock();
+	for (size_t i = 0; i < StandardWorkers.size(); i++)
+	{
+		Statistics.Workers.push_back(StandardWorkers[i]->GetStatistics());
+	}
+	StandardWorkersMutex.unlock();
+
+	ParkedWorkersMutex.lock();
+	for (size_t i = 0; i < ParkedWorkers.size(); i++)
+	{
+		Statistics.Workers.push_back(ParkedWorkers[i]->GetStatistics());
+	}
+	ParkedWorkersMutex.unlock();
+
+	for (size_t i = 0; i < Statistics.Workers.size(); i++)
+	{
+		Statistics.Total.Merge(Statistics.Workers[i]);
+	}
+
+	Statistics.NumOfTaskExceptions = NumOfTaskExceptions.load(std::memory_order_relaxed);
+	Statistics.NumOfBlockedThreads = NumOfBlockedThreads.load(std::memory_order_relaxed);
+
+	OnceTasksMutex.lock();
+	Statistics.OnceQueueSize = OnceTasks.Size();
+	Statistics.OnceQueueCapacity = OnceTasksCapacity;
+	Statistics.OnceQueuePeakSize = OnceTasksPeakSize;
+	OnceTasksMutex.unlock();
+	Statistics.NumOfBlockedSubmissions = NumOfBlockedSubmissions.load(std::memory_order_relaxed);
+	Statistics.NumOfRejectedTasks = NumOfRejectedTasks.load(std::memory_order_relaxed);
+	Statistics.NumOfDroppedTasks = NumOfDroppedTasks.load(std::memory_order_relaxed);
+
+	FrameArenasMutex.lock();
+	for (size_t i = 0; i < 2; i++)
+	{
+		if (FrameArenas[i].GetHighWaterMark() > Statistics.FrameArenaHighWaterMark)
+		{
+			Statistics.FrameArenaHighWaterMark = FrameArenas[i].GetHighWaterMark();
+		}
+		Statistics.FrameArenaCapacity += FrameArenas[i].GetCapacity();
+	}
+	FrameArenasMutex.unlock();
+
+	Statistics.NumOfTicks = NumOfTicks.load(std::memory_order_relaxed);
+	Statistics.NumOfTickPhases = NumOfTickPhases.load(std::memory_order_relaxed);
+	Statistics.NumOfTickScheduleBuilds = NumOfTickScheduleBuilds.load(std::memory_order_relaxed);
+	Statistics.TickForkTime = TickForkTime.GetSnapshot();
+	Statistics.TickJoinTime = TickJoinTime.GetSnapshot();
+
+	return Statistics;
+}
+
+void MultithreadingManager::ResetStatistics()
+{
+	StandardWorkersMutex.lock();
+	for (size_t i = 0; i < StandardWorkers.size(); i++)
+	{
+		StandardWorkers[i]->ResetStatistics();
+	}
+	StandardWorkersMutex.unlock();
+
+	ParkedWorkersMutex.lock();
+	for (size_t i = 0; i < ParkedWorkers.size(); i++)
+	{
+		ParkedWorkers[i]->ResetStatistics();
+	}
+	ParkedWorkersMutex.unlock();
+
+	NumOfTaskExceptions.store(0, std::memory_order_relaxed);
+
+	OnceTasksMutex.lock();
+	OnceTasksPeakSize = OnceTasks.Size();
+	OnceTasksMutex.unlock();
+	NumOfBlockedSubmissions.store(0, std::memory_order_relaxed);
+	NumOfRejectedTasks.store(0, std::memory_order_relaxed);
+	NumOfDroppedTasks.store(0, std::memory_order_relaxed);
+
+	FrameArenasMutex.lock();
+	FrameArenas[0].ResetHighWaterMark();
+	FrameArenas[1].ResetHighWaterMark();
+	FrameArenasMutex.unlock();
+
+	NumOfTicks.store(0, std::memory_order_relaxed);
+	TickForkTime.Reset();
+	TickJoinTime.Reset();
+}
+
 void MultithreadingManager::SetMaxNumOfThreads(unsigned int NewMax)
 {
 	std::unique_lock<std::mutex> Lock(MaxNumOfThreadsMutex);
@@ -262,6 +674,89 @@ unsigned int MultithreadingManager::GetMaxNumOfStoppedThreads()
 	return MaxNumOfStoppedThreads;
 }
 
+void MultithreadingManager::SetMaxTickTasksPerIteration(unsigned int NewMax)
+{
+	std::unique_lock<std::mutex> Lock(MaxTickTasksPerIterationMutex);
+	MaxTickTasksPerIteration = NewMax;
+}
+
+unsigned int MultithreadingManager::GetMaxTickTasksPerIteration()
+{
+	std::unique_lock<std::mutex> Lock(MaxTickTasksPerIterationMutex);
+	return MaxTickTasksPerIteration;
+}
+
+void MultithreadingManager::SetMaxOnceTasksPerIteration(unsigned int NewMax)
+{
+	std::unique_lock<std::mutex> Lock(MaxOnceTasksPerIterationMutex);
+	MaxOnceTasksPerIteration = NewMax;
+}
+
+unsigned int MultithreadingManager::GetMaxOnceTasksPerIteration()
+{
+	std::unique_lock<std::mutex> Lock(MaxOnceTasksPerIterationMutex);
+	return MaxOnceTasksPerIteration;
+}
+
+void MultithreadingManager::SetOnceQueueCapacity(unsigned int NewCapacity, QueueOverflowMode NewOverflow)
+{
+	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
+	OnceTasksCapacity = NewCapacity;
+	OnceTasksOverflow = NewOverflow;
+	Lock.unlock();
+
+	// The new capacity can let waiting additions through
+	OnceTasksSpaceCondition.notify_all();
+}
+
+unsigned int MultithreadingManager::GetOnceQueueCapacity()
+{
+	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
+	return OnceTasksCapacity;
+}
+
+QueueOverflowMode MultithreadingManager::GetOnceQueueOverflow()
+{
+	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
+	return OnceTasksOverflow;
+}
+
+void MultithreadingManager::SetWorkerHooks(const WorkerLifecycleHooks& NewHooks)
+{
+	std::unique_lock<std::mutex> Lock(LifecycleHooksMutex);
+	LifecycleHooks = NewHooks;
+}
+
+WorkerLifecycleHooks MultithreadingManager::GetWorkerHooks()
+{
+	std::unique_lock<std::mutex> Lock(LifecycleHooksMutex);
+	return LifecycleHooks;
+}
+
+void MultithreadingManager::SetTaskErrorSink(const TaskErrorSink& NewSink)
+{
+	AdvancedThread::SetTaskErrorSink(NewSink);
+}
+
+void MultithreadingManager::SetDeterministicExecution(bool bNewState, unsigned int Seed)
+{
+	std::unique_lock<std::mutex> Lock(DeterministicExecutionMutex);
+	bDeterministicExecution = bNewState;
+	DeterministicExecutionSeed = Seed;
+}
+
+bool MultithreadingManager::GetDeterministicExecution()
+{
+	std::unique_lock<std::mutex> Lock(DeterministicExecutionMutex);
+	return bDeterministicExecution;
+}
+
+unsigned int MultithreadingManager::GetDeterministicExecutionSeed()
+{
+	std::unique_lock<std::mutex> Lock(DeterministicExecutionMutex);
+	return DeterministicExecutionSeed;
+}
+
 void MultithreadingManager::AddTask(ThreadTask* Task)
 {
 	if (Task == nullptr)
@@ -269,6 +764,8 @@ void MultithreadingManager::AddTask(ThreadTask* Task)
 		return;
 	}
 
+	Task->SetCallbackQueue(&DeferredCallbacks);
+
 	if (Task->GetExecuteOnDedicatedThread())
 	{
 		StartDedicatedThread(Task);
@@ -278,7 +775,13 @@ void MultithreadingManager::AddTask(ThreadTask* Task)
 	switch (Task->GetRepeatability())
 	{
 	case TaskRepeatability::Once:
-		AddOnceTask(Task);
+		if (!AddOnceTask(Task, GetOnceQueueOverflow(), WaitForSpaceForever))
+		{
+			// Only a handle taken before the task was added receives the exception, the rejection is counted in any case
+			Task->ReportException(std::make_exception_ptr(std::length_error("The Once task queue is full")));
+			NumOfRejectedTasks.fetch_add(1, std::memory_order_relaxed);
+			delete Task;
+		}
 		break;
 
 	case TaskRepeatability::EveryTick:
@@ -288,52 +791,244 @@ void MultithreadingManager::AddTask(ThreadTask* Task)
 	default:
 		break;
 	}
-	
 }
 
-void MultithreadingManager::RemoveTask(ThreadTask* Task)
+TaskHandle MultithreadingManager::AddTaskWithHandle(ThreadTask* Task)
 {
 	if (Task == nullptr)
 	{
-		return;
+		return TaskHandle();
 	}
 
-	if (Task->GetExecuteOnDedicatedThread())
+	// The handle is taken before the task is queued, since it can be executed and deleted at any moment after that
+	const TaskHandle Handle = Task->GetHandle();
+	AddTask(Task);
+	return Handle;
+}
+
+bool MultithreadingManager::TryAddTask(ThreadTask* Task, unsigned int Timeout)
+{
+	if (Task == nullptr)
 	{
-		return;
+		return false;
 	}
 
-	switch (Task->GetRepeatability())
+	// Only the Once queue is limited
+	if (Task->GetExecuteOnDedicatedThread() || Task->GetRepeatability() != TaskRepeatability::Once)
 	{
-	case TaskRepeatability::Once:
-		return;
-		break;
+		AddTask(Task);
+		return true;
+	}
 
-	case TaskRepeatability::EveryTick:
-		RemoveTickTask(Task);
-		break;
+	Task->SetCallbackQueue(&DeferredCallbacks);
 
-	default:
-		break;
+	if (!AddOnceTask(Task, Timeout != 0 ? QueueOverflowMode::Block : QueueOverflowMode::Reject, Timeout))
+	{
+		NumOfRejectedTasks.fetch_add(1, std::memory_order_relaxed);
+		return false;
 	}
+	return true;
 }
 
-void MultithreadingManager::StartDedicatedThread(ThreadTask* Task)
+void MultithreadingManager::AddInternalTask(ThreadTask* Task)
 {
-	AdvancedThread* NewThread = new AdvancedThread();
-	NewThread->Initialize(Task);
-	NewThread->Start();
+	if (Task == nullptr)
+	{
+		return;
+	}
 
-	std::lock_guard<std::mutex> LockDedicatedWorkers(DedicatedWorkersMutex);
-	DedicatedWorkers.push_back(NewThread);
+	if (Task->GetExecuteOnDedicatedThread() || Task->GetRepeatability() != TaskRepeatability::Once)
+	{
+		AddTask(Task);
+		return;
+	}
+
+	Task->SetCallbackQueue(&DeferredCallbacks);
+	Task->SetInternal(true);
+	AddOnceTask(Task, QueueOverflowMode::Block, WaitForSpaceForever);
 }
 
-unsigned int MultithreadingManager::GetNumOfDedicatedThreads()
+void MultithreadingManager::RemoveTask(ThreadTask* Task)
+{
+	if (Task == nullptr)
+	{
+		return;
+	}
+
+	if (Task->GetExecuteOnDedicatedThread())
+	{
+		return;
+	}
+
+	switch (Task->GetRepeatability())
+	{
+	case TaskRepeatability::Once:
+		return;
+		break;
+
+	case TaskRepeatability::EveryTick:
+		RemoveTickTask(Task->GetHandle());
+		break;
+
+	default:
+		break;
+	}
+}
+
+void MultithreadingManager::RemoveTask(const TaskHandle& Handle)
+{
+	RemoveTickTask(Handle);
+}
+
+unsigned int MultithreadingManager::DispatchCallbacks(unsigned int MaxNumOfCallbacks)
+{
+	return DeferredCallbacks.Dispatch(MaxNumOfCallbacks);
+}
+
+void MultithreadingManager::SetDispatchCallbacksInTick(bool bNewState, unsigned int NewMaxNumOfCallbacks)
+{
+	std::lock_guard<std::mutex> Lock(DispatchCallbacksInTickMutex);
+	bDispatchCallbacksInTick = bNewState;
+	MaxCallbacksPerTick = NewMaxNumOfCallbacks;
+}
+
+bool MultithreadingManager::GetDispatchCallbacksInTick()
+{
+	std::lock_guard<std::mutex> Lock(DispatchCallbacksInTickMutex);
+	return bDispatchCallbacksInTick;
+}
+
+unsigned int MultithreadingManager::GetMaxCallbacksPerTick()
+{
+	std::lock_guard<std::mutex> Lock(DispatchCallbacksInTickMutex);
+	return MaxCallbacksPerTick;
+}
+
+void* MultithreadingManager::AllocateFrameMemory(size_t Size, size_t Alignment)
+{
+	std::lock_guard<std::mutex> Lock(FrameArenasMutex);
+	return FrameArenas[CurrentFrameArena].Allocate(Size, Alignment);
+}
+
+bool MultithreadingManager::ExecuteOnceTask()
+{
+	// Deterministic execution runs Once tasks only in Tick
+	if (GetDeterministicExecution())
+	{
+		return false;
+	}
+
+	std::unique_lock<std::mutex> LockOnceTasks(OnceTasksMutex);
+	ThreadTask* Task = OnceTasks.Pop();
+	if (Task == nullptr)
+	{
+		return false;
+	}
+	LockOnceTasks.unlock();
+	OnceTasksSpaceCondition.notify_all();
+
+	// Cancelled tasks are deleted without execution
+	if (!Task->IsCancelled())
+	{
+		const char* TaskName = Task->GetName();
+		TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : "Once task");
+		if (!AdvancedThread::ExecuteTask(Task, 0))
+		{
+			NumOfTaskExceptions.fetch_add(1, std::memory_order_relaxed);
+		}
+		TaskTracer::Record(TraceEventType::TaskEnd, nullptr);
+	}
+
+	delete Task;
+	return true;
+}
+
+void MultithreadingManager::StartDedicatedThread(ThreadTask* Task)
+{
+	// Reuse a running pooled thread if there is one waiting for a task
+	AdvancedThread* PooledThread = GetIdleDedicatedThread();
+	bool bHit = PooledThread != nullptr && PooledThread->AssignDedicatedTask(Task);
+
+	if (!bHit)
+	{
+		// The taken thread is stopping, let the Threads Manager process it
+		if (PooledThread != nullptr)
+		{
+			std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+			PendingStopWorkers.push_back(PooledThread);
+		}
+
+		PooledThread = StartDedicatedPoolThread();
+		PooledThread->AssignDedicatedTask(Task);
+	}
+
+	UpdateDedicatedPoolStatistics(bHit);
+
+	std::lock_guard<std::mutex> LockDedicatedWorkers(DedicatedWorkersMutex);
+	DedicatedWorkers.push_back(PooledThread);
+}
+
+unsigned int MultithreadingManager::GetNumOfDedicatedThreads()
 {
 	std::unique_lock<std::mutex> Lock(DedicatedWorkersMutex);
 	return DedicatedWorkers.size();
 }
 
+AdvancedThread* MultithreadingManager::StartDedicatedPoolThread()
+{
+	AdvancedThread* StartedThread = nullptr;
+
+	if ((StartedThread = GetStoppedThread()) == nullptr)
+	{
+		StartedThread = new AdvancedThread();
+	}
+
+	StartedThread->InitializeDedicatedPool(&NumOfTaskExceptions, &LifecycleHooks, &LifecycleHooksMutex);
+	StartedThread->Start();
+
+	return StartedThread;
+}
+
+AdvancedThread* MultithreadingManager::GetIdleDedicatedThread()
+{
+	std::unique_lock<std::mutex> LockIdleDedicatedWorkers(IdleDedicatedWorkersMutex);
+	if (!IdleDedicatedWorkers.empty())
+	{
+		AdvancedThread* IdleThread = IdleDedicatedWorkers.back();
+		IdleDedicatedWorkers.pop_back();
+		return IdleThread;
+	}
+	LockIdleDedicatedWorkers.unlock();
+
+	// The Threads Manager returns threads to the idle pool only periodically, 
+	// so threads that have just completed their task are taken directly
+	std::lock_guard<std::mutex> LockDedicatedWorkers(DedicatedWorkersMutex);
+	for (size_t i = 0; i < DedicatedWorkers.size(); i++)
+	{
+		if (DedicatedWorkers[i]->IsAwaitingDedicatedTask())
+		{
+			AdvancedThread* IdleThread = DedicatedWorkers[i];
+			DedicatedWorkers.erase(DedicatedWorkers.begin() + i);
+			return IdleThread;
+		}
+	}
+
+	return nullptr;
+}
+
+void MultithreadingManager::UpdateDedicatedPoolStatistics(bool bHit)
+{
+	std::lock_guard<std::mutex> Lock(DedicatedPoolStatisticsMutex);
+	if (bHit)
+	{
+		NumOfDedicatedPoolHits++;
+	}
+	else
+	{
+		NumOfDedicatedPoolMisses++;
+	}
+}
+
 void MultithreadingManager::RemoveAllTasks()
 {
 	RemoveAllOnceTasks();
@@ -343,20 +1038,32 @@ void MultithreadingManager::RemoveAllTasks()
 void MultithreadingManager::RemoveAllTickTasks()
 {
 	std::unique_lock<std::mutex> Lock(TickTasksMutex);
-	while (!TickTasks.empty())
+
+	// Tasks added before this call are also removed
+	ApplyTickTaskChanges();
+
+	for (size_t i = 0; i < TickTasks.Size(); i++)
 	{
-		delete TickTasks.back();
-		TickTasks.pop_back();
+		delete TickTasks[i];
 	}
+	TickTasks.Clear();
+	TickTasksSchedule.Clear();
 }
 
 void MultithreadingManager::RemoveAllOnceTasks()
 {
+	OnceTaskQueue RemovedTasks;
+
 	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
-	while (!OnceTasks.empty())
+	OnceTasks.Swap(RemovedTasks);
+	Lock.unlock();
+
+	OnceTasksSpaceCondition.notify_all();
+
+	// The tasks are deleted after the queue is unlocked, since a deleted task may add new ones, like a pipeline task
+	while (!RemovedTasks.IsEmpty())
 	{
-		delete OnceTasks.front();
-		OnceTasks.pop();
+		delete RemovedTasks.Pop();
 	}
 }
 
@@ -379,6 +1086,27 @@ void MultithreadingManager::UpdateNumOfThreads()
 	NumOfThreads = StandardWorkers.size();
 }
 
+unsigned int MultithreadingManager::GetMaxNumOfRunningThreads()
+{
+	return GetMaxNumOfThreads() + NumOfBlockedThreads.load();
+}
+
+void MultithreadingManager::UpdateBlockedThreads(bool bBlocking)
+{
+	if (bBlocking)
+	{
+		NumOfBlockedThreads++;
+	}
+	else
+	{
+		NumOfBlockedThreads--;
+	}
+
+	std::lock_guard<std::mutex> Lock(ManagerWakeUpMutex);
+	bManagerWakeUpRequested = true;
+	ManagerWakeUpCondition.notify_one();
+}
+
 void MultithreadingManager::StopOneThread()
 {
 	bool bOneThreadStopped = false;
@@ -464,20 +1192,40 @@ void MultithreadingManager::StartNewThread()
 
 	std::unique_lock<std::mutex> LockStandardWorkers(StandardWorkersMutex);
 
-	if (StandardWorkers.size() >= GetMaxNumOfThreads())
+	if (StandardWorkers.size() >= GetMaxNumOfRunningThreads())
 	{
 		return;
 	}
 
+	// Waking up a parked thread is cheaper than starting a new one
+	if ((StartedThread = GetParkedThread()) != nullptr)
+	{
+		StartedThread->Unpark();
+		StandardWorkers.push_back(StartedThread);
+
+		LockStandardWorkers.unlock();
+
+		UpdateNumOfThreads();
+		return;
+	}
+
 	if ((StartedThread = GetStoppedThread()) == nullptr)
 	{
 		StartedThread = new AdvancedThread();
 	}
 
-	StartedThread->Initialize(&OnceTasks, &OnceTasksMutex,
+	StartedThread->Initialize(&OnceTasks, &OnceTasksMutex, &OnceTasksSpaceCondition,
 		&TickTasksForExecution, &TickTasksForExecutionMutex,
 		&bThreadCompletedTickTasks, &ThreadCompletedTickTasksMutex, &ThreadCompletedTickTasksCondition,
-		&DeltaTime, &DeltaTimeMutex);
+		&DeltaTime, &DeltaTimeMutex,
+		&MaxTickTasksPerIteration, &MaxTickTasksPerIterationMutex,
+		&MaxOnceTasksPerIteration, &MaxOnceTasksPerIterationMutex,
+		&Chunking, &ChunkingMutex,
+		&NumOfThreads, &NumOfThreadsMutex,
+		&NumOfTaskExceptions,
+		&FrameIndex,
+		&LifecycleHooks, &LifecycleHooksMutex,
+		[this](bool bBlocking) { UpdateBlockedThreads(bBlocking); });
 	StartedThread->Start();
 	StandardWorkers.push_back(StartedThread);
 
@@ -501,39 +1249,407 @@ AdvancedThread* MultithreadingManager::GetStoppedThread()
 	return StoppedThread;
 }
 
-void MultithreadingManager::AddOnceTask(ThreadTask* Task)
+void MultithreadingManager::ParkOneThread()
+{
+	std::unique_lock<std::mutex> LockStandardWorkers(StandardWorkersMutex);
+
+	if (StandardWorkers.empty())
+	{
+		return;
+	}
+
+	// Prefer a thread that is already asleep
+	size_t ThreadIndex = StandardWorkers.size() - 1;
+	for (size_t i = 0; i < StandardWorkers.size(); i++)
+	{
+		if (StandardWorkers[i]->GetState() == ThreadState::Asleep)
+		{
+			ThreadIndex = i;
+			break;
+		}
+	}
+
+	StandardWorkers[ThreadIndex]->Park();
+
+	std::unique_lock<std::mutex> LockParkedWorkers(ParkedWorkersMutex);
+	ParkedWorkers.push_back(StandardWorkers[ThreadIndex]);
+	LockParkedWorkers.unlock();
+
+	StandardWorkers.erase(StandardWorkers.begin() + ThreadIndex);
+
+	LockStandardWorkers.unlock();
+	UpdateNumOfThreads();
+}
+
+AdvancedThread* MultithreadingManager::GetParkedThread()
+{
+	AdvancedThread* ParkedThread = nullptr;
+
+	std::unique_lock<std::mutex> LockParkedWorkers(ParkedWorkersMutex);
+
+	// A parked thread could have been stopped in the meantime, such threads are left to the Threads Manager
+	for (size_t i = ParkedWorkers.size(); i > 0; i--)
+	{
+		if (ParkedWorkers[i - 1]->GetState() != ThreadState::Stopped && ParkedWorkers[i - 1]->GetState() != ThreadState::NotReadyToStart)
+		{
+			ParkedThread = ParkedWorkers[i - 1];
+			ParkedWorkers.erase(ParkedWorkers.begin() + (i - 1));
+			break;
+		}
+	}
+
+	return ParkedThread;
+}
+
+void MultithreadingManager::StopParkedThreads()
+{
+	std::lock_guard<std::mutex> LockParkedWorkers(ParkedWorkersMutex);
+	std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+	while (!ParkedWorkers.empty())
+	{
+		ParkedWorkers.back()->Stop();
+		PendingStopWorkers.push_back(ParkedWorkers.back());
+		ParkedWorkers.pop_back();
+	}
+}
+
+void MultithreadingManager::StopParkedThreadsWithWaiting()
+{
+	std::lock_guard<std::mutex> LockParkedWorkers(ParkedWorkersMutex);
+	std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+	while (!ParkedWorkers.empty())
+	{
+		ParkedWorkers.back()->StopWithWaiting();
+		PendingStopWorkers.push_back(ParkedWorkers.back());
+		ParkedWorkers.pop_back();
+	}
+}
+
+unsigned int MultithreadingManager::GetNumOfOnceTasks()
+{
+	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
+	return OnceTasks.Size();
+}
+
+void MultithreadingManager::TickDeterministic(float DeltaTime)
+{
+	SetTickDeltaTime(DeltaTime);
+
+	TaskTracer::Record(TraceEventType::TickBegin, nullptr);
+
+	// Each Tick gets its own interleaving, which is the same on every run with the same seed
+	const unsigned int Seed = GetDeterministicExecutionSeed();
+	std::mt19937 Random(Seed + static_cast<unsigned int>(NumOfDeterministicTicks));
+	std::mt19937* RandomRef = Seed != 0 ? &Random : nullptr;
+	NumOfDeterministicTicks++;
+
+	auto TakeOnceTask = [this]()
+	{
+		std::lock_guard<std::mutex> LockOnceTasks(OnceTasksMutex);
+		return OnceTasks.Pop();
+	};
+	auto TakeTickEntry = [this]() -> ThreadTask*
+	{
+		std::lock_guard<std::mutex> LockTickTasksForExecution(TickTasksForExecutionMutex);
+		if (TickTasksForExecution.empty())
+		{
+			return nullptr;
+		}
+
+		ThreadTask* Entry = TickTasksForExecution.front();
+		TickTasksForExecution.pop();
+		return Entry;
+	};
+
+	// Order: Once tasks queued before Tick, then Tick tasks, then Once tasks queued during Tick
+	TaskTracer::Record(TraceEventType::TickPhaseBegin, "Once tasks");
+	ExecuteTasksDeterministic(TakeOnceTask, GetMaxOnceTasksPerIteration(), 0.0f, "Once task", RandomRef);
+	TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+	OnceTasksSpaceCondition.notify_all();
+
+	// Batch tasks are split by the limit rather than by the running threads, so that the chunks depend only on the configuration
+	const unsigned int NumOfSimulatedThreads = GetMaxNumOfThreads();
+
+	std::unique_lock<std::mutex> LockTickTasks(TickTasksMutex);
+	ApplyTickTaskChanges();
+
+	const size_t NumOfPhases = SelectTickTasks(DeltaTime, FrameIndex.load(std::memory_order_relaxed));
+	LockTickTasks.unlock();
+
+	// Phases are executed in sequence, as in Tick with threads
+	for (size_t Phase = 0; Phase < NumOfPhases; Phase++)
+	{
+		if (!PushTickPhase(Phase, NumOfSimulatedThreads))
+		{
+			continue;
+		}
+
+		TaskTracer::Record(TraceEventType::TickPhaseBegin, "Tick tasks");
+		ExecuteTasksDeterministic(TakeTickEntry, GetMaxTickTasksPerIteration(), DeltaTime, "Tick task", RandomRef);
+		TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+	}
+
+	TaskTracer::Record(TraceEventType::TickPhaseBegin, "Once tasks");
+	ExecuteTasksDeterministic(TakeOnceTask, GetMaxOnceTasksPerIteration(), 0.0f, "Once task", RandomRef);
+	TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+	OnceTasksSpaceCondition.notify_all();
+
+	DispatchCallbacksInTick();
+	AdvanceFrame();
+
+	TaskTracer::Record(TraceEventType::TickEnd, nullptr);
+}
+
+void MultithreadingManager::ExecuteTasksDeterministic(const std::function<ThreadTask*()>& TakeTask, unsigned int MaxTasksPerIteration, float DeltaTime, const char* DefaultTaskName, std::mt19937* Random)
+{
+	if (MaxTasksPerIteration == 0)
+	{
+		MaxTasksPerIteration = 1;
+	}
+
+	// Portions of tasks taken by each simulated thread
+	std::vector<std::queue<ThreadTask*>> SimulatedThreads(Random != nullptr ? GetMaxNumOfThreads() : 1);
+
+	while (true)
+	{
+		// Choose the simulated thread that executes the next task
+		size_t ThreadIndex = 0;
+		if (Random != nullptr)
+		{
+			ThreadIndex = std::uniform_int_distribution<size_t>(0, SimulatedThreads.size() - 1)(*Random);
+		}
+
+		std::queue<ThreadTask*>& ThreadTasks = SimulatedThreads[ThreadIndex];
+
+		// The thread takes a new portion of tasks when it has completed the previous one
+		if (ThreadTasks.empty())
+		{
+			while (ThreadTasks.size() < MaxTasksPerIteration)
+			{
+				ThreadTask* Task = TakeTask();
+				if (Task == nullptr)
+				{
+					break;
+				}
+				ThreadTasks.push(Task);
+			}
+		}
+
+		if (ThreadTasks.empty())
+		{
+			// The queue is empty, finish when no simulated thread has tasks left
+			bool bAllThreadsCompleted = true;
+			for (size_t i = 0; i < SimulatedThreads.size(); i++)
+			{
+				if (!SimulatedThreads[i].empty())
+				{
+					bAllThreadsCompleted = false;
+					break;
+				}
+			}
+
+			if (bAllThreadsCompleted)
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		ThreadTask* Task = ThreadTasks.front();
+		ThreadTasks.pop();
+
+		// Cancelled tasks are skipped without execution
+		if (!Task->IsCancelled())
+		{
+			const char* TaskName = Task->GetName();
+			TaskTracer::Record(TraceEventType::TaskBegin, TaskName != nullptr ? TaskName : DefaultTaskName);
+			if (!AdvancedThread::ExecuteTask(Task, Task->GetTickDeltaTime(DeltaTime)))
+			{
+				NumOfTaskExceptions.fetch_add(1, std::memory_order_relaxed);
+			}
+			TaskTracer::Record(TraceEventType::TaskEnd, nullptr);
+		}
+
+		if (Task->GetRepeatability() == TaskRepeatability::Once)
+		{
+			delete Task;
+		}
+	}
+}
+
+void MultithreadingManager::RecordTickDuration(float Duration)
+{
+	std::unique_lock<std::mutex> Lock(MaxTickDurationMutex);
+	if (Duration > MaxTickDuration)
+	{
+		MaxTickDuration = Duration;
+	}
+}
+
+float MultithreadingManager::ConsumeMaxTickDuration()
+{
+	std::unique_lock<std::mutex> Lock(MaxTickDurationMutex);
+	float Duration = MaxTickDuration;
+	MaxTickDuration = 0.0f;
+	return Duration;
+}
+
+void MultithreadingManager::DispatchCallbacksInTick()
+{
+	std::unique_lock<std::mutex> Lock(DispatchCallbacksInTickMutex);
+	const bool bNeedToDispatch = bDispatchCallbacksInTick;
+	const unsigned int MaxNumOfCallbacks = MaxCallbacksPerTick;
+	Lock.unlock();
+
+	if (!bNeedToDispatch || DeferredCallbacks.IsEmpty())
+	{
+		return;
+	}
+
+	TaskTracer::Record(TraceEventType::TickPhaseBegin, "Callbacks");
+	DeferredCallbacks.Dispatch(MaxNumOfCallbacks);
+	TaskTracer::Record(TraceEventType::TickPhaseEnd, nullptr);
+}
+
+void MultithreadingManager::AdvanceFrame()
+{
+	std::unique_lock<std::mutex> Lock(FrameArenasMutex);
+	CurrentFrameArena = 1 - CurrentFrameArena;
+	FrameArenas[CurrentFrameArena].Reset();
+	Lock.unlock();
+
+	// Tasks and callbacks executed by the calling thread used its own scratch arena, in deterministic and threaded Ticks alike
+	AdvancedThread::ResetCallerScratchArena();
+
+	FrameIndex.fetch_add(1, std::memory_order_release);
+}
+
+bool MultithreadingManager::AddOnceTask(ThreadTask* Task, QueueOverflowMode Overflow, unsigned int Timeout)
 {
+	ThreadTask* DroppedTask = nullptr;
+
 	std::unique_lock<std::mutex> Lock(OnceTasksMutex);
-	OnceTasks.push(Task);
+	auto HasSpace = [this]() { return OnceTasksCapacity == 0 || OnceTasks.GetNumOfUserTasks() < OnceTasksCapacity; };
+
+	// Tasks of TaskGroup, Pipeline and ParallelAlgorithms do not take space, losing them would leave their owners waiting
+	if (!Task->IsInternal() && !HasSpace())
+	{
+		switch (Overflow)
+		{
+		case QueueOverflowMode::Block:
+			// Only Tick makes space in deterministic execution, waiting without a limit could block the thread that calls it
+			if (Timeout == WaitForSpaceForever && GetDeterministicExecution())
+			{
+				break;
+			}
+
+			NumOfBlockedSubmissions.fetch_add(1, std::memory_order_relaxed);
+
+			// If every standard thread waited for space, nobody would make it, so a standard thread executes queued tasks itself
+			if (AdvancedThread::IsServingQueue(&OnceTasks) && !GetDeterministicExecution())
+			{
+				while (!HasSpace())
+				{
+					Lock.unlock();
+					ExecuteOnceTask();
+					Lock.lock();
+				}
+			}
+			else if (Timeout == WaitForSpaceForever)
+			{
+				OnceTasksSpaceCondition.wait(Lock, HasSpace);
+			}
+			else if (!OnceTasksSpaceCondition.wait_for(Lock, std::chrono::milliseconds(Timeout), HasSpace))
+			{
+				return false;
+			}
+			break;
+
+		case QueueOverflowMode::DropOldest:
+			// The queue is full of user tasks, so there is always one to drop, internal tasks in front of it are kept
+			DroppedTask = OnceTasks.PopOldestUserTask();
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	Task->SetEnqueueTime(GetStatisticsTime());
+	OnceTasks.Push(Task);
+	if (OnceTasks.Size() > OnceTasksPeakSize)
+	{
+		OnceTasksPeakSize = OnceTasks.Size();
+	}
+	Lock.unlock();
+
+	// The dropped task is deleted without execution, which completes its handles
+	if (DroppedTask != nullptr)
+	{
+		NumOfDroppedTasks.fetch_add(1, std::memory_order_relaxed);
+		delete DroppedTask;
+	}
+
+	return true;
 }
 
 void MultithreadingManager::AddTickTask(ThreadTask* Task)
 {
-	std::unique_lock<std::mutex> Lock(TickTasksMutex);
-	TickTasks.push_back(Task);
+	TickTaskChange* Change = new TickTaskChange();
+	Change->bAdd = true;
+	Change->Task = Task;
+	PendingTickTaskChanges.Push(Change);
 }
 
-void MultithreadingManager::RemoveTickTask(ThreadTask* Task)
+void MultithreadingManager::RemoveTickTask(const TaskHandle& Handle)
 {
-	if (Task == nullptr)
+	if (!Handle.IsValid())
 	{
 		return;
 	}
 
-	std::unique_lock<std::mutex> Lock(TickTasksMutex);
-	for (size_t i = 0; i < TickTasks.size(); i++)
+	// The task is found by its handle when the change is applied, so it can be removed before its addition is applied
+	TickTaskChange* Change = new TickTaskChange();
+	Change->Handle = Handle;
+	PendingTickTaskChanges.Push(Change);
+}
+
+void MultithreadingManager::ApplyTickTaskChanges()
+{
+	if (PendingTickTaskChanges.IsEmpty())
 	{
-		if (Task == TickTasks[i])
+		return;
+	}
+
+	TickTaskChange* Change = PendingTickTaskChanges.TakeAll();
+	while (Change != nullptr)
+	{
+		if (Change->bAdd)
 		{
-			delete TickTasks[i];
-			TickTasks.erase(TickTasks.begin() + i);
-			return;
+			Change->Task->SetTickTaskId(TickTasks.Add(Change->Task));
+			TickTasksSchedule.Add(Change->Task);
 		}
+		else
+		{
+			ThreadTask* RemovedTask = TickTasks.Remove(Change->Handle.GetTickTaskId());
+			if (RemovedTask != nullptr)
+			{
+				TickTasksSchedule.Remove(RemovedTask);
+				delete RemovedTask;
+			}
+		}
+
+		TickTaskChange* Next = Change->Next;
+		delete Change;
+		Change = Next;
 	}
 }
 
 void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSignal)
 {
+	bool bWokenUp = false;
+
 	while (true)
 	{
 		bool bManagerCanFinishWork = true;
@@ -550,8 +1666,54 @@ void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSi
 				DedicatedWorkers.erase(DedicatedWorkers.begin() + i);
 			}
 		}
+
+		// Pooled dedicated threads: return to the idle pool those that have completed their task, stop the surplus
+		for (size_t i = 0; i < DedicatedWorkers.size();)
+		{
+			if (!DedicatedWorkers[i]->IsAwaitingDedicatedTask())
+			{
+				i++;
+				continue;
+			}
+
+			std::lock_guard<std::mutex> LockIdleDedicatedWorkers(IdleDedicatedWorkersMutex);
+			if (IdleDedicatedWorkers.size() < GetMaxNumOfIdleDedicatedThreads() && !StopSignal.GetState())
+			{
+				IdleDedicatedWorkers.push_back(DedicatedWorkers[i]);
+			}
+			else
+			{
+				DedicatedWorkers[i]->Stop();
+
+				std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+				PendingStopWorkers.push_back(DedicatedWorkers[i]);
+			}
+			DedicatedWorkers.erase(DedicatedWorkers.begin() + i);
+		}
 		LockDedicatedWorkers.unlock();
 
+		// Idle pooled dedicated threads: keep the minimum number of them warm, stop them all when the manager stops
+		std::unique_lock<std::mutex> LockIdleDedicatedWorkers(IdleDedicatedWorkersMutex);
+		if (!StopSignal.GetState())
+		{
+			while (IdleDedicatedWorkers.size() < GetMinNumOfIdleDedicatedThreads())
+			{
+				IdleDedicatedWorkers.push_back(StartDedicatedPoolThread());
+			}
+		}
+		else
+		{
+			while (!IdleDedicatedWorkers.empty())
+			{
+				IdleDedicatedWorkers.back()->Stop();
+
+				std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+				PendingStopWorkers.push_back(IdleDedicatedWorkers.back());
+				IdleDedicatedWorkers.pop_back();
+			}
+		}
+		LockIdleDedicatedWorkers.unlock();
+
 		// Standard threads: move to the list of pending stop those that have completed their work
 		bool bNeedToUpdateNumOfThreads = false;
 		std::unique_lock<std::mutex> LockStandardWorkers(StandardWorkersMutex);
@@ -572,6 +1734,33 @@ void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSi
 			UpdateNumOfThreads();
 		}
 
+		// Parked threads: move to the list of pending stop those that have completed their work
+		std::unique_lock<std::mutex> LockParkedWorkers(ParkedWorkersMutex);
+		for (size_t i = 0; i < ParkedWorkers.size();)
+		{
+			if (ParkedWorkers[i]->GetState() == ThreadState::Stopped || ParkedWorkers[i]->GetState() == ThreadState::NotReadyToStart)
+			{
+				std::lock_guard<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
+				PendingStopWorkers.push_back(ParkedWorkers[i]);
+
+				ParkedWorkers.erase(ParkedWorkers.begin() + i);
+				continue;
+			}
+			i++;
+		}
+		LockParkedWorkers.unlock();
+
+		if (!StopSignal.GetState())
+		{
+			UpdateCompensatingThreads();
+
+			// A wake up for blocked threads does not count as a load sample
+			if (!bWokenUp)
+			{
+				UpdateAutoscaler();
+			}
+		}
+
 		// Pending stop threads: move to the list of stopped threads or destroy those that have completed work
 		std::unique_lock<std::mutex> LockPendingStopWorkers(PendingStopWorkersMutex);
 		for (size_t i = 0; i < PendingStopWorkers.size(); i++)
@@ -612,7 +1801,7 @@ void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSi
 
 
 		// If there are still running, stopping, or stopped threads, then shutting down the manager is unacceptable
-		if (GetNumOfThreads() != 0 || GetNumOfDedicatedThreads() != 0 || GetNumOfPendingStopThreads() != 0 || GetNumOfStoppedThreads() != 0)
+		if (GetNumOfThreads() != 0 || GetNumOfParkedThreads() != 0 || GetNumOfDedicatedThreads() != 0 || GetNumOfIdleDedicatedThreads() != 0 || GetNumOfPendingStopThreads() != 0 || GetNumOfStoppedThreads() != 0)
 		{
 			bManagerCanFinishWork = false;
 		}
@@ -624,7 +1813,16 @@ void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSi
 
 		if (!StopSignal.GetState())
 		{
-			std::this_thread::sleep_for(std::chrono::seconds(1));
+			// While the autoscaler is enabled, the load is sampled more often
+			const AutoscalerPolicy Policy = GetAutoscalerPolicy();
+			if (Policy.bEnabled && Policy.SampleInterval < 1000)
+			{
+				bWokenUp = WaitForManagerWakeUp(std::chrono::milliseconds(Policy.SampleInterval));
+			}
+			else
+			{
+				bWokenUp = WaitForManagerWakeUp(std::chrono::seconds(1));
+			}
 		}
 		else
 		{
@@ -633,6 +1831,44 @@ void MultithreadingManager::ThreadsManagerExecution(const TaskStopSignal& StopSi
 	}
 }
 
+void MultithreadingManager::UpdateCompensatingThreads()
+{
+	// Threads stopped by the user are not started again
+	if (GetNumOfThreads() == 0)
+	{
+		NumOfCompensatingThreads = 0;
+		return;
+	}
+
+	const unsigned int NumOfBlocked = NumOfBlockedThreads.load();
+
+	while (NumOfCompensatingThreads < NumOfBlocked)
+	{
+		const unsigned int NumOfRunningThreads = GetNumOfThreads();
+		StartNewThread();
+		if (GetNumOfThreads() == NumOfRunningThreads)
+		{
+			break;
+		}
+		NumOfCompensatingThreads++;
+	}
+
+	// The surplus thread is parked rather than stopped, so a Tick in progress still gets its report and the thread is ready for the next compensation
+	while (NumOfCompensatingThreads > NumOfBlocked)
+	{
+		ParkOneThread();
+		NumOfCompensatingThreads--;
+	}
+}
+
+bool MultithreadingManager::WaitForManagerWakeUp(std::chrono::milliseconds Duration)
+{
+	std::unique_lock<std::mutex> Lock(ManagerWakeUpMutex);
+	const bool bWokenUp = ManagerWakeUpCondition.wait_for(Lock, Duration, [this]() { return bManagerWakeUpRequested; });
+	bManagerWakeUpRequested = false;
+	return bWokenUp;
+}
+
 unsigned int MultithreadingManager::GetNumOfPendingStopThreads()
 {
 	std::unique_lock<std::mutex> Lock(PendingStopWorkersMutex);
@@ -643,4 +1879,96 @@ unsigned int MultithreadingManager::GetNumOfStoppedThreads()
 {
 	std::unique_lock<std::mutex> Lock(StoppedWorkersMutex);
 	return StoppedWorkers.size();
+}
+
+void MultithreadingManager::UpdateAutoscaler()
+{
+	const AutoscalerPolicy Policy = GetAutoscalerPolicy();
+
+	const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+	const float SampleDuration = std::chrono::duration<float>(Now - LastAutoscalerSampleTime).count();
+	LastAutoscalerSampleTime = Now;
+
+	// The counters are consumed even while the autoscaler is disabled, so that the first sample after enabling it is not distorted
+	unsigned long long BusyTime = 0;
+	std::unique_lock<std::mutex> LockStandardWorkers(StandardWorkersMutex);
+	const unsigned int NumOfRunningThreads = StandardWorkers.size();
+	for (size_t i = 0; i < StandardWorkers.size(); i++)
+	{
+		BusyTime += StandardWorkers[i]->ConsumeBusyTime();
+	}
+	LockStandardWorkers.unlock();
+
+	const float LastMaxTickDuration = ConsumeMaxTickDuration();
+
+	if (!Policy.bEnabled || SampleDuration <= 0.0f)
+	{
+		NumOfHighLoadSamples = 0;
+		NumOfLowLoadSamples = 0;
+		return;
+	}
+
+	// Threads stopped by the user are not started again
+	const unsigned int NumOfParkedThreads = GetNumOfParkedThreads();
+	if (NumOfRunningThreads == 0 && NumOfParkedThreads == 0)
+	{
+		return;
+	}
+
+	const unsigned int MaxThreads = GetMaxNumOfThreads();
+	const unsigned int MinThreads = Policy.MinNumOfThreads < MaxThreads ? Policy.MinNumOfThreads : MaxThreads;
+
+	const unsigned int NumOfQueuedTasks = GetNumOfOnceTasks();
+	float Utilization = 1.0f;
+	if (NumOfRunningThreads != 0)
+	{
+		Utilization = static_cast<float>(BusyTime) / 1e9f / (SampleDuration * NumOfRunningThreads);
+	}
+
+	const bool bHighLoad =
+		NumOfQueuedTasks > Policy.GrowQueueDepthPerThread * NumOfRunningThreads ||
+		(NumOfRunningThreads != 0 && Utilization > Policy.GrowUtilization) ||
+		(Policy.TickDurationBudget > 0.0f && LastMaxTickDuration > Policy.TickDurationBudget);
+
+	const bool bLowLoad = 
+		NumOfQueuedTasks == 0 && 
+		Utilization < Policy.ShrinkUtilization &&
+		(Policy.TickDurationBudget <= 0.0f || LastMaxTickDuration < Policy.TickDurationBudget);
+
+	// Hysteresis: the load must stay high or low for several consecutive samples
+	if (bHighLoad)
+	{
+		NumOfHighLoadSamples++;
+		NumOfLowLoadSamples = 0;
+	}
+	else if (bLowLoad)
+	{
+		NumOfLowLoadSamples++;
+		NumOfHighLoadSamples = 0;
+	}
+	else
+	{
+		NumOfHighLoadSamples = 0;
+		NumOfLowLoadSamples = 0;
+	}
+
+	const unsigned int TimeSinceLastResize = std::chrono::duration_cast<std::chrono::milliseconds>(Now - LastAutoscalerResizeTime).count();
+
+	if (NumOfRunningThreads < MinThreads ||
+		(NumOfHighLoadSamples >= Policy.NumOfSamplesToGrow && TimeSinceLastResize >= Policy.GrowCooldown && NumOfRunningThreads < MaxThreads))
+	{
+		StartNewThread();
+
+		LastAutoscalerResizeTime = Now;
+		NumOfHighLoadSamples = 0;
+		return;
+	}
+
+	if (NumOfLowLoadSamples >= Policy.NumOfSamplesToShrink && TimeSinceLastResize >= Policy.ShrinkCooldown && NumOfRunningThreads > MinThreads)
+	{
+		ParkOneThread();
+
+		LastAutoscalerResizeTime = Now;
+		NumOfLowLoadSamples = 0;
+	}
 }
\ No newline at end of file
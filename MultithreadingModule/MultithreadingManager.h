@@ -1,8 +1,21 @@
 #pragma once
 #include <vector>
 #include <queue>
+#include <chrono>
+#include <condition_variable>
+#include <random>
 #include "AdvancedThread.h"
+#include "AutoscalerPolicy.h"
+#include "ChunkingPolicy.h"
+#include "MultithreadingPoolConfig.h"
+#include "MultithreadingStatistics.h"
+#include "OnceTaskQueue.h"
 #include "ThreadTask.h"
+#include "TickTaskRegistry.h"
+#include "TickTaskChangeBuffer.h"
+#include "TickSchedule.h"
+#include "CallbackQueue.h"
+#include "LinearArena.h"
 #include "ThreadMethodTask.h"
 
 class MultithreadingModule;
@@ -10,6 +23,9 @@ class MultithreadingModule;
 class MultithreadingManager final
 {
 private:
+	// Name of the pool, it does not change
+	const std::string Name;
+
 	// Handler thread that helps in managing threads
 	AdvancedThread* ThreadsManager;
 
@@ -22,14 +38,59 @@ private:
 	unsigned int NumOfThreads;
 	std::mutex NumOfThreadsMutex;
 
-	static unsigned int MaxNumOfThreads;
-	static std::mutex MaxNumOfThreadsMutex;
+	unsigned int MaxNumOfThreads;
+	std::mutex MaxNumOfThreadsMutex;
+
+	unsigned int MaxTickTasksPerIteration;
+	std::mutex MaxTickTasksPerIterationMutex;
+
+	unsigned int MaxOnceTasksPerIteration;
+	std::mutex MaxOnceTasksPerIterationMutex;
+
+	ChunkingPolicy Chunking;
+	std::mutex ChunkingMutex;
+
+	// Passed to the threads by pointer, so that the hooks can be replaced while they are running
+	WorkerLifecycleHooks LifecycleHooks;
+	std::mutex LifecycleHooksMutex;
+
+	// Standard threads parked by the autoscaler, they are woken up instead of starting new ones
+	std::vector<AdvancedThread*> ParkedWorkers;
+	std::mutex ParkedWorkersMutex;
+
+	AutoscalerPolicy Autoscaler;
+	std::mutex AutoscalerMutex;
+
+	// Autoscaler state, only used by the Threads Manager
+	unsigned int NumOfHighLoadSamples;
+	unsigned int NumOfLowLoadSamples;
+	std::chrono::steady_clock::time_point LastAutoscalerSampleTime;
+	std::chrono::steady_clock::time_point LastAutoscalerResizeTime;
+
+	// Longest Tick since the last autoscaler sample, in seconds
+	float MaxTickDuration;
+	std::mutex MaxTickDurationMutex;
 
 
 	// Dedicated threads for dedicated tasks
 	std::vector<AdvancedThread*> DedicatedWorkers;
 	std::mutex DedicatedWorkersMutex;
 
+	// Warm pooled dedicated threads waiting for a dedicated task
+	std::vector<AdvancedThread*> IdleDedicatedWorkers;
+	std::mutex IdleDedicatedWorkersMutex;
+
+	unsigned int MinNumOfIdleDedicatedThreads;
+	std::mutex MinNumOfIdleDedicatedThreadsMutex;
+
+	unsigned int MaxNumOfIdleDedicatedThreads;
+	std::mutex MaxNumOfIdleDedicatedThreadsMutex;
+
+	// Number of dedicated tasks that got an idle pooled thread (hits) or required a new system thread (misses)
+	unsigned long long NumOfDedicatedPoolHits;
+	unsigned long long NumOfDedicatedPoolMisses;
+	std::mutex DedicatedPoolStatisticsMutex;
+
 
 	// Threads that terminate and require further processing
 	std::vector<AdvancedThread*> PendingStopWorkers;
@@ -39,22 +100,63 @@ private:
 	std::vector<AdvancedThread*> StoppedWorkers;
 	std::mutex StoppedWorkersMutex;
 
-	static unsigned int MaxNumOfStoppedThreads;
-	static std::mutex MaxNumOfStoppedThreadsMutex;
+	unsigned int MaxNumOfStoppedThreads;
+	std::mutex MaxNumOfStoppedThreadsMutex;
 
 
 	
 
 
-	std::queue<ThreadTask*> OnceTasks;
+	OnceTaskQueue OnceTasks;
 	std::mutex OnceTasksMutex;
 
+	// The limits of the Once queue and its peak size are protected by OnceTasksMutex
+	// The capacity limits only the user tasks, 0 - unlimited
+	unsigned int OnceTasksCapacity;
+	QueueOverflowMode OnceTasksOverflow;
+	unsigned int OnceTasksPeakSize;
+	// Notified when tasks are taken from the Once queue, waited on by additions to a full queue
+	std::condition_variable OnceTasksSpaceCondition;
+
+	std::atomic<unsigned long long> NumOfBlockedSubmissions;
+	std::atomic<unsigned long long> NumOfRejectedTasks;
+	std::atomic<unsigned long long> NumOfDroppedTasks;
+
 	std::queue<ThreadTask*> TickTasksForExecution;
 	std::mutex TickTasksForExecutionMutex;
 
-	std::vector<ThreadTask*> TickTasks;
+	// Tick tasks in a slot map, so that they can be added and removed in O(1)
+	TickTaskRegistry TickTasks;
 	std::mutex TickTasksMutex;
 
+	// Phases of the Tick tasks by their declared resources, protected by TickTasksMutex
+	TickSchedule TickTasksSchedule;
+
+	// Tick tasks executed during the current Tick, by phases, only used by the thread that calls Tick
+	std::vector<std::vector<ThreadTask*>> TickPhaseTasks;
+	// Number of phases of the last Tick, read by the statistics
+	std::atomic<unsigned int> NumOfTickPhases;
+	std::atomic<unsigned long long> NumOfTickScheduleBuilds;
+
+	// Additions and removals of Tick tasks, applied at the start of the next Tick
+	// They do not take TickTasksMutex, so registration never waits for Tick
+	TickTaskChangeBuffer PendingTickTaskChanges;
+
+	// Callbacks of the tasks with deferred routing
+	CallbackQueue DeferredCallbacks;
+
+	bool bDispatchCallbacksInTick;
+	unsigned int MaxCallbacksPerTick;
+	std::mutex DispatchCallbacksInTickMutex;
+
+	// Number of completed Ticks, the threads reset their scratch arenas when it changes
+	std::atomic<unsigned long long> FrameIndex;
+
+	// Two frame arenas take turns, so the memory allocated during a Tick is still valid during the next one
+	LinearArena FrameArenas[2];
+	unsigned int CurrentFrameArena;
+	std::mutex FrameArenasMutex;
+
 
 	float DeltaTime;
 	std::mutex DeltaTimeMutex;
@@ -63,13 +165,51 @@ private:
 	std::mutex ThreadCompletedTickTasksMutex;
 	std::condition_variable ThreadCompletedTickTasksCondition;
 
+
+	// Deterministic execution: standard threads are not used, Tick executes all tasks on the calling thread
+	static bool bDeterministicExecution;
+	static unsigned int DeterministicExecutionSeed;
+	static std::mutex DeterministicExecutionMutex;
+
+	// Number of deterministic Ticks, it is mixed into the seed so that each Tick gets its own interleaving
+	unsigned long long NumOfDeterministicTicks;
+
+
+	// Number of exceptions thrown by the tasks of the pool, counted by its threads
+	std::atomic<unsigned long long> NumOfTaskExceptions;
+
+	// Number of standard threads whose tasks are in a blocking section, each of them is compensated by an additional thread
+	std::atomic<unsigned int> NumOfBlockedThreads;
+	// Number of threads started to compensate for blocked ones, only used by the Threads Manager
+	unsigned int NumOfCompensatingThreads;
+
+	// Wakes up the Threads Manager before its sleep interval ends
+	bool bManagerWakeUpRequested;
+	std::mutex ManagerWakeUpMutex;
+	std::condition_variable ManagerWakeUpCondition;
+
+	// Tick statistics, recorded only by the thread that calls Tick
+	std::atomic<unsigned long long> NumOfTicks;
+	LatencyHistogram TickForkTime;
+	LatencyHistogram TickJoinTime;
+
 	
 private:
-	MultithreadingManager();
+	MultithreadingManager(const MultithreadingPoolConfig& Config);
 	~MultithreadingManager();
 
 	friend MultithreadingModule;
 public:
+	// Returns the name of the pool
+	const std::string& GetName() const;
+
+	// Applies the limits and the autoscaler policy of the configuration, the name is not changed
+	// @param NewConfig - Updated configuration
+	void SetConfig(const MultithreadingPoolConfig& NewConfig);
+	// Returns the current configuration of the pool
+	MultithreadingPoolConfig GetConfig();
+
+
 	// Standard threads
 
 	// Causes threads to perform Tick tasks and waits until they are completed
@@ -96,24 +236,140 @@ public:
 	// Returns the number of running standard threads
 	unsigned int GetNumOfThreads();
 
+	// Returns the number of standard threads parked by the autoscaler
+	unsigned int GetNumOfParkedThreads();
+
+	// Returns the number of standard threads whose tasks are blocking
+	unsigned int GetNumOfBlockedThreads();
+
+	// Returns the statistics of the running and parked standard threads and of Tick
+	MultithreadingStatistics GetStatistics();
+	// Clears the statistics of the standard threads and of Tick
+	void ResetStatistics();
+
+	// Sets the policy by which the number of running standard threads follows the load
+	// @param NewPolicy - Updated policy
+	void SetAutoscalerPolicy(const AutoscalerPolicy& NewPolicy);
+	// Returns the policy by which the number of running standard threads follows the load
+	AutoscalerPolicy GetAutoscalerPolicy();
+
+	// Sets the policy by which the threads choose how many queued tasks to take in one iteration
+	// @param NewPolicy - Updated policy
+	void SetChunkingPolicy(const ChunkingPolicy& NewPolicy);
+	// Returns the policy by which the threads choose how many queued tasks to take in one iteration
+	ChunkingPolicy GetChunkingPolicy();
+
 	// Sets the maximum number of simultaneously working standard threads
 	// @param NewMax - Updated limit
-	static void SetMaxNumOfThreads(unsigned int NewMax);
+	void SetMaxNumOfThreads(unsigned int NewMax);
 	// Returns the maximum number of simultaneously working standard threads
-	static unsigned int GetMaxNumOfThreads();
+	unsigned int GetMaxNumOfThreads();
 
 	// Sets the maximum number of saved stopped standard threads
 	// @param NewMax - Updated limit
-	static void SetMaxNumOfStoppedThreads(unsigned int NewMax);
+	void SetMaxNumOfStoppedThreads(unsigned int NewMax);
 	// Returns the maximum number of stored standard threads
-	static unsigned int GetMaxNumOfStoppedThreads();
+	unsigned int GetMaxNumOfStoppedThreads();
+
+	// Sets the maximum number of Tick tasks to be executed in one iteration
+	// @param NewMax - Updated limit
+	void SetMaxTickTasksPerIteration(unsigned int NewMax);
+	// Returns the maximum number of Tick tasks that a thread executes in one iteration
+	unsigned int GetMaxTickTasksPerIteration();
+
+	// Sets the maximum number of Once tasks to be executed in one iteration
+	// @param NewMax - Updated limit
+	void SetMaxOnceTasksPerIteration(unsigned int NewMax);
+	// Returns the maximum number of Once tasks that a thread executes in one iteration
+	unsigned int GetMaxOnceTasksPerIteration();
+
+	// Limits the number of queued Once tasks, so that producers faster than the threads do not grow the queue without limit
+	// Tick and dedicated tasks are not limited
+	// Tasks of TaskGroup, Pipeline and ParallelAlgorithms do not count against the capacity and are never dropped
+	// @param NewCapacity - maximum number of queued Once tasks, 0 - unlimited
+	// @param NewOverflow - what AddTask does when the queue is full
+	// In deterministic execution only Tick takes tasks from the queue, there Block adds the task over the capacity
+	void SetOnceQueueCapacity(unsigned int NewCapacity, QueueOverflowMode NewOverflow);
+	// Returns the maximum number of queued Once tasks, 0 - unlimited
+	unsigned int GetOnceQueueCapacity();
+	// Returns what AddTask does when the Once queue is full
+	QueueOverflowMode GetOnceQueueOverflow();
+
+	// Sets the hooks called on each standard and dedicated thread of the pool when it starts and stops
+	// Threads that are already running call the new hooks when they stop and on their next start
+	// @param NewHooks - Updated hooks
+	void SetWorkerHooks(const WorkerLifecycleHooks& NewHooks);
+	// Returns the hooks called on each thread of the pool when it starts and stops
+	WorkerLifecycleHooks GetWorkerHooks();
+
+	// Sets the function that receives every exception thrown by a task of any pool, on the thread that executed the task
+	// A task exception does not stop the thread, it is also passed to the task handles and counted in the statistics
+	// @param NewSink - the function, an empty function disables the sink
+	static void SetTaskErrorSink(const TaskErrorSink& NewSink);
+
+	// Enables or disables deterministic execution for all pools
+	// In deterministic mode standard threads are not started, and Tick executes all Once and Tick tasks on the calling thread in a defined order
+	// It is also enabled by the MULTITHREADING_DETERMINISTIC_SEED environment variable, which holds the seed
+	// Must be set while no standard thread is running
+	// @param bNewState - new state value
+	// @param Seed - 0 executes tasks in queue order, otherwise tasks are interleaved as if taken by the maximum number of standard threads, 
+	// in an order derived from the seed
+	static void SetDeterministicExecution(bool bNewState, unsigned int Seed);
+	// Returns true if deterministic execution is enabled
+	static bool GetDeterministicExecution();
+	// Returns the seed of deterministic execution
+	static unsigned int GetDeterministicExecutionSeed();
 
 	// Adds a task to execute
 	// @param Task - Task to add
 	void AddTask(ThreadTask* Task);
+	// Adds a task to execute and returns its handle
+	// Only tasks with a handle allocate the state that the handle follows, so AddTask is cheaper when the handle is not needed
+	// @param Task - Task to add
+	// @return handle that follows the completion of the task and cancels it
+	TaskHandle AddTaskWithHandle(ThreadTask* Task);
+	// Adds a task to execute if there is space for it in the Once queue
+	// @param Task - Task to add
+	// @param Timeout - maximum time in milliseconds to wait for space, 0 - do not wait
+	// @return false if the queue stayed full, the task is not added and still belongs to the caller
+	bool TryAddTask(ThreadTask* Task, unsigned int Timeout);
+	// Adds a Once task of TaskGroup, Pipeline or ParallelAlgorithms without counting it against the capacity of the queue
+	// The overflow mode does not apply to it, so it is never blocked, rejected or dropped
+	// @param Task - Task to add
+	void AddInternalTask(ThreadTask* Task);
 	// Removes Tick task from execution
+	// Tick tasks are added and removed at the start of the next Tick, the removed task is deleted there
+	// Once tasks are cancelled through the handle returned by AddTaskWithHandle or through a CancellationToken
 	// @param Task - Task for removal
 	void RemoveTask(ThreadTask* Task);
+	// Removes Tick task from execution in O(1)
+	// Does nothing if the task has already been removed
+	// @param Handle - Handle returned by AddTaskWithHandle or ThreadTask::GetHandle
+	void RemoveTask(const TaskHandle& Handle);
+
+	// Executes the deferred callbacks of the tasks on the calling thread, in the order they were posted
+	// @param MaxNumOfCallbacks - maximum number of callbacks to execute, 0 - all
+	// @return number of executed callbacks
+	unsigned int DispatchCallbacks(unsigned int MaxNumOfCallbacks);
+
+	// Sets whether Tick dispatches the deferred callbacks after the Tick tasks
+	// @param bNewState - true to dispatch callbacks in Tick
+	// @param NewMaxNumOfCallbacks - maximum number of callbacks dispatched by one Tick, 0 - all
+	void SetDispatchCallbacksInTick(bool bNewState, unsigned int NewMaxNumOfCallbacks);
+	bool GetDispatchCallbacksInTick();
+	unsigned int GetMaxCallbacksPerTick();
+
+	// Allocates memory that tasks can hand to each other within a frame
+	// The memory is valid until the end of the Tick after the one during which it was allocated
+	// @param Size - size in bytes
+	// @param Alignment - alignment in bytes, a power of two
+	// @return the memory, or nullptr if Size is 0
+	void* AllocateFrameMemory(size_t Size, size_t Alignment);
+
+	// Takes one queued Once task and executes it on the calling thread
+	// Used by threads that wait for other tasks, so that they help instead of blocking
+	// @return false if there was no task or deterministic execution is enabled
+	bool ExecuteOnceTask();
 
 	// Removes all tasks from execution
 	void RemoveAllTasks();
@@ -133,6 +389,24 @@ public:
 	// Returns the states of dedicated threads
 	std::vector<ThreadState> GetDedicatedThreadsStates();
 
+	// Returns the number of pooled dedicated threads waiting for a task
+	unsigned int GetNumOfIdleDedicatedThreads();
+
+	// Sets the minimum number of pooled dedicated threads kept warm while waiting for a task
+	// @param NewMin - Updated limit
+	void SetMinNumOfIdleDedicatedThreads(unsigned int NewMin);
+	// Returns the minimum number of pooled dedicated threads kept warm while waiting for a task
+	unsigned int GetMinNumOfIdleDedicatedThreads();
+
+	// Sets the maximum number of pooled dedicated threads kept waiting for a task, the rest are stopped after completing their task
+	// @param NewMax - Updated limit
+	void SetMaxNumOfIdleDedicatedThreads(unsigned int NewMax);
+	// Returns the maximum number of pooled dedicated threads kept waiting for a task
+	unsigned int GetMaxNumOfIdleDedicatedThreads();
+
+	// Returns the share of dedicated tasks that were given to an already running pooled thread, from 0 to 1
+	float GetDedicatedThreadsPoolHitRate();
+
 private:
 	// Methods for standart threads
 
@@ -141,6 +415,15 @@ private:
 
 	void UpdateNumOfThreads();
 
+	// Maximum number of standard threads including those that compensate for blocked ones
+	unsigned int GetMaxNumOfRunningThreads();
+
+	// Counts a standard thread that starts or stops blocking and wakes up the Threads Manager to compensate for it
+	// Called by the blocked standard thread, which must not take the locks of the thread lists
+	// because the manager may be waiting for it to stop while holding them
+	// @param bBlocking - true if the task of the thread starts blocking
+	void UpdateBlockedThreads(bool bBlocking);
+
 	void StopOneThread();
 	void StopOneThreadWithWaiting();
 
@@ -148,10 +431,63 @@ private:
 
 	AdvancedThread* GetStoppedThread();
 
-	void AddOnceTask(ThreadTask* Task);
+	void ParkOneThread();
+	AdvancedThread* GetParkedThread();
+	void StopParkedThreads();
+	void StopParkedThreadsWithWaiting();
+
+	unsigned int GetNumOfOnceTasks();
+
+	// Executes all queued Once tasks and all Tick tasks on the calling thread
+	void TickDeterministic(float DeltaTime);
+	// Executes tasks from the queue until it is empty, simulating threads that take the given number of tasks per iteration
+	// @param TakeTask - removes the next task from the queue under its mutex, returns nullptr if the queue is empty
+	// @param Random - chooses the simulated thread that executes the next task, nullptr executes tasks in queue order
+	void ExecuteTasksDeterministic(const std::function<ThreadTask*()>& TakeTask, unsigned int MaxTasksPerIteration, float DeltaTime, 
+		const char* DefaultTaskName, std::mt19937* Random);
+
+	// Selects the Tick tasks executed during the current Tick into TickPhaseTasks
+	// Must be called with TickTasksMutex locked
+	// @param DeltaTime - Tick delta time
+	// @param TickIndex - number of the Tick
+	// @return number of phases
+	size_t SelectTickTasks(float DeltaTime, unsigned long long TickIndex);
+	// Puts the selected tasks of one phase into the execution queue
+	// @param Phase - index of the phase
+	// @param NumOfThreads - number of threads that share batch tasks
+	// @return false if the phase has no tasks
+	bool PushTickPhase(size_t Phase, unsigned int NumOfThreads);
+	// Tells the standard threads to execute the queued Tick tasks and waits until all of them complete
+	// @param TickStart - start of Tick, for the statistics of the first phase
+	// @param bFirstPhase - true if this is the first phase of Tick
+	void ExecuteTickPhase(const std::chrono::steady_clock::time_point& TickStart, bool bFirstPhase);
+
+	void RecordTickDuration(float Duration);
+	float ConsumeMaxTickDuration();
+
+	// Dispatches the deferred callbacks at the end of Tick, if enabled
+	void DispatchCallbacksInTick();
+
+	// Completes the frame at the end of Tick: resets the frame arena of the previous frame and the scratch arena of the calling thread,
+	// and lets the threads reset their scratch arenas
+	void AdvanceFrame();
+
+	static const unsigned int WaitForSpaceForever = 0xFFFFFFFF;
+
+	// Adds a task to the Once queue, taking its capacity into account
+	// @param Task - Task to add
+	// @param Overflow - what to do if the queue is full, Reject leaves the task to the caller
+	// A standard thread of the pool does not wait with Block, it executes queued tasks until there is space
+	// @param Timeout - maximum time in milliseconds to wait for space with Block, WaitForSpaceForever - no limit
+	// @return false if the task was not added
+	bool AddOnceTask(ThreadTask* Task, QueueOverflowMode Overflow, unsigned int Timeout);
 	void AddTickTask(ThreadTask* Task);
 
-	void RemoveTickTask(ThreadTask* Task);
+	void RemoveTickTask(const TaskHandle& Handle);
+
+	// Applies the pending additions and removals of Tick tasks
+	// Must be called with TickTasksMutex locked
+	void ApplyTickTaskChanges();
 
 private:
 	// Methods for dedicated threads
@@ -160,11 +496,31 @@ private:
 
 	unsigned int GetNumOfDedicatedThreads();
 
+	// Starts a new pooled dedicated thread, reusing a stopped thread if possible
+	AdvancedThread* StartDedicatedPoolThread();
+
+	// Takes a pooled dedicated thread that is waiting for a task, or returns nullptr
+	AdvancedThread* GetIdleDedicatedThread();
+
+	void UpdateDedicatedPoolStatistics(bool bHit);
+
 private:
 	// Methods for Threads Manager
 
 	void ThreadsManagerExecution(const TaskStopSignal& StopSignal);
 
+	// Takes a load sample and starts or parks a standard thread if the autoscaler policy requires it
+	void UpdateAutoscaler();
+
+	// Starts a thread for each blocked standard thread and parks those no longer needed
+	// Parked and stopped threads are reused before new ones are created
+	void UpdateCompensatingThreads();
+
+	// Suspends the Threads Manager until the time passes or it is woken up
+	// @param Duration - the time to sleep
+	// @return true if the manager was woken up
+	bool WaitForManagerWakeUp(std::chrono::milliseconds Duration);
+
 	unsigned int GetNumOfPendingStopThreads();
 
 	unsigned int GetNumOfStoppedThreads();
@@ -1,52 +1,75 @@
 ﻿#include "MultithreadingModule.h"
 
-unsigned int MultithreadingModule::MultithreadingManagerRefCounter = 0;
-std::mutex MultithreadingModule::MultithreadingManagerRefCounterMutex;
+std::map<std::string, MultithreadingModule::PoolReference> MultithreadingModule::Pools;
+MultithreadingPoolConfig MultithreadingModule::DefaultPoolConfig;
+std::mutex MultithreadingModule::PoolsMutex;
 
-MultithreadingManager* MultithreadingModule::MultithreadingManagerRef = nullptr;
-std::mutex MultithreadingModule::MultithreadingManagerRefMutex;
+void MultithreadingModule::AcquirePool(const MultithreadingPoolConfig& Config)
+{
+	PoolReference& Pool = Pools[Config.Name];
+	if (Pool.Manager == nullptr)
+	{
+		Pool.Manager = new MultithreadingManager(Config);
+	}
+
+	Pool.RefCounter++;
+	MultithreadingManagerRef = Pool.Manager;
+}
 
-void MultithreadingModule::IncreaseRefCounter()
+MultithreadingManager* MultithreadingModule::FindDefaultPool()
 {
-	std::lock_guard<std::mutex> Lock(MultithreadingManagerRefCounterMutex);
-	MultithreadingManagerRefCounter++;
+	std::map<std::string, PoolReference>::iterator Pool = Pools.find(DefaultPoolConfig.Name);
+	return Pool != Pools.end() ? Pool->second.Manager : nullptr;
 }
 
-void MultithreadingModule::DecreaseRefCounter()
+MultithreadingModule::MultithreadingModule() : MultithreadingManagerRef(nullptr)
 {
-	std::lock_guard<std::mutex> Lock(MultithreadingManagerRefCounterMutex);
-	MultithreadingManagerRefCounter--;
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	AcquirePool(DefaultPoolConfig);
 }
 
-unsigned int MultithreadingModule::GetRefCounterValue()
+MultithreadingModule::MultithreadingModule(const MultithreadingPoolConfig& Config) : MultithreadingManagerRef(nullptr)
 {
-	std::lock_guard<std::mutex> Lock(MultithreadingManagerRefCounterMutex);
-	return MultithreadingManagerRefCounter;
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	AcquirePool(Config);
 }
 
-MultithreadingModule::MultithreadingModule()
+MultithreadingModule::~MultithreadingModule()
 {
-	IncreaseRefCounter();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
 
-	std::lock_guard<std::mutex> Lock(MultithreadingManagerRefMutex);
-	if (MultithreadingManagerRef == nullptr)
+	std::map<std::string, PoolReference>::iterator Pool = Pools.find(MultithreadingManagerRef->GetName());
+	Pool->second.RefCounter--;
+	if (Pool->second.RefCounter == 0)
 	{
-		MultithreadingManagerRef = new MultithreadingManager();
+		delete Pool->second.Manager;
+		Pools.erase(Pool);
 	}
 }
 
-MultithreadingModule::~MultithreadingModule()
+const std::string& MultithreadingModule::GetPoolName()
+{
+	return MultithreadingManagerRef->GetName();
+}
+
+void MultithreadingModule::SetPoolConfig(const MultithreadingPoolConfig& NewConfig)
 {
-	DecreaseRefCounter();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManagerRef->SetConfig(NewConfig);
 
-	std::lock_guard<std::mutex> Lock(MultithreadingManagerRefMutex);
-	if (GetRefCounterValue() == 0)
+	// The default pool keeps its configuration if it is recreated
+	if (MultithreadingManagerRef == FindDefaultPool())
 	{
-		delete MultithreadingManagerRef;
-		MultithreadingManagerRef = nullptr;
+		DefaultPoolConfig = MultithreadingManagerRef->GetConfig();
 	}
 }
 
+MultithreadingPoolConfig MultithreadingModule::GetPoolConfig()
+{
+	return MultithreadingManagerRef->GetConfig();
+}
+
 void MultithreadingModule::Tick(float DeltaTime)
 {
 	MultithreadingManagerRef->Tick(DeltaTime);
@@ -77,24 +100,124 @@ unsigned int MultithreadingModule::GetNumOfThreads()
 	return MultithreadingManagerRef->GetNumOfThreads();
 }
 
+unsigned int MultithreadingModule::GetNumOfParkedThreads()
+{
+	return MultithreadingManagerRef->GetNumOfParkedThreads();
+}
+
+unsigned int MultithreadingModule::GetNumOfBlockedThreads()
+{
+	return MultithreadingManagerRef->GetNumOfBlockedThreads();
+}
+
+MultithreadingStatistics MultithreadingModule::GetStatistics()
+{
+	return MultithreadingManagerRef->GetStatistics();
+}
+
+void MultithreadingModule::ResetStatistics()
+{
+	MultithreadingManagerRef->ResetStatistics();
+}
+
+void MultithreadingModule::SetAutoscalerPolicy(const AutoscalerPolicy& NewPolicy)
+{
+	MultithreadingManagerRef->SetAutoscalerPolicy(NewPolicy);
+}
+
+AutoscalerPolicy MultithreadingModule::GetAutoscalerPolicy()
+{
+	return MultithreadingManagerRef->GetAutoscalerPolicy();
+}
+
+void MultithreadingModule::SetChunkingPolicy(const ChunkingPolicy& NewPolicy)
+{
+	MultithreadingManagerRef->SetChunkingPolicy(NewPolicy);
+}
+
+ChunkingPolicy MultithreadingModule::GetChunkingPolicy()
+{
+	return MultithreadingManagerRef->GetChunkingPolicy();
+}
+
+void MultithreadingModule::SetOnceQueueCapacity(unsigned int NewCapacity, QueueOverflowMode NewOverflow)
+{
+	MultithreadingManagerRef->SetOnceQueueCapacity(NewCapacity, NewOverflow);
+}
+
+unsigned int MultithreadingModule::GetOnceQueueCapacity()
+{
+	return MultithreadingManagerRef->GetOnceQueueCapacity();
+}
+
+QueueOverflowMode MultithreadingModule::GetOnceQueueOverflow()
+{
+	return MultithreadingManagerRef->GetOnceQueueOverflow();
+}
+
+void MultithreadingModule::SetWorkerHooks(const WorkerLifecycleHooks& NewHooks)
+{
+	MultithreadingManagerRef->SetWorkerHooks(NewHooks);
+}
+
+WorkerLifecycleHooks MultithreadingModule::GetWorkerHooks()
+{
+	return MultithreadingManagerRef->GetWorkerHooks();
+}
+
 void MultithreadingModule::SetMaxNumOfThreads(unsigned int NewMax)
 {
-	MultithreadingManagerRef->SetMaxNumOfThreads(NewMax);
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MaxNumOfThreads = NewMax;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMaxNumOfThreads(NewMax);
+	}
 }
 
 unsigned int MultithreadingModule::GetMaxNumOfThreads()
 {
-	return MultithreadingManagerRef->GetMaxNumOfThreads();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMaxNumOfThreads() : DefaultPoolConfig.MaxNumOfThreads;
 }
 
 void MultithreadingModule::SetMaxNumOfStoppedThreads(unsigned int NewMax)
 {
-	MultithreadingManagerRef->SetMaxNumOfStoppedThreads(NewMax);
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MaxNumOfStoppedThreads = NewMax;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMaxNumOfStoppedThreads(NewMax);
+	}
 }
 
 unsigned int MultithreadingModule::GetMaxNumOfStoppedThreads()
 {
-	return MultithreadingManagerRef->GetMaxNumOfStoppedThreads();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMaxNumOfStoppedThreads() : DefaultPoolConfig.MaxNumOfStoppedThreads;
+}
+
+void MultithreadingModule::SetTaskErrorSink(const TaskErrorSink& NewSink)
+{
+	MultithreadingManager::SetTaskErrorSink(NewSink);
+}
+
+void MultithreadingModule::SetDeterministicExecution(bool bNewState, unsigned int Seed)
+{
+	MultithreadingManager::SetDeterministicExecution(bNewState, Seed);
+}
+
+bool MultithreadingModule::GetDeterministicExecution()
+{
+	return MultithreadingManager::GetDeterministicExecution();
 }
 
 void MultithreadingModule::AddTask(ThreadTask* Task)
@@ -102,11 +225,56 @@ void MultithreadingModule::AddTask(ThreadTask* Task)
 	MultithreadingManagerRef->AddTask(Task);
 }
 
+TaskHandle MultithreadingModule::AddTaskWithHandle(ThreadTask* Task)
+{
+	return MultithreadingManagerRef->AddTaskWithHandle(Task);
+}
+
+bool MultithreadingModule::TryAddTask(ThreadTask* Task, unsigned int Timeout)
+{
+	return MultithreadingManagerRef->TryAddTask(Task, Timeout);
+}
+
+void MultithreadingModule::AddInternalTask(ThreadTask* Task)
+{
+	MultithreadingManagerRef->AddInternalTask(Task);
+}
+
 void MultithreadingModule::RemoveTask(ThreadTask* Task)
 {
 	MultithreadingManagerRef->RemoveTask(Task);
 }
 
+void MultithreadingModule::RemoveTask(const TaskHandle& Handle)
+{
+	MultithreadingManagerRef->RemoveTask(Handle);
+}
+
+unsigned int MultithreadingModule::DispatchCallbacks(unsigned int MaxNumOfCallbacks)
+{
+	return MultithreadingManagerRef->DispatchCallbacks(MaxNumOfCallbacks);
+}
+
+void MultithreadingModule::SetDispatchCallbacksInTick(bool bNewState, unsigned int NewMaxNumOfCallbacks)
+{
+	MultithreadingManagerRef->SetDispatchCallbacksInTick(bNewState, NewMaxNumOfCallbacks);
+}
+
+LinearArena& MultithreadingModule::GetScratchArena()
+{
+	return AdvancedThread::GetScratchArena();
+}
+
+void* MultithreadingModule::AllocateFrameMemory(size_t Size, size_t Alignment)
+{
+	return MultithreadingManagerRef->AllocateFrameMemory(Size, Alignment);
+}
+
+bool MultithreadingModule::ExecuteOnceTask()
+{
+	return MultithreadingManagerRef->ExecuteOnceTask();
+}
+
 void MultithreadingModule::RemoveAllTasks()
 {
 	MultithreadingManagerRef->RemoveAllTasks();
@@ -133,22 +301,112 @@ std::vector<ThreadState> MultithreadingModule::GetDedicatedThreadsStates()
 	return MultithreadingManagerRef->GetDedicatedThreadsStates();
 }
 
+unsigned int MultithreadingModule::GetNumOfIdleDedicatedThreads()
+{
+	return MultithreadingManagerRef->GetNumOfIdleDedicatedThreads();
+}
+
+void MultithreadingModule::SetMinNumOfIdleDedicatedThreads(unsigned int NewMin)
+{
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MinNumOfIdleDedicatedThreads = NewMin;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMinNumOfIdleDedicatedThreads(NewMin);
+	}
+}
+
+unsigned int MultithreadingModule::GetMinNumOfIdleDedicatedThreads()
+{
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMinNumOfIdleDedicatedThreads() : DefaultPoolConfig.MinNumOfIdleDedicatedThreads;
+}
+
+void MultithreadingModule::SetMaxNumOfIdleDedicatedThreads(unsigned int NewMax)
+{
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MaxNumOfIdleDedicatedThreads = NewMax;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMaxNumOfIdleDedicatedThreads(NewMax);
+	}
+}
+
+unsigned int MultithreadingModule::GetMaxNumOfIdleDedicatedThreads()
+{
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMaxNumOfIdleDedicatedThreads() : DefaultPoolConfig.MaxNumOfIdleDedicatedThreads;
+}
+
+float MultithreadingModule::GetDedicatedThreadsPoolHitRate()
+{
+	return MultithreadingManagerRef->GetDedicatedThreadsPoolHitRate();
+}
+
 void MultithreadingModule::SetMaxTickTasksPerIteration(unsigned int NewMax)
 {
-	AdvancedThread::SetMaxTickTasksPerIteration(NewMax);
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MaxTickTasksPerIteration = NewMax;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMaxTickTasksPerIteration(NewMax);
+	}
 }
 
 unsigned int MultithreadingModule::GetMaxTickTasksPerIteration()
 {
-	return AdvancedThread::GetMaxTickTasksPerIteration();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMaxTickTasksPerIteration() : DefaultPoolConfig.MaxTickTasksPerIteration;
 }
 
 void MultithreadingModule::SetMaxOnceTasksPerIteration(unsigned int NewMax)
 {
-	AdvancedThread::SetMaxOnceTasksPerIteration(NewMax);
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+	DefaultPoolConfig.MaxOnceTasksPerIteration = NewMax;
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	if (DefaultPool != nullptr)
+	{
+		DefaultPool->SetMaxOnceTasksPerIteration(NewMax);
+	}
 }
 
 unsigned int MultithreadingModule::GetMaxOnceTasksPerIteration()
 {
-	return AdvancedThread::GetMaxOnceTasksPerIteration();
+	std::lock_guard<std::mutex> Lock(PoolsMutex);
+
+	MultithreadingManager* DefaultPool = FindDefaultPool();
+	return DefaultPool != nullptr ? DefaultPool->GetMaxOnceTasksPerIteration() : DefaultPoolConfig.MaxOnceTasksPerIteration;
+}
+
+void MultithreadingModule::SetTracingEnabled(bool bNewState)
+{
+	TaskTracer::SetEnabled(bNewState);
+}
+
+bool MultithreadingModule::IsTracingEnabled()
+{
+	return TaskTracer::IsEnabled();
+}
+
+std::string MultithreadingModule::GetTraceJson(float LastSeconds)
+{
+	return TaskTracer::GetChromeTraceJson(LastSeconds);
+}
+
+bool MultithreadingModule::DumpTrace(const std::string& FilePath, float LastSeconds)
+{
+	return TaskTracer::DumpChromeTrace(FilePath, LastSeconds);
 }
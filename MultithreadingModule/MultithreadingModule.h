@@ -1,30 +1,69 @@
 #pragma once
+#include <map>
+#include <string>
 #include "AdvancedThread.h"
 #include "MultithreadingManager.h"
+#include "MultithreadingPoolConfig.h"
 
 class MultithreadingModule final
 {
 private:
-	static unsigned int MultithreadingManagerRefCounter;
-	static std::mutex MultithreadingManagerRefCounterMutex;
+	struct PoolReference
+	{
+		MultithreadingManager* Manager;
+		unsigned int RefCounter;
 
-	static MultithreadingManager* MultithreadingManagerRef;
-	static std::mutex MultithreadingManagerRefMutex;
+		PoolReference() : Manager(nullptr), RefCounter(0) {}
+	};
+
+	// Created pools by name, a pool is deleted when the last module that uses it is destroyed
+	static std::map<std::string, PoolReference> Pools;
+	// Configuration of the default pool, it is used when the default pool is created
+	static MultithreadingPoolConfig DefaultPoolConfig;
+	// Protects Pools and DefaultPoolConfig
+	static std::mutex PoolsMutex;
+
+	// Pool used by this module
+	MultithreadingManager* MultithreadingManagerRef;
 
 private:
-	static void IncreaseRefCounter();
-	static void DecreaseRefCounter();
-	static unsigned int GetRefCounterValue();
+	// Takes a reference to the pool with the name from the configuration, creating the pool if necessary
+	// Must be called with PoolsMutex locked
+	void AcquirePool(const MultithreadingPoolConfig& Config);
+
+	// Returns the default pool if it is created, or nullptr
+	// Must be called with PoolsMutex locked
+	static MultithreadingManager* FindDefaultPool();
 
 public:
+	// Uses the default pool
 	MultithreadingModule();
+	// Uses the pool with the name from the configuration
+	// If the pool is not created yet, it is created with the given configuration, otherwise the configuration is ignored
+	// @param Config - Configuration of the pool
+	explicit MultithreadingModule(const MultithreadingPoolConfig& Config);
 	~MultithreadingModule();
 
+	MultithreadingModule(const MultithreadingModule&) = delete;
+	MultithreadingModule& operator=(const MultithreadingModule&) = delete;
+
 	void* operator new(std::size_t count) = delete;
 	void* operator new[](std::size_t count) = delete;
 
 
 
+	// Pool
+
+	// Returns the name of the pool used by this module, the default pool has an empty name
+	const std::string& GetPoolName();
+
+	// Applies the limits and the autoscaler policy of the configuration to the pool used by this module, the name is ignored
+	// @param NewConfig - Updated configuration
+	void SetPoolConfig(const MultithreadingPoolConfig& NewConfig);
+	// Returns the current configuration of the pool used by this module
+	MultithreadingPoolConfig GetPoolConfig();
+
+
 	// Standard threads
 
 	// Causes threads to perform Tick tasks and waits until they are completed
@@ -52,6 +91,53 @@ public:
 	// Returns the number of running standard threads
 	unsigned int GetNumOfThreads();
 
+	// Returns the number of standard threads parked by the autoscaler
+	unsigned int GetNumOfParkedThreads();
+
+	// Returns the number of standard threads whose tasks are blocking
+	// Tasks block by ThreadTask::SetBlocking or by a BlockingScope, each blocked thread is compensated by an additional one
+	unsigned int GetNumOfBlockedThreads();
+
+	// Returns the statistics of the running and parked standard threads, per thread and in total, and of Tick
+	// Statistics are collected only if MULTITHREADING_ENABLE_STATISTICS is not 0
+	MultithreadingStatistics GetStatistics();
+	// Clears the statistics of the standard threads and of Tick
+	void ResetStatistics();
+
+	// Sets the policy by which the number of running standard threads follows the load
+	// Shrinking parks the surplus threads, so that growing back only needs to wake them up
+	// @param NewPolicy - Updated policy
+	void SetAutoscalerPolicy(const AutoscalerPolicy& NewPolicy);
+	// Returns the policy by which the number of running standard threads follows the load
+	AutoscalerPolicy GetAutoscalerPolicy();
+
+	// Sets the policy by which the threads choose how many queued tasks to take in one iteration
+	// Guided and Adaptive modes let idle threads share a long queue instead of one thread taking it all
+	// @param NewPolicy - Updated policy
+	void SetChunkingPolicy(const ChunkingPolicy& NewPolicy);
+	// Returns the policy by which the threads choose how many queued tasks to take in one iteration
+	ChunkingPolicy GetChunkingPolicy();
+
+	// Limits the number of queued Once tasks of the pool, so that producers faster than the threads cannot exhaust the memory
+	// Tasks of TaskGroup, Pipeline and ParallelAlgorithms do not count against the capacity and are never dropped
+	// A standard thread that adds a task with Block does not wait, it executes queued tasks until there is space
+	// @param NewCapacity - maximum number of queued Once tasks, 0 - unlimited
+	// @param NewOverflow - what AddTask does when the queue is full
+	void SetOnceQueueCapacity(unsigned int NewCapacity, QueueOverflowMode NewOverflow);
+	// Returns the maximum number of queued Once tasks, 0 - unlimited
+	unsigned int GetOnceQueueCapacity();
+	// Returns what AddTask does when the Once queue is full
+	QueueOverflowMode GetOnceQueueOverflow();
+
+	// Sets the hooks called on each standard and dedicated thread of the pool when it starts and stops
+	// Per-thread resources are kept in WorkerLocal variables, the start hook can open them and the stop hook close them
+	// @param NewHooks - Updated hooks
+	void SetWorkerHooks(const WorkerLifecycleHooks& NewHooks);
+	// Returns the hooks called on each thread of the pool when it starts and stops
+	WorkerLifecycleHooks GetWorkerHooks();
+
+	// Static limits configure the default pool, other pools are configured by SetPoolConfig
+
 	// Sets the maximum number of simultaneously working standard threads
 	// @param NewMax - Updated limit
 	static void SetMaxNumOfThreads(unsigned int NewMax);
@@ -64,12 +150,84 @@ public:
 	// Returns the maximum number of stored standard threads
 	static unsigned int GetMaxNumOfStoppedThreads();
 
+	// Sets the function that receives every exception thrown by a task of any pool, on the thread that executed the task
+	// A task exception does not stop the thread, it is also passed to the task handles and counted in the statistics
+	// @param NewSink - the function, an empty function disables the sink
+	static void SetTaskErrorSink(const TaskErrorSink& NewSink);
+
+	// Enables or disables deterministic execution for all pools
+	// In deterministic mode standard threads are not started, and Tick executes all Once and Tick tasks on the calling thread in a defined order
+	// It is also enabled by the MULTITHREADING_DETERMINISTIC_SEED environment variable, which holds the seed
+	// Must be set while no standard thread is running
+	// @param bNewState - new state value
+	// @param Seed - 0 executes tasks in queue order, otherwise tasks are interleaved as if taken by the maximum number of standard threads, 
+	// in an order derived from the seed
+	static void SetDeterministicExecution(bool bNewState, unsigned int Seed);
+	// Returns true if deterministic execution is enabled
+	static bool GetDeterministicExecution();
+
 	// Adds a task to execute
 	// @param Task - Task to add
 	void AddTask(ThreadTask* Task);
+	// Adds a task to execute and returns its handle
+	// Only tasks with a handle allocate the state that the handle follows, so AddTask is cheaper when the handle is not needed
+	// @param Task - Task to add
+	// @return handle that follows the completion of the task and cancels it
+	TaskHandle AddTaskWithHandle(ThreadTask* Task);
+	// Adds a task to execute if there is space for it in the Once queue, Tick and dedicated tasks are always added
+	// @param Task - Task to add
+	// @param Timeout - maximum time in milliseconds to wait for space, 0 - do not wait
+	// @return false if the queue stayed full, the task is not added and still belongs to the caller
+	bool TryAddTask(ThreadTask* Task, unsigned int Timeout = 0);
+	// Adds a Once task of TaskGroup, Pipeline or ParallelAlgorithms without counting it against the capacity of the queue
+	// The overflow mode does not apply to it, so it is never blocked, rejected or dropped
+	// @param Task - Task to add
+	void AddInternalTask(ThreadTask* Task);
 	// Removes Tick task from execution
+	// Tick tasks are added and removed at the start of the next Tick, the removed task is deleted there
+	// Once tasks are cancelled through the handle returned by AddTaskWithHandle or through a CancellationToken
 	// @param Task - Task for removal
 	void RemoveTask(ThreadTask* Task);
+	// Removes Tick task from execution in O(1)
+	// Does nothing if the task has already been removed
+	// @param Handle - Handle returned by AddTaskWithHandle or ThreadTask::GetHandle
+	void RemoveTask(const TaskHandle& Handle);
+
+	// Executes the callbacks of the tasks with deferred routing on the calling thread, in the order they were posted
+	// Tick calls it automatically after the Tick tasks unless it is disabled by SetDispatchCallbacksInTick
+	// @param MaxNumOfCallbacks - maximum number of callbacks to execute, 0 - all
+	// @return number of executed callbacks
+	unsigned int DispatchCallbacks(unsigned int MaxNumOfCallbacks);
+
+	// Sets whether Tick dispatches the deferred callbacks after the Tick tasks
+	// @param bNewState - false to dispatch callbacks only by DispatchCallbacks
+	// @param NewMaxNumOfCallbacks - maximum number of callbacks dispatched by one Tick, 0 - all
+	void SetDispatchCallbacksInTick(bool bNewState, unsigned int NewMaxNumOfCallbacks);
+
+	// Returns the scratch arena of the current thread for temporary allocations of a task, see ArenaAllocator
+	// On a standard thread the arena is reset between tasks after each Tick, so the memory is valid until the end of the current Tick
+	// The thread that calls Tick gets an arena of its own, reset at the end of every Tick, deterministic or not
+	static LinearArena& GetScratchArena();
+
+	// Allocates memory that tasks can hand to each other within a frame
+	// The memory is valid until the end of the Tick after the one during which it was allocated
+	// @param Size - size in bytes
+	// @param Alignment - alignment in bytes, a power of two
+	// @return the memory, or nullptr if Size is 0
+	void* AllocateFrameMemory(size_t Size, size_t Alignment);
+
+	// Allocates an array in the frame memory without constructing the objects
+	// @param Count - number of objects
+	template<typename T>
+	T* AllocateFrameArray(size_t Count)
+	{
+		return static_cast<T*>(AllocateFrameMemory(sizeof(T) * Count, alignof(T)));
+	}
+
+	// Takes one queued Once task and executes it on the calling thread
+	// Used by threads that wait for other tasks, so that they help instead of blocking, see TaskGroup
+	// @return false if there was no task or deterministic execution is enabled
+	bool ExecuteOnceTask();
 
 	// Removes all tasks from execution
 	void RemoveAllTasks();
@@ -90,6 +248,24 @@ public:
 	// Returns the states of dedicated threads
 	std::vector<ThreadState> GetDedicatedThreadsStates();
 
+	// Returns the number of pooled dedicated threads waiting for a task
+	unsigned int GetNumOfIdleDedicatedThreads();
+
+	// Sets the minimum number of pooled dedicated threads kept warm while waiting for a task
+	// @param NewMin - Updated limit
+	static void SetMinNumOfIdleDedicatedThreads(unsigned int NewMin);
+	// Returns the minimum number of pooled dedicated threads kept warm while waiting for a task
+	static unsigned int GetMinNumOfIdleDedicatedThreads();
+
+	// Sets the maximum number of pooled dedicated threads kept waiting for a task, the rest are stopped after completing their task
+	// @param NewMax - Updated limit
+	static void SetMaxNumOfIdleDedicatedThreads(unsigned int NewMax);
+	// Returns the maximum number of pooled dedicated threads kept waiting for a task
+	static unsigned int GetMaxNumOfIdleDedicatedThreads();
+
+	// Returns the share of dedicated tasks that were given to an already running pooled thread, from 0 to 1
+	float GetDedicatedThreadsPoolHitRate();
+
 public:
 	// Sets the maximum number of Tick tasks to be executed in one iteration
 	// @param NewMax - Updated limit
@@ -102,4 +278,23 @@ public:
 	static void SetMaxOnceTasksPerIteration(unsigned int NewMax);
 	// Returns the maximum number of Once tasks that the thread executes in one iteration
 	static unsigned int GetMaxOnceTasksPerIteration();
+
+public:
+	// Tracing
+
+	// Enables or disables the recording of task, sleep, steal and Tick events
+	// Events are recorded only if MULTITHREADING_ENABLE_TRACING is not 0
+	// @param bNewState - new state value
+	static void SetTracingEnabled(bool bNewState);
+	// Returns true if events are recorded
+	static bool IsTracingEnabled();
+
+	// Returns the events of the last seconds in the Chrome Trace Event JSON format, which can also be opened in Perfetto
+	// @param LastSeconds - Length of the exported time interval
+	static std::string GetTraceJson(float LastSeconds);
+	// Writes the events of the last seconds to a file in the Chrome Trace Event JSON format, which can also be opened in Perfetto
+	// @param FilePath - Path to the file
+	// @param LastSeconds - Length of the exported time interval
+	// @return false if the file could not be written
+	static bool DumpTrace(const std::string& FilePath, float LastSeconds);
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include "AutoscalerPolicy.h"
+#include "ChunkingPolicy.h"
+#include "QueueOverflowMode.h"
+#include "WorkerLifecycleHooks.h"
+
+// Configuration of a thread pool
+// Each pool has its own standard and dedicated threads, task queues, limits and statistics
+struct MultithreadingPoolConfig
+{
+	// Modules created with the same name share one pool, the empty name is the default pool
+	std::string Name;
+
+	// Maximum number of simultaneously working standard threads
+	unsigned int MaxNumOfThreads;
+	// Maximum number of saved stopped standard threads
+	unsigned int MaxNumOfStoppedThreads;
+
+	// Minimum number of pooled dedicated threads kept warm while waiting for a task
+	unsigned int MinNumOfIdleDedicatedThreads;
+	// Maximum number of pooled dedicated threads kept waiting for a task
+	unsigned int MaxNumOfIdleDedicatedThreads;
+
+	// Maximum number of Tick tasks that a thread executes in one iteration
+	unsigned int MaxTickTasksPerIteration;
+	// Maximum number of Once tasks that a thread executes in one iteration
+	// With Fixed chunking the thread always takes this many, otherwise it is the upper limit of a chunk
+	unsigned int MaxOnceTasksPerIteration;
+
+	// Maximum number of queued Once tasks added by the user, 0 - unlimited
+	unsigned int OnceQueueCapacity;
+	// What AddTask does when the Once task queue is full
+	QueueOverflowMode OnceQueueOverflow;
+
+	AutoscalerPolicy Autoscaler;
+
+	ChunkingPolicy Chunking;
+
+	// Called on each standard and dedicated thread of the pool when it starts and stops
+	WorkerLifecycleHooks WorkerHooks;
+
+	// Tick dispatches the deferred callbacks of the pool after the Tick tasks
+	bool bDispatchCallbacksInTick;
+	// Maximum number of deferred callbacks dispatched by one Tick, 0 - all
+	unsigned int MaxCallbacksPerTick;
+
+	MultithreadingPoolConfig() :
+		MaxNumOfThreads(4), MaxNumOfStoppedThreads(8),
+		MinNumOfIdleDedicatedThreads(0), MaxNumOfIdleDedicatedThreads(4),
+		MaxTickTasksPerIteration(2000), MaxOnceTasksPerIteration(64),
+		OnceQueueCapacity(0), OnceQueueOverflow(QueueOverflowMode::Block),
+		bDispatchCallbacksInTick(true), MaxCallbacksPerTick(0) {}
+
+	// Creates the default configuration of a named pool
+	// @param NewName - name of the pool
+	explicit MultithreadingPoolConfig(const std::string& NewName) : MultithreadingPoolConfig()
+	{
+		Name = NewName;
+	}
+};
@@ -0,0 +1 @@
+#include "MultithreadingStaticInterface.h"
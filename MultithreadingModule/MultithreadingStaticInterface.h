@@ -0,0 +1,85 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+#include "TaskStopSignal.h"
+#include "TaskRepeatability.h"
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+class ThreadStaticInterfaceTask;
+
+
+// Detection of the hooks that a type defines, they have the names and signatures of the methods of MultithreadingInterface
+template<typename...>
+struct StaticHookVoid
+{
+	typedef void Type;
+};
+
+template<typename Class, typename = void>
+struct HasThreadExecute : std::false_type {};
+template<typename Class>
+struct HasThreadExecute<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadExecute())>::Type> : std::true_type {};
+
+template<typename Class, typename = void>
+struct HasThreadCallback : std::false_type {};
+template<typename Class>
+struct HasThreadCallback<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadCallback())>::Type> : std::true_type {};
+
+template<typename Class, typename = void>
+struct HasThreadExecuteTick : std::false_type {};
+template<typename Class>
+struct HasThreadExecuteTick<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadExecuteTick(std::declval<const float&>()))>::Type> : std::true_type {};
+
+template<typename Class, typename = void>
+struct HasThreadCallbackTick : std::false_type {};
+template<typename Class>
+struct HasThreadCallbackTick<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadCallbackTick())>::Type> : std::true_type {};
+
+template<typename Class, typename = void>
+struct HasThreadExecuteDedicated : std::false_type {};
+template<typename Class>
+struct HasThreadExecuteDedicated<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadExecuteDedicated(std::declval<const TaskStopSignal&>()))>::Type> : std::true_type {};
+
+template<typename Class, typename = void>
+struct HasThreadCallbackDedicated : std::false_type {};
+template<typename Class>
+struct HasThreadCallbackDedicated<Class, typename StaticHookVoid<decltype(std::declval<Class&>().ThreadCallbackDedicated())>::Type> : std::true_type {};
+
+
+// Base of the types whose tasks call their hooks without virtual calls, an alternative to MultithreadingInterface
+// Derived defines only the hooks it needs as ordinary methods, for example: class Unit : public MultithreadingStaticInterface<Unit>
+// The hooks are found at compile time, a callback that is not defined is not called and costs nothing
+template<typename Derived>
+class MultithreadingStaticInterface
+{
+protected:
+	MultithreadingStaticInterface() = default;
+	~MultithreadingStaticInterface() = default;
+
+public:
+	// Creates a task that calls ThreadExecute once, and ThreadCallback if it is defined
+	ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, false>* CreateOnceTask();
+	// Creates a task that calls ThreadExecuteTick every Tick, and ThreadCallbackTick if it is defined
+	ThreadStaticInterfaceTask<Derived, TaskRepeatability::EveryTick, false>* CreateTickTask();
+	// Creates a task that calls ThreadExecuteDedicated on a dedicated thread, and ThreadCallbackDedicated if it is defined
+	ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, true>* CreateDedicatedTask();
+};
+
+// The tasks are complete when the methods are instantiated, ThreadStaticInterfaceTask.h includes this file
+template<typename Derived>
+inline ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, false>* MultithreadingStaticInterface<Derived>::CreateOnceTask()
+{
+	return new ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, false>(static_cast<Derived*>(this));
+}
+
+template<typename Derived>
+inline ThreadStaticInterfaceTask<Derived, TaskRepeatability::EveryTick, false>* MultithreadingStaticInterface<Derived>::CreateTickTask()
+{
+	return new ThreadStaticInterfaceTask<Derived, TaskRepeatability::EveryTick, false>(static_cast<Derived*>(this));
+}
+
+template<typename Derived>
+inline ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, true>* MultithreadingStaticInterface<Derived>::CreateDedicatedTask()
+{
+	return new ThreadStaticInterfaceTask<Derived, TaskRepeatability::Once, true>(static_cast<Derived*>(this));
+}
@@ -0,0 +1,36 @@
+#include "MultithreadingStatistics.h"
+
+WorkerStatistics::WorkerStatistics() :
+	State(ThreadState::NotReadyToStart),
+	NumOfExecutedTasks(0), NumOfExceptions(0), NumOfCancelledTasks(0),
+	BusyTime(0), IdleTime(0), AsleepTime(0),
+	NumOfSteals(0), NumOfWakeUps(0),
+	ScratchArenaHighWaterMark(0), ScratchArenaCapacity(0)
+{
+}
+
+void WorkerStatistics::Merge(const WorkerStatistics& Other)
+{
+	NumOfExecutedTasks += Other.NumOfExecutedTasks;
+	NumOfExceptions += Other.NumOfExceptions;
+	NumOfCancelledTasks += Other.NumOfCancelledTasks;
+
+	BusyTime += Other.BusyTime;
+	IdleTime += Other.IdleTime;
+	AsleepTime += Other.AsleepTime;
+
+	NumOfSteals += Other.NumOfSteals;
+	NumOfWakeUps += Other.NumOfWakeUps;
+
+	ScratchArenaHighWaterMark += Other.ScratchArenaHighWaterMark;
+	ScratchArenaCapacity += Other.ScratchArenaCapacity;
+
+	QueueWaitTime.Merge(Other.QueueWaitTime);
+	ExecutionTime.Merge(Other.ExecutionTime);
+}
+
+MultithreadingStatistics::MultithreadingStatistics() : NumOfTaskExceptions(0), NumOfBlockedThreads(0),
+	OnceQueueSize(0), OnceQueueCapacity(0), OnceQueuePeakSize(0), NumOfBlockedSubmissions(0), NumOfRejectedTasks(0), NumOfDroppedTasks(0),
+	FrameArenaHighWaterMark(0), FrameArenaCapacity(0), NumOfTicks(0), NumOfTickPhases(0), NumOfTickScheduleBuilds(0)
+{
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include "MultithreadingConfig.h"
+#include "LatencyHistogram.h"
+#include "ThreadState.h"
+
+// Statistics of one standard thread, all times are in nanoseconds
+struct WorkerStatistics
+{
+	ThreadState State;
+
+	unsigned long long NumOfExecutedTasks;
+	// Number of exceptions thrown by the executed tasks
+	unsigned long long NumOfExceptions;
+	// Number of cancelled Once tasks skipped without execution, cancelled Tick tasks are left out by the manager
+	unsigned long long NumOfCancelledTasks;
+
+	// Time spent executing tasks
+	unsigned long long BusyTime;
+	// Time spent running without tasks to execute
+	unsigned long long IdleTime;
+	// Time spent sleeping
+	unsigned long long AsleepTime;
+
+	// Number of task portions taken from the shared queues
+	unsigned long long NumOfSteals;
+	// Number of times the thread woke up
+	unsigned long long NumOfWakeUps;
+
+	// Maximum number of bytes allocated from the scratch arena within one Tick, in bytes
+	unsigned long long ScratchArenaHighWaterMark;
+	// Memory reserved by the scratch arena, in bytes
+	unsigned long long ScratchArenaCapacity;
+
+	// Time from adding the task to the queue to the start of its execution
+	// Without tracing, only every WorkerCounters::TaskSamplingInterval-th task is timed
+	LatencyHistogramSnapshot QueueWaitTime;
+	// Task execution time, sampled the same way
+	LatencyHistogramSnapshot ExecutionTime;
+
+	WorkerStatistics();
+
+	// Adds the counters of another thread to this one
+	// @param Other - Statistics to add
+	void Merge(const WorkerStatistics& Other);
+};
+
+// Statistics of the standard threads, all times are in nanoseconds
+struct MultithreadingStatistics
+{
+	// Statistics of each running and parked standard thread
+	std::vector<WorkerStatistics> Workers;
+	// Sum of the statistics of all threads
+	WorkerStatistics Total;
+
+	// Number of exceptions thrown by all tasks, including dedicated ones and tasks executed by stopped threads
+	unsigned long long NumOfTaskExceptions;
+
+	// Number of standard threads whose tasks are blocking at the moment
+	unsigned int NumOfBlockedThreads;
+
+	// Number of queued Once tasks at the moment, including the internal tasks of TaskGroup, Pipeline and ParallelAlgorithms
+	unsigned int OnceQueueSize;
+	// Maximum number of queued Once tasks added by the user, 0 - unlimited
+	unsigned int OnceQueueCapacity;
+	// Maximum number of queued Once tasks since the statistics were reset, including the internal tasks
+	unsigned int OnceQueuePeakSize;
+	// Number of additions that found the Once queue full and waited for space
+	unsigned long long NumOfBlockedSubmissions;
+	// Number of tasks not added because the Once queue was full
+	unsigned long long NumOfRejectedTasks;
+	// Number of queued tasks deleted without execution to make space for new ones
+	unsigned long long NumOfDroppedTasks;
+
+	// Maximum number of bytes allocated from the frame arena within one Tick, in bytes
+	unsigned long long FrameArenaHighWaterMark;
+	// Memory reserved by the frame arena, in bytes
+	unsigned long long FrameArenaCapacity;
+
+	unsigned long long NumOfTicks;
+	// Time from the start of Tick until all threads have been told to execute Tick tasks
+	LatencyHistogramSnapshot TickForkTime;
+	// Time from the completion of Tick tasks by the last thread until Tick returns
+	LatencyHistogramSnapshot TickJoinTime;
+
+	// Number of phases into which the declared resources of the Tick tasks split the last Tick
+	unsigned int NumOfTickPhases;
+	// Number of times the phases have been computed, they are cached until Tick tasks that declare resources change
+	unsigned long long NumOfTickScheduleBuilds;
+
+	MultithreadingStatistics();
+};
+
+// Returns the current time in nanoseconds for statistics, or 0 if statistics are disabled
+inline unsigned long long GetStatisticsTime()
+{
+#if MULTITHREADING_ENABLE_STATISTICS
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return 0;
+#endif
+}
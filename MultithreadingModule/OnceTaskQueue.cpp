@@ -0,0 +1,76 @@
+#include "OnceTaskQueue.h"
+#include <utility>
+#include "ThreadTask.h"
+
+OnceTaskQueue::OnceTaskQueue() : NumOfUserTasks(0)
+{
+}
+
+void OnceTaskQueue::Push(ThreadTask* Task)
+{
+	Tasks.push_back(Task);
+	if (!Task->IsInternal())
+	{
+		NumOfUserTasks++;
+	}
+}
+
+ThreadTask* OnceTaskQueue::Pop()
+{
+	if (Tasks.empty())
+	{
+		return nullptr;
+	}
+
+	ThreadTask* Task = Tasks.front();
+	Tasks.pop_front();
+	if (!Task->IsInternal())
+	{
+		NumOfUserTasks--;
+	}
+
+	return Task;
+}
+
+ThreadTask* OnceTaskQueue::PopOldestUserTask()
+{
+	if (NumOfUserTasks == 0)
+	{
+		return nullptr;
+	}
+
+	// Internal tasks are usually few, so the oldest user task is near the front
+	for (std::deque<ThreadTask*>::iterator It = Tasks.begin(); It != Tasks.end(); ++It)
+	{
+		if (!(*It)->IsInternal())
+		{
+			ThreadTask* Task = *It;
+			Tasks.erase(It);
+			NumOfUserTasks--;
+			return Task;
+		}
+	}
+
+	return nullptr;
+}
+
+void OnceTaskQueue::Swap(OnceTaskQueue& Other)
+{
+	Tasks.swap(Other.Tasks);
+	std::swap(NumOfUserTasks, Other.NumOfUserTasks);
+}
+
+size_t OnceTaskQueue::Size() const
+{
+	return Tasks.size();
+}
+
+size_t OnceTaskQueue::GetNumOfUserTasks() const
+{
+	return NumOfUserTasks;
+}
+
+bool OnceTaskQueue::IsEmpty() const
+{
+	return Tasks.empty();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <deque>
+#include <cstddef>
+
+class ThreadTask;
+
+// FIFO queue of Once tasks that counts the tasks added by the user
+// Internal tasks of TaskGroup, Pipeline and ParallelAlgorithms are queued with the others, but are not counted,
+// so that a capacity limits only the user tasks and an overflow never drops a task whose owner is waiting for it
+// Not thread-safe, the owner protects it with a mutex
+class OnceTaskQueue final
+{
+private:
+	std::deque<ThreadTask*> Tasks;
+	size_t NumOfUserTasks;
+
+public:
+	OnceTaskQueue();
+
+	// Adds a task to the end of the queue
+	// @param Task - task to add
+	void Push(ThreadTask* Task);
+	// Removes the task at the front of the queue
+	// @return the removed task, or nullptr if the queue is empty
+	ThreadTask* Pop();
+	// Removes the oldest task that is not internal, the internal tasks in front of it keep their places
+	// @return the removed task, or nullptr if the queue has no user tasks
+	ThreadTask* PopOldestUserTask();
+	// Moves all tasks to another queue, this queue takes the tasks of the other one
+	// @param Other - queue to exchange the tasks with
+	void Swap(OnceTaskQueue& Other);
+
+	// Returns the number of all queued tasks
+	size_t Size() const;
+	// Returns the number of queued tasks that are not internal
+	size_t GetNumOfUserTasks() const;
+	bool IsEmpty() const;
+};
@@ -0,0 +1,41 @@
+#include "ParallelAlgorithms.h"
+
+size_t ParallelAlgorithms::GetNumOfChunks(MultithreadingModule* Module, size_t Size)
+{
+	if (Module == nullptr || Size < 2 * MinChunkSize)
+	{
+		return 1;
+	}
+
+	// The calling thread executes chunks too
+	const size_t NumOfThreads = static_cast<size_t>(Module->GetNumOfThreads()) + 1;
+	return std::max<size_t>(1, std::min(NumOfThreads * ChunksPerThread, Size / MinChunkSize));
+}
+
+void ParallelAlgorithms::ForEachChunk(MultithreadingModule* Module, size_t NumOfChunks, const std::function<void(size_t Chunk)>& Function)
+{
+	if (NumOfChunks == 1)
+	{
+		Function(0);
+		return;
+	}
+
+	TaskGroup Group(Module);
+	for (size_t i = 0; i < NumOfChunks; i++)
+	{
+		Group.Run([&Function, i]() { Function(i); });
+	}
+	Group.Wait();
+
+	const std::exception_ptr Exception = Group.GetException();
+	if (Exception != nullptr)
+	{
+		std::rethrow_exception(Exception);
+	}
+}
+
+size_t ParallelAlgorithms::GetChunkBegin(size_t Size, size_t NumOfChunks, size_t Chunk)
+{
+	// The remainder is spread over the first chunks
+	return Chunk * (Size / NumOfChunks) + std::min(Chunk, Size % NumOfChunks);
+}
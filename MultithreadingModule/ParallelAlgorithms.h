@@ -0,0 +1,458 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "MultithreadingModule.h"
+#include "TaskGroup.h"
+
+// Parallel algorithms over random-access ranges, executed by the standard threads of a module through a TaskGroup
+// The calling thread executes chunks itself while waiting, so the algorithms also work without running threads
+// and can be called from tasks
+// Small ranges and a null module are processed on the calling thread by the standard algorithms
+// The first exception thrown by a function is rethrown after all chunks complete, the range is then left in an unspecified state
+// Sort, StableSort and StablePartition use a buffer of the size of the range, so the elements must be default constructible and movable
+class ParallelAlgorithms final
+{
+public:
+	ParallelAlgorithms() = delete;
+
+	// Number of chunks per thread, so that threads that started later still get a share of the work
+	static const size_t ChunksPerThread = 4;
+	// Ranges shorter than this are not split, the cost of a task would exceed the gain
+	static const size_t MinChunkSize = 4096;
+
+	// Applies the operation to each element of the range and writes the results to the output
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Output - beginning of the output range, can be equal to First
+	// @param Operation - function of one element, called in parallel
+	// @return end of the output range
+	template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+	static OutputIterator Transform(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, UnaryOperation Operation);
+
+	// Writes the sums of the elements up to and including each element
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Output - beginning of the output range, can be equal to First
+	// @param Operation - associative function of two sums
+	// @return end of the output range
+	template<typename InputIterator, typename OutputIterator, typename BinaryOperation>
+	static OutputIterator InclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, BinaryOperation Operation);
+	template<typename InputIterator, typename OutputIterator>
+	static OutputIterator InclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output);
+
+	// Writes the sums of the initial value and the elements before each element
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Output - beginning of the output range, can be equal to First
+	// @param Init - sum written for the first element
+	// @param Operation - associative function of two sums
+	// @return end of the output range
+	template<typename InputIterator, typename OutputIterator, typename Type, typename BinaryOperation>
+	static OutputIterator ExclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, Type Init, BinaryOperation Operation);
+	template<typename InputIterator, typename OutputIterator, typename Type>
+	static OutputIterator ExclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, Type Init);
+
+	// Moves the elements that satisfy the predicate before the others, keeping the order within both groups
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Predicate - called once for each element, in parallel
+	// @return beginning of the elements that do not satisfy the predicate
+	template<typename RandomIterator, typename UnaryPredicate>
+	static RandomIterator StablePartition(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, UnaryPredicate Predicate);
+
+	// Sorts the range, chunks are sorted in parallel and merged in parallel
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Comparator - strict weak ordering
+	template<typename RandomIterator, typename Compare>
+	static void Sort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator);
+	template<typename RandomIterator>
+	static void Sort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last);
+
+	// Sorts the range keeping the order of equal elements
+	// @param Module - module whose threads execute the chunks
+	// @param First, Last - the range
+	// @param Comparator - strict weak ordering
+	template<typename RandomIterator, typename Compare>
+	static void StableSort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator);
+	template<typename RandomIterator>
+	static void StableSort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last);
+
+private:
+	// Returns the number of chunks into which a range of the given size is split
+	static size_t GetNumOfChunks(MultithreadingModule* Module, size_t Size);
+
+	// Calls the function for each chunk in parallel and rethrows the first exception
+	// @param Function - function of the index of the chunk
+	static void ForEachChunk(MultithreadingModule* Module, size_t NumOfChunks, const std::function<void(size_t Chunk)>& Function);
+
+	// Returns the position of the chunk boundary in a range split into equal chunks
+	static size_t GetChunkBegin(size_t Size, size_t NumOfChunks, size_t Chunk);
+
+	template<typename RandomIterator, typename Compare>
+	static void SortChunks(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator, bool bStable);
+
+	// Merges adjacent pairs of sorted runs from the source into the destination, each merge split into independent parts
+	// @param Bounds - boundaries of the runs, replaced by the boundaries of the merged runs
+	// @param NumOfParts - number of parts of all merges together
+	template<typename SourceIterator, typename DestinationIterator, typename Compare>
+	static void MergeRuns(MultithreadingModule* Module, SourceIterator Source, DestinationIterator Destination, std::vector<size_t>& Bounds,
+		size_t NumOfParts, Compare Comparator);
+};
+
+
+template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+inline OutputIterator ParallelAlgorithms::Transform(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, UnaryOperation Operation)
+{
+	const size_t Size = static_cast<size_t>(Last - First);
+	const size_t NumOfChunks = GetNumOfChunks(Module, Size);
+
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+			std::transform(First + Begin, First + End, Output + Begin, Operation);
+		});
+
+	return Output + Size;
+}
+
+template<typename InputIterator, typename OutputIterator, typename BinaryOperation>
+inline OutputIterator ParallelAlgorithms::InclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, BinaryOperation Operation)
+{
+	typedef typename std::iterator_traits<InputIterator>::value_type ValueType;
+
+	const size_t Size = static_cast<size_t>(Last - First);
+	const size_t NumOfChunks = GetNumOfChunks(Module, Size);
+	if (NumOfChunks == 1)
+	{
+		return std::partial_sum(First, Last, Output, Operation);
+	}
+
+	// Sums of the chunks, then the sum of all chunks before each chunk is added to its own scan
+	std::vector<ValueType> ChunkSums(NumOfChunks);
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+			ValueType Sum = First[Begin];
+			for (size_t i = Begin + 1; i < End; i++)
+			{
+				Sum = Operation(Sum, First[i]);
+			}
+			ChunkSums[Chunk] = Sum;
+		});
+
+	for (size_t i = 1; i < NumOfChunks; i++)
+	{
+		ChunkSums[i] = Operation(ChunkSums[i - 1], ChunkSums[i]);
+	}
+
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+			ValueType Sum = Chunk == 0 ? ValueType(First[Begin]) : Operation(ChunkSums[Chunk - 1], First[Begin]);
+			Output[Begin] = Sum;
+			for (size_t i = Begin + 1; i < End; i++)
+			{
+				Sum = Operation(Sum, First[i]);
+				Output[i] = Sum;
+			}
+		});
+
+	return Output + Size;
+}
+
+template<typename InputIterator, typename OutputIterator>
+inline OutputIterator ParallelAlgorithms::InclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output)
+{
+	return InclusiveScan(Module, First, Last, Output, std::plus<typename std::iterator_traits<InputIterator>::value_type>());
+}
+
+template<typename InputIterator, typename OutputIterator, typename Type, typename BinaryOperation>
+inline OutputIterator ParallelAlgorithms::ExclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, Type Init, BinaryOperation Operation)
+{
+	const size_t Size = static_cast<size_t>(Last - First);
+	const size_t NumOfChunks = GetNumOfChunks(Module, Size);
+
+	// Sums of the chunks, the sum before the first chunk is the initial value
+	std::vector<Type> ChunkSums(NumOfChunks + 1, Init);
+	if (NumOfChunks > 1)
+	{
+		ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+			{
+				const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+				const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+				Type Sum = First[Begin];
+				for (size_t i = Begin + 1; i < End; i++)
+				{
+					Sum = Operation(Sum, First[i]);
+				}
+				ChunkSums[Chunk + 1] = Sum;
+			});
+
+		for (size_t i = 1; i <= NumOfChunks; i++)
+		{
+			ChunkSums[i] = Operation(ChunkSums[i - 1], ChunkSums[i]);
+		}
+	}
+
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+			// The element is read before the output is written, so that the scan can be done in place
+			Type Sum = ChunkSums[Chunk];
+			for (size_t i = Begin; i < End; i++)
+			{
+				Type Next = Operation(Sum, First[i]);
+				Output[i] = Sum;
+				Sum = std::move(Next);
+			}
+		});
+
+	return Output + Size;
+}
+
+template<typename InputIterator, typename OutputIterator, typename Type>
+inline OutputIterator ParallelAlgorithms::ExclusiveScan(MultithreadingModule* Module, InputIterator First, InputIterator Last, OutputIterator Output, Type Init)
+{
+	return ExclusiveScan(Module, First, Last, Output, Init, std::plus<Type>());
+}
+
+template<typename RandomIterator, typename UnaryPredicate>
+inline RandomIterator ParallelAlgorithms::StablePartition(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, UnaryPredicate Predicate)
+{
+	typedef typename std::iterator_traits<RandomIterator>::value_type ValueType;
+
+	const size_t Size = static_cast<size_t>(Last - First);
+	const size_t NumOfChunks = GetNumOfChunks(Module, Size);
+	if (NumOfChunks == 1)
+	{
+		return std::stable_partition(First, Last, Predicate);
+	}
+
+	// The predicate is evaluated once, the results are used to count and to place the elements
+	std::vector<unsigned char> bSatisfied(Size);
+	std::vector<size_t> NumsOfSatisfied(NumOfChunks + 1, 0);
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+			size_t NumOfSatisfied = 0;
+			for (size_t i = Begin; i < End; i++)
+			{
+				bSatisfied[i] = Predicate(First[i]) ? 1 : 0;
+				NumOfSatisfied += bSatisfied[i];
+			}
+			NumsOfSatisfied[Chunk + 1] = NumOfSatisfied;
+		});
+
+	// Number of satisfying elements before each chunk
+	for (size_t i = 1; i <= NumOfChunks; i++)
+	{
+		NumsOfSatisfied[i] += NumsOfSatisfied[i - 1];
+	}
+	const size_t TotalNumOfSatisfied = NumsOfSatisfied[NumOfChunks];
+
+	std::vector<ValueType> Buffer(Size);
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+
+			size_t SatisfiedPosition = NumsOfSatisfied[Chunk];
+			size_t OtherPosition = TotalNumOfSatisfied + (Begin - NumsOfSatisfied[Chunk]);
+			for (size_t i = Begin; i < End; i++)
+			{
+				Buffer[bSatisfied[i] ? SatisfiedPosition++ : OtherPosition++] = std::move(First[i]);
+			}
+		});
+
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+			const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+			std::move(Buffer.begin() + Begin, Buffer.begin() + End, First + Begin);
+		});
+
+	return First + TotalNumOfSatisfied;
+}
+
+template<typename RandomIterator, typename Compare>
+inline void ParallelAlgorithms::Sort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator)
+{
+	SortChunks(Module, First, Last, Comparator, false);
+}
+
+template<typename RandomIterator>
+inline void ParallelAlgorithms::Sort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last)
+{
+	SortChunks(Module, First, Last, std::less<typename std::iterator_traits<RandomIterator>::value_type>(), false);
+}
+
+template<typename RandomIterator, typename Compare>
+inline void ParallelAlgorithms::StableSort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator)
+{
+	SortChunks(Module, First, Last, Comparator, true);
+}
+
+template<typename RandomIterator>
+inline void ParallelAlgorithms::StableSort(MultithreadingModule* Module, RandomIterator First, RandomIterator Last)
+{
+	SortChunks(Module, First, Last, std::less<typename std::iterator_traits<RandomIterator>::value_type>(), true);
+}
+
+template<typename RandomIterator, typename Compare>
+inline void ParallelAlgorithms::SortChunks(MultithreadingModule* Module, RandomIterator First, RandomIterator Last, Compare Comparator, bool bStable)
+{
+	typedef typename std::iterator_traits<RandomIterator>::value_type ValueType;
+
+	const size_t Size = static_cast<size_t>(Last - First);
+	const size_t NumOfChunks = GetNumOfChunks(Module, Size);
+	if (NumOfChunks == 1)
+	{
+		if (bStable)
+		{
+			std::stable_sort(First, Last, Comparator);
+		}
+		else
+		{
+			std::sort(First, Last, Comparator);
+		}
+		return;
+	}
+
+	std::vector<size_t> Bounds(NumOfChunks + 1);
+	for (size_t i = 0; i <= NumOfChunks; i++)
+	{
+		Bounds[i] = GetChunkBegin(Size, NumOfChunks, i);
+	}
+
+	ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+		{
+			if (bStable)
+			{
+				std::stable_sort(First + Bounds[Chunk], First + Bounds[Chunk + 1], Comparator);
+			}
+			else
+			{
+				std::sort(First + Bounds[Chunk], First + Bounds[Chunk + 1], Comparator);
+			}
+		});
+
+	// The runs are merged in pairs between the range and the buffer until one run is left
+	std::vector<ValueType> Buffer(Size);
+	bool bInBuffer = false;
+	while (Bounds.size() > 2)
+	{
+		if (bInBuffer)
+		{
+			MergeRuns(Module, Buffer.begin(), First, Bounds, NumOfChunks, Comparator);
+		}
+		else
+		{
+			MergeRuns(Module, First, Buffer.begin(), Bounds, NumOfChunks, Comparator);
+		}
+		bInBuffer = !bInBuffer;
+	}
+
+	if (bInBuffer)
+	{
+		ForEachChunk(Module, NumOfChunks, [&](size_t Chunk)
+			{
+				const size_t Begin = GetChunkBegin(Size, NumOfChunks, Chunk);
+				const size_t End = GetChunkBegin(Size, NumOfChunks, Chunk + 1);
+				std::move(Buffer.begin() + Begin, Buffer.begin() + End, First + Begin);
+			});
+	}
+}
+
+template<typename SourceIterator, typename DestinationIterator, typename Compare>
+inline void ParallelAlgorithms::MergeRuns(MultithreadingModule* Module, SourceIterator Source, DestinationIterator Destination, std::vector<size_t>& Bounds,
+	size_t NumOfParts, Compare Comparator)
+{
+	// A part is a piece of one merge: [LeftBegin, LeftEnd) and [RightBegin, RightEnd) of the source are merged at DestinationBegin
+	struct MergePart
+	{
+		size_t LeftBegin, LeftEnd;
+		size_t RightBegin, RightEnd;
+		size_t DestinationBegin;
+	};
+	std::vector<MergePart> Parts;
+
+	const size_t NumOfMerges = (Bounds.size() - 1) / 2;
+	const size_t PartsPerMerge = std::max<size_t>(1, NumOfParts / std::max<size_t>(1, NumOfMerges));
+
+	std::vector<size_t> MergedBounds;
+	for (size_t Run = 0; Run + 1 < Bounds.size(); Run += 2)
+	{
+		MergedBounds.push_back(Bounds[Run]);
+
+		// The last run without a pair is moved as it is
+		if (Run + 2 >= Bounds.size())
+		{
+			MergePart Part = { Bounds[Run], Bounds[Run + 1], Bounds[Run + 1], Bounds[Run + 1], Bounds[Run] };
+			Parts.push_back(Part);
+			continue;
+		}
+
+		const size_t LeftBegin = Bounds[Run];
+		const size_t Middle = Bounds[Run + 1];
+		const size_t RightEnd = Bounds[Run + 2];
+
+		// Split points are taken from the longer run, the shorter run is split by binary search,
+		// so that equal elements of the left run stay before those of the right run
+		const bool bSplitLeft = Middle - LeftBegin >= RightEnd - Middle;
+		size_t PreviousLeft = LeftBegin;
+		size_t PreviousRight = Middle;
+		for (size_t i = 1; i <= PartsPerMerge; i++)
+		{
+			size_t SplitLeft = Middle;
+			size_t SplitRight = RightEnd;
+			if (i < PartsPerMerge)
+			{
+				if (bSplitLeft)
+				{
+					SplitLeft = LeftBegin + ((Middle - LeftBegin) * i) / PartsPerMerge;
+					SplitRight = static_cast<size_t>(std::lower_bound(Source + Middle, Source + RightEnd, Source[SplitLeft], Comparator) - Source);
+				}
+				else
+				{
+					SplitRight = Middle + ((RightEnd - Middle) * i) / PartsPerMerge;
+					SplitLeft = static_cast<size_t>(std::upper_bound(Source + LeftBegin, Source + Middle, Source[SplitRight], Comparator) - Source);
+				}
+			}
+
+			// Elements before the part in the merged run are those before it in both halves
+			MergePart Part = { PreviousLeft, SplitLeft, PreviousRight, SplitRight, PreviousLeft + (PreviousRight - Middle) };
+			Parts.push_back(Part);
+
+			PreviousLeft = SplitLeft;
+			PreviousRight = SplitRight;
+		}
+	}
+	MergedBounds.push_back(Bounds.back());
+
+	ForEachChunk(Module, Parts.size(), [&](size_t Index)
+		{
+			const MergePart& Part = Parts[Index];
+			std::merge(std::make_move_iterator(Source + Part.LeftBegin), std::make_move_iterator(Source + Part.LeftEnd),
+				std::make_move_iterator(Source + Part.RightBegin), std::make_move_iterator(Source + Part.RightEnd),
+				Destination + Part.DestinationBegin, Comparator);
+		});
+
+	Bounds.swap(MergedBounds);
+}
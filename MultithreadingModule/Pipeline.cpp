@@ -0,0 +1,363 @@
+#include "Pipeline.h"
+#include "PipelineTask.h"
+#include "MultithreadingModule.h"
+#include <stdexcept>
+
+Pipeline::Pipeline(MultithreadingModule* NewModule) : Module(NewModule), bRunning(false), MaxNumOfTokens(1), NumOfTokensInFlight(0),
+	bInputScheduled(false), bInputExhausted(false), bStopInput(false), NextInputSequence(0), NumOfCompletedItems(0), Exception(nullptr) {}
+
+Pipeline::~Pipeline()
+{
+	Wait();
+
+	std::lock_guard<std::mutex> Lock(StagesMutex);
+	for (PipelineStage* Stage : Stages)
+	{
+		delete Stage;
+	}
+	Stages.clear();
+}
+
+bool Pipeline::AddStage(PipelineStageKind Kind, const PipelineStageFunction& Function)
+{
+	if (!Function || IsRunning())
+	{
+		return false;
+	}
+
+	PipelineStage* Stage = new PipelineStage();
+	Stage->Kind = Kind;
+	Stage->Function = Function;
+	Stage->bBusy = false;
+	Stage->NextSequence = 0;
+
+	std::lock_guard<std::mutex> Lock(StagesMutex);
+	Stages.push_back(Stage);
+	return true;
+}
+
+bool Pipeline::Start(unsigned int NewMaxNumOfTokens)
+{
+	if (Module == nullptr)
+	{
+		return false;
+	}
+
+	std::unique_lock<std::mutex> Lock(StateMutex);
+	if (bRunning)
+	{
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> LockStages(StagesMutex);
+		if (Stages.empty())
+		{
+			return false;
+		}
+
+		// Stages keep their order state between runs, so it is reset before the first item
+		for (PipelineStage* Stage : Stages)
+		{
+			std::lock_guard<std::mutex> LockStage(Stage->Mutex);
+			Stage->bBusy = false;
+			Stage->NextSequence = 0;
+		}
+	}
+
+	bRunning = true;
+	MaxNumOfTokens = NewMaxNumOfTokens == 0 ? 1 : NewMaxNumOfTokens;
+	NumOfTokensInFlight = 0;
+	bInputScheduled = false;
+	bInputExhausted = false;
+	bStopInput = false;
+	NextInputSequence = 0;
+	NumOfCompletedItems = 0;
+	Exception = nullptr;
+
+	const bool bNeedToQueueInput = TryScheduleInputLocked();
+	Lock.unlock();
+
+	if (bNeedToQueueInput)
+	{
+		QueueInput();
+	}
+	return true;
+}
+
+void Pipeline::Wait()
+{
+	std::unique_lock<std::mutex> Lock(StateMutex);
+	CompletedCondition.wait(Lock, [this]() { return !bRunning; });
+}
+
+void Pipeline::Run(unsigned int NewMaxNumOfTokens)
+{
+	if (Start(NewMaxNumOfTokens))
+	{
+		Wait();
+	}
+}
+
+void Pipeline::Cancel()
+{
+	std::lock_guard<std::mutex> Lock(StateMutex);
+	bStopInput = true;
+}
+
+bool Pipeline::IsRunning()
+{
+	std::lock_guard<std::mutex> Lock(StateMutex);
+	return bRunning;
+}
+
+std::exception_ptr Pipeline::GetException()
+{
+	std::lock_guard<std::mutex> Lock(StateMutex);
+	return Exception;
+}
+
+unsigned long long Pipeline::GetNumOfCompletedItems()
+{
+	std::lock_guard<std::mutex> Lock(StateMutex);
+	return NumOfCompletedItems;
+}
+
+
+void Pipeline::ReadInput()
+{
+	// Stages are not changed while the pipeline is running
+	PipelineStage* InputStage = Stages[0];
+
+	bool bNeedToRead;
+	{
+		std::lock_guard<std::mutex> Lock(StateMutex);
+		bNeedToRead = !bStopInput;
+	}
+
+	void* Item = nullptr;
+	if (bNeedToRead)
+	{
+		try
+		{
+			Item = InputStage->Function(nullptr);
+		}
+		catch (...)
+		{
+			RecordException(std::current_exception());
+			Item = nullptr;
+		}
+	}
+
+	std::unique_lock<std::mutex> Lock(StateMutex);
+	bInputScheduled = false;
+	if (Item == nullptr)
+	{
+		bInputExhausted = true;
+		Lock.unlock();
+
+		ReleaseToken(false);
+		return;
+	}
+
+	const unsigned long long Sequence = NextInputSequence++;
+
+	// The next input is queued before processing the item, so that reading overlaps with the other stages
+	const bool bNeedToQueueInput = TryScheduleInputLocked();
+	Lock.unlock();
+
+	if (bNeedToQueueInput)
+	{
+		QueueInput();
+	}
+
+	ProcessItem(Item, Sequence, 1, false);
+}
+
+void Pipeline::ProcessItem(void* Item, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage)
+{
+	while (StageIndex < Stages.size())
+	{
+		PipelineStage* Stage = Stages[StageIndex];
+		const bool bSerial = Stage->Kind != PipelineStageKind::Parallel;
+
+		if (bSerial && !bOwnsStage && !TryEnterSerialStage(Stage, Item, Sequence))
+		{
+			// The thread that leaves the stage continues with the item
+			return;
+		}
+		bOwnsStage = false;
+
+		Item = ExecuteStage(Stage, Item);
+
+		if (bSerial)
+		{
+			LeaveSerialStage(Stage, StageIndex);
+		}
+		StageIndex++;
+	}
+
+	ReleaseToken(Item != nullptr);
+}
+
+bool Pipeline::TryEnterSerialStage(PipelineStage* Stage, void* Item, unsigned long long Sequence)
+{
+	std::lock_guard<std::mutex> Lock(Stage->Mutex);
+
+	if (Stage->Kind == PipelineStageKind::SerialInOrder)
+	{
+		if (!Stage->bBusy && Stage->NextSequence == Sequence)
+		{
+			Stage->bBusy = true;
+			return true;
+		}
+
+		Stage->InOrderItems[Sequence] = Item;
+		return false;
+	}
+
+	if (!Stage->bBusy)
+	{
+		Stage->bBusy = true;
+		return true;
+	}
+
+	PipelineItem WaitingItem;
+	WaitingItem.Item = Item;
+	WaitingItem.Sequence = Sequence;
+	Stage->OutOfOrderItems.push(WaitingItem);
+	return false;
+}
+
+void Pipeline::LeaveSerialStage(PipelineStage* Stage, size_t StageIndex)
+{
+	std::unique_lock<std::mutex> Lock(Stage->Mutex);
+
+	PipelineItem NextItem;
+	bool bHasNextItem = false;
+
+	if (Stage->Kind == PipelineStageKind::SerialInOrder)
+	{
+		Stage->NextSequence++;
+
+		std::map<unsigned long long, void*>::iterator Found = Stage->InOrderItems.find(Stage->NextSequence);
+		if (Found != Stage->InOrderItems.end())
+		{
+			NextItem.Item = Found->second;
+			NextItem.Sequence = Found->first;
+			Stage->InOrderItems.erase(Found);
+			bHasNextItem = true;
+		}
+	}
+	else if (!Stage->OutOfOrderItems.empty())
+	{
+		NextItem = Stage->OutOfOrderItems.front();
+		Stage->OutOfOrderItems.pop();
+		bHasNextItem = true;
+	}
+
+	// The stage stays busy and is handed to the waiting item, so no other item can overtake it
+	Stage->bBusy = bHasNextItem;
+	Lock.unlock();
+
+	if (bHasNextItem)
+	{
+		QueueItem(NextItem.Item, NextItem.Sequence, StageIndex, true);
+	}
+}
+
+void* Pipeline::ExecuteStage(PipelineStage* Stage, void* Item)
+{
+	// Dropped items still pass through the serial stages to keep the order, but the functions are not called for them
+	if (Item == nullptr)
+	{
+		return nullptr;
+	}
+
+	try
+	{
+		return Stage->Function(Item);
+	}
+	catch (...)
+	{
+		RecordException(std::current_exception());
+		return nullptr;
+	}
+}
+
+void Pipeline::RecordException(std::exception_ptr NewException)
+{
+	std::lock_guard<std::mutex> Lock(StateMutex);
+	if (Exception == nullptr)
+	{
+		Exception = NewException;
+	}
+	bStopInput = true;
+}
+
+void Pipeline::AbandonTask(bool bReadInput, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage)
+{
+	RecordException(std::make_exception_ptr(std::runtime_error("A pipeline task was deleted without execution")));
+
+	if (bReadInput)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(StateMutex);
+			bInputScheduled = false;
+		}
+
+		ReleaseToken(false);
+		return;
+	}
+
+	// The item itself is lost, but the serial stages still have to let the following items pass
+	ProcessItem(nullptr, Sequence, StageIndex, bOwnsStage);
+}
+
+bool Pipeline::TryScheduleInputLocked()
+{
+	if (bInputScheduled || bInputExhausted || bStopInput || NumOfTokensInFlight >= MaxNumOfTokens)
+	{
+		return false;
+	}
+
+	NumOfTokensInFlight++;
+	bInputScheduled = true;
+	return true;
+}
+
+void Pipeline::ReleaseToken(bool bCompleted)
+{
+	std::unique_lock<std::mutex> Lock(StateMutex);
+
+	NumOfTokensInFlight--;
+	if (bCompleted)
+	{
+		NumOfCompletedItems++;
+	}
+
+	const bool bNeedToQueueInput = TryScheduleInputLocked();
+
+	// Without tokens in flight the input can no longer continue, so the run is complete
+	if (NumOfTokensInFlight == 0)
+	{
+		bRunning = false;
+		CompletedCondition.notify_all();
+	}
+	Lock.unlock();
+
+	if (bNeedToQueueInput)
+	{
+		QueueInput();
+	}
+}
+
+void Pipeline::QueueInput()
+{
+	Module->AddInternalTask(new PipelineTask(this));
+}
+
+void Pipeline::QueueItem(void* Item, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage)
+{
+	Module->AddInternalTask(new PipelineTask(this, Item, Sequence, StageIndex, bOwnsStage));
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include "PipelineStageKind.h"
+
+class MultithreadingModule;
+
+
+// Function of a pipeline stage, it receives the item returned by the previous stage and returns the item for the next one
+// The input stage receives nullptr and returns nullptr when there are no more items
+// Other stages may return nullptr to drop the item, in which case they are responsible for its memory
+typedef std::function<void*(void* Item)> PipelineStageFunction;
+
+
+// Chain of stages executed by the standard threads of a module
+// A thread carries an item through as many stages as it can, so the item stays in the cache of the thread
+// The number of items in flight is limited by the tokens, so a slow stage stops the input
+// instead of letting the items pile up in front of it
+class Pipeline
+{
+	friend class PipelineTask;
+
+private:
+	struct PipelineItem
+	{
+		void* Item;
+		unsigned long long Sequence;
+	};
+
+	struct PipelineStage
+	{
+		PipelineStageKind Kind;
+		PipelineStageFunction Function;
+
+		// True while a thread executes the serial stage
+		bool bBusy;
+		// Sequence of the item that the SerialInOrder stage accepts next
+		unsigned long long NextSequence;
+		// Items waiting for the serial stage, their number is limited by the tokens
+		std::map<unsigned long long, void*> InOrderItems;
+		std::queue<PipelineItem> OutOfOrderItems;
+
+		std::mutex Mutex;
+	};
+
+	MultithreadingModule* Module;
+
+	std::vector<PipelineStage*> Stages;
+	std::mutex StagesMutex;
+
+	// State of the run
+	bool bRunning;
+	unsigned int MaxNumOfTokens;
+	unsigned int NumOfTokensInFlight;
+	// Only one input task is queued at a time, it holds a token while it reads
+	bool bInputScheduled;
+	bool bInputExhausted;
+	bool bStopInput;
+	unsigned long long NextInputSequence;
+	unsigned long long NumOfCompletedItems;
+	std::exception_ptr Exception;
+	std::mutex StateMutex;
+	std::condition_variable CompletedCondition;
+
+public:
+	Pipeline() = delete;
+	Pipeline(const Pipeline&) = delete;
+	Pipeline& operator=(const Pipeline&) = delete;
+
+	// Creates an empty pipeline
+	// @param NewModule - module whose standard threads execute the stages, it must outlive the pipeline
+	Pipeline(MultithreadingModule* NewModule);
+	// Waits for the current run to complete
+	~Pipeline();
+
+	// Appends a stage to the pipeline, the first stage is the input stage and is always executed serially
+	// Must not be called while the pipeline is running
+	// @param Kind - how the stage processes items
+	// @param Function - function of the stage
+	// @return false if the pipeline is running or the function is empty
+	bool AddStage(PipelineStageKind Kind, const PipelineStageFunction& Function);
+
+	// Starts reading the input stage and returns immediately
+	// @param NewMaxNumOfTokens - maximum number of items in flight, at least 1
+	// @return false if the pipeline is already running or has no stages
+	bool Start(unsigned int NewMaxNumOfTokens);
+
+	// Waits until all items have passed through the pipeline
+	// Must not be called from a task of the module, and in deterministic execution only after Tick has drained the pipeline
+	void Wait();
+
+	// Starts the pipeline and waits for it to complete
+	// @param NewMaxNumOfTokens - maximum number of items in flight, at least 1
+	void Run(unsigned int NewMaxNumOfTokens);
+
+	// Stops reading the input stage, items in flight still pass through the remaining stages
+	void Cancel();
+
+	bool IsRunning();
+
+	// Returns the first exception thrown by a stage during the last run, or nullptr
+	// An exception drops the item and stops the input, like Cancel
+	// A task of the pipeline deleted without execution, for example by RemoveAllOnceTasks, is reported the same way
+	std::exception_ptr GetException();
+
+	// Returns the number of items that passed the last stage during the last run
+	unsigned long long GetNumOfCompletedItems();
+
+private:
+	// Executes the input stage and carries the read item through the other stages
+	void ReadInput();
+
+	// Carries an item through the stages starting from StageIndex
+	// Stops early if a serial stage is occupied, then the item waits for the thread that leaves the stage
+	// @param Item - the item, nullptr if it was dropped
+	// @param Sequence - number of the item in the order of the input stage
+	// @param StageIndex - index of the first stage to execute
+	// @param bOwnsStage - true if the serial stage was already entered for the item
+	void ProcessItem(void* Item, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage);
+
+	// Enters the serial stage, or leaves the item waiting for it
+	// @return true if the stage was entered
+	bool TryEnterSerialStage(PipelineStage* Stage, void* Item, unsigned long long Sequence);
+	// Leaves the serial stage and hands it to the next waiting item, if there is one
+	void LeaveSerialStage(PipelineStage* Stage, size_t StageIndex);
+
+	// Calls the function of the stage, dropped items are passed as is
+	// @return the item for the next stage
+	void* ExecuteStage(PipelineStage* Stage, void* Item);
+
+	// Records the exception thrown by a stage and stops the input
+	void RecordException(std::exception_ptr NewException);
+
+	// Handles a task deleted without execution, so that its token is still returned
+	// Records an error, which stops the input, and passes the item through the remaining stages as a dropped one
+	// @param bReadInput - true for the input task
+	// @param Sequence - number of the item in the order of the input stage
+	// @param StageIndex - index of the first stage the task had to execute
+	// @param bOwnsStage - true if the serial stage was already entered for the item
+	void AbandonTask(bool bReadInput, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage);
+
+	// Takes a token for a new input task if the input can continue, must be called under StateMutex
+	// @return true if the input task must be queued
+	bool TryScheduleInputLocked();
+	// Returns the token of a completed item and completes the run after the last one
+	void ReleaseToken(bool bCompleted);
+
+	void QueueInput();
+	void QueueItem(void* Item, unsigned long long Sequence, size_t StageIndex, bool bOwnsStage);
+};
@@ -0,0 +1 @@
+#include "PipelineStageKind.h"
@@ -0,0 +1,12 @@
+#pragma once
+
+// How a pipeline stage processes items
+enum class PipelineStageKind
+{
+	// One item at a time, in the order in which the input stage produced them
+	SerialInOrder,
+	// One item at a time, in any order
+	SerialOutOfOrder,
+	// Any number of items at the same time
+	Parallel
+};
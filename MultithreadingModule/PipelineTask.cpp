@@ -0,0 +1,39 @@
+#include "PipelineTask.h"
+#include "Pipeline.h"
+
+PipelineTask::PipelineTask(Pipeline* NewOwner) :
+	ThreadTask(false, TaskRepeatability::Once, false), Owner(NewOwner), Item(nullptr), Sequence(0), StageIndex(0), bOwnsStage(false), bReadInput(true), bExecuted(false)
+{
+	SetName("Pipeline input");
+}
+
+PipelineTask::PipelineTask(Pipeline* NewOwner, void* NewItem, unsigned long long NewSequence, size_t NewStageIndex, bool bNewOwnsStage) :
+	ThreadTask(false, TaskRepeatability::Once, false), Owner(NewOwner), Item(NewItem), Sequence(NewSequence), StageIndex(NewStageIndex), bOwnsStage(bNewOwnsStage), bReadInput(false), bExecuted(false)
+{
+	SetName("Pipeline stage");
+}
+
+PipelineTask::~PipelineTask()
+{
+	if (Owner != nullptr && !bExecuted)
+	{
+		Owner->AbandonTask(bReadInput, Sequence, StageIndex, bOwnsStage);
+	}
+}
+
+void PipelineTask::Execute(const float&)
+{
+	if (Owner == nullptr)
+	{
+		return;
+	}
+	bExecuted = true;
+
+	if (bReadInput)
+	{
+		Owner->ReadInput();
+		return;
+	}
+
+	Owner->ProcessItem(Item, Sequence, StageIndex, bOwnsStage);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "ThreadTask.h"
+
+class Pipeline;
+
+
+// Once task that runs a part of a pipeline on a standard thread
+// It either reads the next item of the input stage, or carries an item from a stage through the following ones
+class PipelineTask final : public ThreadTask
+{
+private:
+	Pipeline* Owner;
+
+	// Item carried by the task, not used by the input task
+	void* Item;
+	unsigned long long Sequence;
+	size_t StageIndex;
+	// True if the serial stage was already entered for the item by the thread that left it
+	bool bOwnsStage;
+
+	bool bReadInput;
+	// A task deleted without execution returns its token in the destructor
+	bool bExecuted;
+
+public:
+	PipelineTask() = delete;
+
+	// Task that reads the next item of the input stage
+	// @param NewOwner - the pipeline
+	PipelineTask(Pipeline* NewOwner);
+	// Task that carries an item from the stage through the following ones
+	// @param NewOwner - the pipeline
+	// @param NewItem - the item
+	// @param NewSequence - number of the item in the order of the input stage
+	// @param NewStageIndex - index of the first stage to execute
+	// @param bNewOwnsStage - true if the serial stage was already entered for the item
+	PipelineTask(Pipeline* NewOwner, void* NewItem, unsigned long long NewSequence, size_t NewStageIndex, bool bNewOwnsStage);
+	// Returns the token of a task that was not executed, for example removed by RemoveAllOnceTasks
+	~PipelineTask();
+
+	void Execute(const float& DeltaTime) override;
+};
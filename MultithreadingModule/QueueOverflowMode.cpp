@@ -0,0 +1 @@
+#include "QueueOverflowMode.h"
@@ -0,0 +1,13 @@
+#pragma once
+
+// What AddTask does when the Once task queue of the pool is full
+enum class QueueOverflowMode
+{
+	// Waits until a thread takes a task from the queue, a standard thread of the pool executes queued tasks instead of waiting
+	Block,
+	// Deletes the added task without execution, its handles receive an exception
+	Reject,
+	// Deletes the oldest queued user task without execution to make space, for tasks that may be lost
+	// Tasks of TaskGroup, Pipeline and ParallelAlgorithms are never dropped
+	DropOldest
+};
@@ -0,0 +1 @@
+#include "ResourceAccess.h"
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <typeinfo>
+#include "ResourceAccessMode.h"
+
+// Resource declared by a Tick task, such as a component type or a named buffer
+struct ResourceAccess
+{
+	// Tasks access the same resource if the names are equal
+	std::string Resource;
+	ResourceAccessMode Mode;
+
+	ResourceAccess() : Mode(ResourceAccessMode::Read) {}
+	ResourceAccess(const std::string& NewResource, ResourceAccessMode NewMode) : Resource(NewResource), Mode(NewMode) {}
+};
+
+// Returns the name of the resource that stands for a type, for example a component type
+template<typename Type>
+inline std::string GetTypeResourceName()
+{
+	return std::string("type:") + typeid(Type).name();
+}
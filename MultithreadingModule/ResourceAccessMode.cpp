@@ -0,0 +1 @@
+#include "ResourceAccessMode.h"
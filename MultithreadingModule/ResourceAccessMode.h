@@ -0,0 +1,10 @@
+#pragma once
+
+// How a Tick task uses a resource that it declares
+enum class ResourceAccessMode
+{
+	// The task only reads the resource, readers are executed in parallel
+	Read,
+	// The task changes the resource, it is executed apart from all other tasks that access the resource
+	Write
+};
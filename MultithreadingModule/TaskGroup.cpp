@@ -0,0 +1,128 @@
+#include "TaskGroup.h"
+#include "TaskGroupTask.h"
+#include "MultithreadingModule.h"
+
+TaskGroup::TaskGroup(MultithreadingModule* NewModule) : Module(NewModule), State(std::make_shared<TaskGroupState>()) {}
+
+TaskGroup::~TaskGroup()
+{
+	Wait();
+}
+
+void TaskGroup::Run(const std::function<void()>& Function)
+{
+	if (!Function)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> Lock(State->Mutex);
+	State->Functions.push_back(Function);
+	State->NumOfPendingFunctions++;
+	Lock.unlock();
+
+	// Waiting threads can take the new function before the task gets to it
+	State->ChangedCondition.notify_all();
+
+	if (Module != nullptr)
+	{
+		Module->AddInternalTask(new TaskGroupTask(State));
+	}
+}
+
+void TaskGroup::Wait()
+{
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(State->Mutex);
+			if (State->NumOfPendingFunctions == 0)
+			{
+				return;
+			}
+		}
+
+		// Functions of the group first, then any other task, so that the thread keeps working while it waits
+		if (ExecuteFunction(State, true))
+		{
+			continue;
+		}
+		if (Module != nullptr && Module->ExecuteOnceTask())
+		{
+			continue;
+		}
+
+		// The remaining functions are executed by other threads, and they may add new ones
+		std::unique_lock<std::mutex> Lock(State->Mutex);
+		State->ChangedCondition.wait_for(Lock, std::chrono::milliseconds(1), [this]()
+			{
+				return State->NumOfPendingFunctions == 0 || !State->Functions.empty();
+			});
+	}
+}
+
+void TaskGroup::Cancel()
+{
+	std::unique_lock<std::mutex> Lock(State->Mutex);
+	State->NumOfPendingFunctions -= static_cast<unsigned int>(State->Functions.size());
+	State->Functions.clear();
+	Lock.unlock();
+
+	State->ChangedCondition.notify_all();
+}
+
+bool TaskGroup::IsCompleted()
+{
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->NumOfPendingFunctions == 0;
+}
+
+std::exception_ptr TaskGroup::GetException()
+{
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->Exception;
+}
+
+bool TaskGroup::ExecuteFunction(const std::shared_ptr<TaskGroupState>& State, bool bNewest)
+{
+	std::function<void()> Function;
+
+	std::unique_lock<std::mutex> Lock(State->Mutex);
+	if (State->Functions.empty())
+	{
+		return false;
+	}
+
+	if (bNewest)
+	{
+		Function = std::move(State->Functions.back());
+		State->Functions.pop_back();
+	}
+	else
+	{
+		Function = std::move(State->Functions.front());
+		State->Functions.pop_front();
+	}
+	Lock.unlock();
+
+	std::exception_ptr Exception;
+	try
+	{
+		Function();
+	}
+	catch (...)
+	{
+		Exception = std::current_exception();
+	}
+
+	Lock.lock();
+	if (Exception != nullptr && State->Exception == nullptr)
+	{
+		State->Exception = Exception;
+	}
+	State->NumOfPendingFunctions--;
+	Lock.unlock();
+
+	State->ChangedCondition.notify_all();
+	return true;
+}
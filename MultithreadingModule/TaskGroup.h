@@ -0,0 +1,77 @@
+#pragma once
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+class MultithreadingModule;
+
+
+// State shared by a task group and the tasks it queued, it outlives the group
+struct TaskGroupState
+{
+	// Functions that have not been started yet
+	std::deque<std::function<void()>> Functions;
+	// Number of functions that have not been completed yet, including the started ones
+	unsigned int NumOfPendingFunctions;
+
+	// The first exception thrown by a function
+	std::exception_ptr Exception;
+
+	std::mutex Mutex;
+	std::condition_variable ChangedCondition;
+
+	TaskGroupState() : NumOfPendingFunctions(0) {}
+};
+
+
+// Batch of functions executed as Once tasks of a module, that can be waited for as a whole
+// While waiting, the thread executes the functions of the group itself and then other queued Once tasks,
+// so a task can fork and join groups at any depth without blocking a thread of the pool
+class TaskGroup
+{
+	friend class TaskGroupTask;
+
+private:
+	MultithreadingModule* Module;
+
+	std::shared_ptr<TaskGroupState> State;
+
+public:
+	TaskGroup() = delete;
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	// Creates an empty group
+	// @param NewModule - module whose standard threads execute the functions
+	TaskGroup(MultithreadingModule* NewModule);
+	// Waits for the functions of the group
+	~TaskGroup();
+
+	// Adds a function to the group and queues a task for it
+	// @param Function - the function
+	void Run(const std::function<void()>& Function);
+
+	// Waits until all functions of the group are completed, executing pending tasks meanwhile
+	// Can be called from the main thread and from tasks, including tasks of the group
+	void Wait();
+
+	// Removes the functions of the group that have not been started yet
+	void Cancel();
+
+	// Returns true if all functions of the group are completed
+	bool IsCompleted();
+
+	// Returns the first exception thrown by a function of the group, or nullptr
+	// An exception does not stop the other functions of the group
+	std::exception_ptr GetException();
+
+private:
+	// Executes one function of the group that has not been started yet
+	// @param State - state of the group
+	// @param bNewest - true to take the most recently added function, which is the hottest in the cache of the waiting thread
+	// @return false if there was no function to execute
+	static bool ExecuteFunction(const std::shared_ptr<TaskGroupState>& State, bool bNewest);
+};
@@ -0,0 +1,12 @@
+#include "TaskGroupTask.h"
+
+TaskGroupTask::TaskGroupTask(const std::shared_ptr<TaskGroupState>& NewState) :
+	ThreadTask(false, TaskRepeatability::Once, false), State(NewState)
+{
+	SetName("Task group");
+}
+
+void TaskGroupTask::Execute(const float&)
+{
+	TaskGroup::ExecuteFunction(State, false);
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <memory>
+#include "ThreadTask.h"
+#include "TaskGroup.h"
+
+
+// Once task that executes the oldest function of a task group that has not been started yet
+// The group may have executed the function itself while waiting, then the task does nothing
+class TaskGroupTask final : public ThreadTask
+{
+private:
+	std::shared_ptr<TaskGroupState> State;
+
+public:
+	TaskGroupTask() = delete;
+
+	// @param NewState - state of the group
+	TaskGroupTask(const std::shared_ptr<TaskGroupState>& NewState);
+
+	void Execute(const float& DeltaTime) override;
+};
@@ -0,0 +1,107 @@
+#include "TaskHandle.h"
+
+TaskHandle::TaskHandle()
+{
+}
+
+TaskHandle::TaskHandle(const std::shared_ptr<TaskCompletionState>& NewState) : State(NewState)
+{
+}
+
+bool TaskHandle::IsValid() const
+{
+	return State != nullptr;
+}
+
+bool TaskHandle::IsCompleted() const
+{
+	if (State == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->bCompleted;
+}
+
+void TaskHandle::Wait() const
+{
+	if (State == nullptr)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> Lock(State->Mutex);
+	State->CompletedCondition.wait(Lock, [this]() { return State->bCompleted; });
+}
+
+bool TaskHandle::WaitFor(unsigned int Milliseconds) const
+{
+	if (State == nullptr)
+	{
+		return false;
+	}
+
+	std::unique_lock<std::mutex> Lock(State->Mutex);
+	return State->CompletedCondition.wait_for(Lock, std::chrono::milliseconds(Milliseconds), [this]() { return State->bCompleted; });
+}
+
+void TaskHandle::Cancel() const
+{
+	if (State != nullptr)
+	{
+		State->bCancelled.store(true, std::memory_order_relaxed);
+	}
+}
+
+bool TaskHandle::IsCancelled() const
+{
+	return State != nullptr && State->bCancelled.load(std::memory_order_relaxed);
+}
+
+TickTaskId TaskHandle::GetTickTaskId() const
+{
+	if (State == nullptr)
+	{
+		return TickTaskId();
+	}
+
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->TickTask;
+}
+
+bool TaskHandle::HasException() const
+{
+	return GetException() != nullptr;
+}
+
+std::exception_ptr TaskHandle::GetException() const
+{
+	if (State == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->Exception;
+}
+
+unsigned int TaskHandle::GetNumOfExceptions() const
+{
+	if (State == nullptr)
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> Lock(State->Mutex);
+	return State->NumOfExceptions;
+}
+
+void TaskHandle::RethrowException() const
+{
+	const std::exception_ptr Exception = GetException();
+	if (Exception != nullptr)
+	{
+		std::rethrow_exception(Exception);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include "TickTaskRegistry.h"
+
+class ThreadTask;
+
+// Called for every exception thrown by a task, on the thread that executed the task
+// @param Task - the task that threw, it is valid only during the call
+// @param Exception - the thrown exception
+typedef std::function<void(ThreadTask* Task, std::exception_ptr Exception)> TaskErrorSink;
+
+// Completion state shared by a task and its handles, it outlives the task
+struct TaskCompletionState
+{
+	bool bCompleted;
+	// The first exception thrown by the task
+	std::exception_ptr Exception;
+	unsigned int NumOfExceptions;
+
+	// Read by threads for every task, so it is not protected by the mutex
+	std::atomic<bool> bCancelled;
+
+	// Position of a Tick task in the registry of the manager
+	TickTaskId TickTask;
+
+	std::mutex Mutex;
+	std::condition_variable CompletedCondition;
+
+	TaskCompletionState() : bCompleted(false), NumOfExceptions(0), bCancelled(false) {}
+};
+
+// Follows the completion of a task and the exceptions it threw
+// A Once or dedicated task is completed after its execution, a Tick task - when it is removed
+// A task deleted without execution is also completed, including a cancelled task
+class TaskHandle
+{
+private:
+	std::shared_ptr<TaskCompletionState> State;
+
+public:
+	// Creates an empty handle
+	TaskHandle();
+	TaskHandle(const std::shared_ptr<TaskCompletionState>& NewState);
+
+	// Returns true if the handle follows a task
+	bool IsValid() const;
+
+	// Returns true if the task is completed
+	bool IsCompleted() const;
+	// Waits until the task is completed
+	void Wait() const;
+	// Waits until the task is completed or the time runs out
+	// @param Milliseconds - maximum waiting time
+	// @return true if the task is completed
+	bool WaitFor(unsigned int Milliseconds) const;
+
+	// Cancels the task if it has not started yet, a cancelled Tick task is no longer executed
+	void Cancel() const;
+	// Returns true if the task was cancelled through a handle, cancellation through a CancellationToken is not reflected here
+	bool IsCancelled() const;
+
+	// Returns the identifier of a Tick task in the registry of the manager, it is invalid for other tasks
+	TickTaskId GetTickTaskId() const;
+
+	// Returns true if the task threw an exception
+	bool HasException() const;
+	// Returns the first exception thrown by the task, or nullptr
+	std::exception_ptr GetException() const;
+	// Returns the number of exceptions thrown by the task, a Tick task can throw once per Tick
+	unsigned int GetNumOfExceptions() const;
+	// Rethrows the first exception thrown by the task, if there is one
+	void RethrowException() const;
+};
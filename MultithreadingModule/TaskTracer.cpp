@@ -0,0 +1,340 @@
+#include "TaskTracer.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+std::atomic<bool> TaskTracer::bEnabled(MULTITHREADING_ENABLE_TRACING != 0);
+
+unsigned int TaskTracer::BufferCapacity = 16384;
+std::mutex TaskTracer::BufferCapacityMutex;
+
+std::vector<TraceBuffer*> TaskTracer::Buffers;
+std::vector<TraceBuffer*> TaskTracer::FreeBuffers;
+std::mutex TaskTracer::BuffersMutex;
+
+thread_local TraceBuffer* TaskTracer::ThreadBuffer = nullptr;
+
+// Returns the buffer of the thread to the free list when the thread finishes
+class TraceBufferOwner final
+{
+public:
+	bool bOwnsBuffer = false;
+
+	~TraceBufferOwner()
+	{
+		if (bOwnsBuffer)
+		{
+			TaskTracer::ReleaseThreadBuffer();
+		}
+	}
+};
+
+static thread_local TraceBufferOwner ThreadBufferOwner;
+
+
+TraceBuffer::TraceBuffer(unsigned int NewCapacity, unsigned int NewThreadId) : Events(nullptr), Capacity(1), NumOfWrittenEvents(0), ThreadId(NewThreadId)
+{
+	while (Capacity < NewCapacity)
+	{
+		Capacity <<= 1;
+	}
+
+	Events = new TraceEvent[Capacity];
+	for (unsigned long long i = 0; i < Capacity; i++)
+	{
+		Events[i].Time.store(0, std::memory_order_relaxed);
+		Events[i].Name.store(nullptr, std::memory_order_relaxed);
+		Events[i].Type.store(TraceEventType::Steal, std::memory_order_relaxed);
+	}
+}
+
+TraceBuffer::~TraceBuffer()
+{
+	delete[] Events;
+}
+
+std::vector<TraceBuffer::Event> TraceBuffer::GetEvents(unsigned long long MinTime)
+{
+	std::vector<Event> CopiedEvents;
+
+	const unsigned long long LastIndex = NumOfWrittenEvents.load(std::memory_order_acquire);
+	const unsigned long long FirstIndex = LastIndex > Capacity ? LastIndex - Capacity : 0;
+
+	CopiedEvents.reserve(LastIndex - FirstIndex);
+	for (unsigned long long i = FirstIndex; i < LastIndex; i++)
+	{
+		const TraceEvent& Slot = Events[i & (Capacity - 1)];
+
+		Event CopiedEvent;
+		CopiedEvent.Time = Slot.Time.load(std::memory_order_relaxed);
+		CopiedEvent.Name = Slot.Name.load(std::memory_order_relaxed);
+		CopiedEvent.Type = Slot.Type.load(std::memory_order_relaxed);
+		CopiedEvents.push_back(CopiedEvent);
+	}
+
+	// The writer could have overwritten the oldest events while they were copied, such events are discarded
+	// The fence keeps the copying loads before the re-read of the counter
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const unsigned long long LastIndexAfterCopy = NumOfWrittenEvents.load(std::memory_order_relaxed);
+	// The slot of event LastIndexAfterCopy may be being written at the moment, so it also counts as overwritten
+	unsigned long long NumOfOverwrittenEvents = 0;
+	if (LastIndexAfterCopy + 1 > Capacity && LastIndexAfterCopy + 1 - Capacity > FirstIndex)
+	{
+		NumOfOverwrittenEvents = LastIndexAfterCopy + 1 - Capacity - FirstIndex;
+	}
+	if (NumOfOverwrittenEvents > CopiedEvents.size())
+	{
+		NumOfOverwrittenEvents = CopiedEvents.size();
+	}
+
+	size_t FirstKeptEvent = NumOfOverwrittenEvents;
+	while (FirstKeptEvent < CopiedEvents.size() && CopiedEvents[FirstKeptEvent].Time < MinTime)
+	{
+		FirstKeptEvent++;
+	}
+	CopiedEvents.erase(CopiedEvents.begin(), CopiedEvents.begin() + FirstKeptEvent);
+
+	return CopiedEvents;
+}
+
+unsigned int TraceBuffer::GetThreadId()
+{
+	return ThreadId;
+}
+
+void TraceBuffer::SetThreadName(const std::string& NewThreadName)
+{
+	std::lock_guard<std::mutex> Lock(ThreadNameMutex);
+	ThreadName = NewThreadName;
+}
+
+std::string TraceBuffer::GetThreadName()
+{
+	std::lock_guard<std::mutex> Lock(ThreadNameMutex);
+	return ThreadName;
+}
+
+
+void TaskTracer::SetThreadName(const std::string& ThreadName)
+{
+#if MULTITHREADING_ENABLE_TRACING
+	TraceBuffer* Buffer = ThreadBuffer;
+	if (Buffer == nullptr)
+	{
+		Buffer = AcquireThreadBuffer();
+	}
+
+	Buffer->SetThreadName(ThreadName);
+#endif
+}
+
+void TaskTracer::SetEnabled(bool bNewState)
+{
+	bEnabled.store(bNewState && MULTITHREADING_ENABLE_TRACING != 0, std::memory_order_relaxed);
+}
+
+bool TaskTracer::IsEnabled()
+{
+	return bEnabled.load(std::memory_order_relaxed);
+}
+
+void TaskTracer::SetBufferCapacity(unsigned int NewCapacity)
+{
+	std::lock_guard<std::mutex> Lock(BufferCapacityMutex);
+
+	if (NewCapacity <= 1)
+	{
+		BufferCapacity = 1;
+	}
+	else
+	{
+		BufferCapacity = NewCapacity;
+	}
+}
+
+unsigned int TaskTracer::GetBufferCapacity()
+{
+	std::lock_guard<std::mutex> Lock(BufferCapacityMutex);
+	return BufferCapacity;
+}
+
+// Writes a string as a JSON string literal
+static void WriteJsonString(std::ostream& Stream, const char* String)
+{
+	Stream << '"';
+	for (const char* Character = String; *Character != '\0'; Character++)
+	{
+		switch (*Character)
+		{
+		case '"':
+			Stream << "\\\"";
+			break;
+
+		case '\\':
+			Stream << "\\\\";
+			break;
+
+		default:
+			if (static_cast<unsigned char>(*Character) < 0x20)
+			{
+				Stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*Character) << std::dec << std::setfill(' ');
+			}
+			else
+			{
+				Stream << *Character;
+			}
+			break;
+		}
+	}
+	Stream << '"';
+}
+
+std::string TaskTracer::GetChromeTraceJson(float LastSeconds)
+{
+	const unsigned long long Now = GetTraceTime();
+	const unsigned long long Interval = LastSeconds > 0.0f ? static_cast<unsigned long long>(LastSeconds * 1e9) : 0;
+	const unsigned long long MinTime = Interval < Now ? Now - Interval : 0;
+
+	std::vector<TraceBuffer*> CopyOfBuffers;
+	BuffersMutex.lock();
+	CopyOfBuffers = Buffers;
+	BuffersMutex.unlock();
+
+	std::ostringstream Json;
+	Json << std::fixed << std::setprecision(3);
+	Json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	bool bFirstEvent = true;
+	for (size_t i = 0; i < CopyOfBuffers.size(); i++)
+	{
+		TraceBuffer* Buffer = CopyOfBuffers[i];
+		const unsigned int ThreadId = Buffer->GetThreadId();
+
+		const std::string ThreadName = Buffer->GetThreadName();
+		if (!ThreadName.empty())
+		{
+			Json << (bFirstEvent ? "" : ",") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << ThreadId << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+			WriteJsonString(Json, ThreadName.c_str());
+			Json << "}}";
+			bFirstEvent = false;
+		}
+
+		// Begin and end events are paired into complete events, unpaired ends at the start of the interval are skipped,
+		// and unpaired begins are closed at the end of the interval
+		std::vector<TraceBuffer::Event> Events = Buffer->GetEvents(MinTime);
+		std::vector<TraceBuffer::Event> OpenEvents;
+
+		const auto WriteCompleteEvent = [&](const TraceBuffer::Event& Begin, unsigned long long EndTime)
+		{
+			const char* Name = Begin.Name;
+			if (Begin.Type == TraceEventType::SleepBegin)
+			{
+				Name = "Asleep";
+			}
+			else if (Begin.Type == TraceEventType::TickBegin)
+			{
+				Name = "Tick";
+			}
+
+			Json << (bFirstEvent ? "" : ",") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << ThreadId << ",\"name\":";
+			WriteJsonString(Json, Name != nullptr ? Name : "Task");
+			Json << ",\"ts\":" << (Begin.Time - MinTime) / 1000.0 << ",\"dur\":" << (EndTime - Begin.Time) / 1000.0 << "}";
+			bFirstEvent = false;
+		};
+
+		for (size_t j = 0; j < Events.size(); j++)
+		{
+			const TraceBuffer::Event& CurrentEvent = Events[j];
+
+			switch (CurrentEvent.Type)
+			{
+			case TraceEventType::TaskBegin:
+			case TraceEventType::SleepBegin:
+			case TraceEventType::TickBegin:
+			case TraceEventType::TickPhaseBegin:
+				OpenEvents.push_back(CurrentEvent);
+				break;
+
+			case TraceEventType::TaskEnd:
+			case TraceEventType::SleepEnd:
+			case TraceEventType::TickEnd:
+			case TraceEventType::TickPhaseEnd:
+				// Each end type directly follows its begin type in the enumeration
+				if (!OpenEvents.empty() && static_cast<int>(OpenEvents.back().Type) + 1 == static_cast<int>(CurrentEvent.Type))
+				{
+					WriteCompleteEvent(OpenEvents.back(), CurrentEvent.Time);
+					OpenEvents.pop_back();
+				}
+				break;
+
+			case TraceEventType::Steal:
+				Json << (bFirstEvent ? "" : ",") << "{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << ThreadId << ",\"name\":";
+				WriteJsonString(Json, CurrentEvent.Name != nullptr ? CurrentEvent.Name : "Steal");
+				Json << ",\"ts\":" << (CurrentEvent.Time - MinTime) / 1000.0 << "}";
+				bFirstEvent = false;
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		while (!OpenEvents.empty())
+		{
+			WriteCompleteEvent(OpenEvents.back(), Now);
+			OpenEvents.pop_back();
+		}
+	}
+
+	Json << "]}";
+
+	return Json.str();
+}
+
+bool TaskTracer::DumpChromeTrace(const std::string& FilePath, float LastSeconds)
+{
+	std::ofstream File(FilePath, std::ios::out | std::ios::trunc);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	File << GetChromeTraceJson(LastSeconds);
+
+	return static_cast<bool>(File);
+}
+
+TraceBuffer* TaskTracer::AcquireThreadBuffer()
+{
+	std::lock_guard<std::mutex> Lock(BuffersMutex);
+
+	if (!FreeBuffers.empty())
+	{
+		ThreadBuffer = FreeBuffers.back();
+		FreeBuffers.pop_back();
+	}
+	else
+	{
+		ThreadBuffer = new TraceBuffer(GetBufferCapacity(), static_cast<unsigned int>(Buffers.size() + 1));
+		Buffers.push_back(ThreadBuffer);
+	}
+
+	// Using the owner makes sure that the buffer is released when the thread finishes
+	ThreadBufferOwner.bOwnsBuffer = true;
+
+	return ThreadBuffer;
+}
+
+void TaskTracer::ReleaseThreadBuffer()
+{
+	if (ThreadBuffer == nullptr)
+	{
+		return;
+	}
+
+	ThreadBuffer->SetThreadName("");
+
+	std::lock_guard<std::mutex> Lock(BuffersMutex);
+	FreeBuffers.push_back(ThreadBuffer);
+	ThreadBuffer = nullptr;
+}
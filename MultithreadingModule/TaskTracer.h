@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "MultithreadingConfig.h"
+
+enum class TraceEventType : unsigned char
+{
+	TaskBegin,
+	TaskEnd,
+	SleepBegin,
+	SleepEnd,
+	Steal,
+	TickBegin,
+	TickEnd,
+	TickPhaseBegin,
+	TickPhaseEnd
+};
+
+// Ring buffer of trace events of one thread
+// Only the owning thread writes, readers copy the events without blocking it
+class TraceBuffer final
+{
+private:
+	// The fields are atomic only so that a reader never sees a torn value, all accesses are relaxed
+	struct TraceEvent
+	{
+		std::atomic<unsigned long long> Time;
+		std::atomic<const char*> Name;
+		std::atomic<TraceEventType> Type;
+	};
+
+	TraceEvent* Events;
+	unsigned long long Capacity;
+
+	std::atomic<unsigned long long> NumOfWrittenEvents;
+
+	unsigned int ThreadId;
+
+	std::string ThreadName;
+	std::mutex ThreadNameMutex;
+
+public:
+	// Event copied from the buffer
+	struct Event
+	{
+		unsigned long long Time;
+		const char* Name;
+		TraceEventType Type;
+	};
+
+	// @param NewCapacity - Number of events kept in the buffer, rounded up to a power of two
+	// @param NewThreadId - Identifier of the thread in the trace
+	TraceBuffer(unsigned int NewCapacity, unsigned int NewThreadId);
+	~TraceBuffer();
+
+	TraceBuffer(const TraceBuffer&) = delete;
+	TraceBuffer& operator=(const TraceBuffer&) = delete;
+
+	// Writes an event, overwriting the oldest one if the buffer is full
+	void Write(TraceEventType Type, const char* Name, unsigned long long Time)
+	{
+		const unsigned long long Index = NumOfWrittenEvents.load(std::memory_order_relaxed);
+		TraceEvent& Slot = Events[Index & (Capacity - 1)];
+
+		// A reader that sees any field of this event after its acquire fence also sees the counter at least at Index
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Slot.Time.store(Time, std::memory_order_relaxed);
+		Slot.Name.store(Name, std::memory_order_relaxed);
+		Slot.Type.store(Type, std::memory_order_relaxed);
+
+		NumOfWrittenEvents.store(Index + 1, std::memory_order_release);
+	}
+
+	// Copies the events written not earlier than the given time, from oldest to newest
+	// @param MinTime - Time in nanoseconds from GetTraceTime
+	std::vector<Event> GetEvents(unsigned long long MinTime);
+
+	unsigned int GetThreadId();
+
+	void SetThreadName(const std::string& NewThreadName);
+	std::string GetThreadName();
+};
+
+// Records task, sleep, steal and Tick events of all threads into preallocated per-thread ring buffers
+// and exports them in the Chrome Trace Event format, which can also be opened in Perfetto
+class TaskTracer final
+{
+private:
+	static std::atomic<bool> bEnabled;
+
+	static unsigned int BufferCapacity;
+	static std::mutex BufferCapacityMutex;
+
+	// All buffers ever created, they are never destroyed so that the events of finished threads can still be exported
+	static std::vector<TraceBuffer*> Buffers;
+	// Buffers of finished threads, they are reused by new threads
+	static std::vector<TraceBuffer*> FreeBuffers;
+	static std::mutex BuffersMutex;
+
+	static thread_local TraceBuffer* ThreadBuffer;
+
+public:
+	TaskTracer() = delete;
+
+	// Records an event of the current thread
+	// @param Type - Type of the event
+	// @param Name - Static string describing the event, it must stay valid until the trace is exported
+	static void Record(TraceEventType Type, const char* Name)
+	{
+#if MULTITHREADING_ENABLE_TRACING
+		if (!bEnabled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		TraceBuffer* Buffer = ThreadBuffer;
+		if (Buffer == nullptr)
+		{
+			Buffer = AcquireThreadBuffer();
+		}
+
+		Buffer->Write(Type, Name, GetTraceTime());
+#endif
+	}
+
+	// Records an event of the current thread with an already taken timestamp
+	// @param Type - Type of the event
+	// @param Name - Static string describing the event, it must stay valid until the trace is exported
+	// @param Time - Time of the event from GetTraceTime
+	static void Record(TraceEventType Type, const char* Name, unsigned long long Time)
+	{
+#if MULTITHREADING_ENABLE_TRACING
+		if (!bEnabled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		TraceBuffer* Buffer = ThreadBuffer;
+		if (Buffer == nullptr)
+		{
+			Buffer = AcquireThreadBuffer();
+		}
+
+		Buffer->Write(Type, Name, Time);
+#endif
+	}
+
+	// Sets the name under which the current thread is shown in the trace
+	// @param ThreadName - Name of the thread
+	static void SetThreadName(const std::string& ThreadName);
+
+	// Enables or disables the recording of events
+	// @param bNewState - new state value
+	static void SetEnabled(bool bNewState);
+	// Returns true if events are recorded
+	static bool IsEnabled();
+
+	// Sets the number of events kept per thread, it applies to buffers created after the call
+	// @param NewCapacity - Updated capacity
+	static void SetBufferCapacity(unsigned int NewCapacity);
+	// Returns the number of events kept per thread
+	static unsigned int GetBufferCapacity();
+
+	// Returns the events of the last seconds in the Chrome Trace Event JSON format
+	// @param LastSeconds - Length of the exported time interval
+	static std::string GetChromeTraceJson(float LastSeconds);
+	// Writes the events of the last seconds to a file in the Chrome Trace Event JSON format
+	// @param FilePath - Path to the file
+	// @param LastSeconds - Length of the exported time interval
+	// @return false if the file could not be written
+	static bool DumpChromeTrace(const std::string& FilePath, float LastSeconds);
+
+	// Returns the current time in nanoseconds
+	static unsigned long long GetTraceTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+private:
+	static TraceBuffer* AcquireThreadBuffer();
+	static void ReleaseThreadBuffer();
+
+	friend class TraceBufferOwner;
+};
@@ -0,0 +1 @@
+#include "ThreadBatchTickTask.h"
@@ -0,0 +1,93 @@
+#pragma once
+#include <functional>
+#include <tuple>
+#include <utility>
+#include "ThreadBatchTickTaskBase.h"
+
+// Tick task that updates contiguous arrays of elements, for example the components of many objects in structure-of-arrays layout
+// One batch task replaces a Tick task per object: the threads share its chunks, and the kernel loops over a plain range,
+// so there is no per-object task, mutex or virtual call, and the loop can be vectorized by the compiler
+//
+// ThreadBatchTickTask<float, const float> Task(NumOfObjects, Positions, Velocities,
+//     [](size_t Begin, size_t End, float* Positions, const float* Velocities, const float& DeltaTime)
+//     {
+//         for (size_t i = Begin; i < End; i++) Positions[i] += Velocities[i] * DeltaTime;
+//     });
+template<typename... Types>
+class ThreadBatchTickTask final : public ThreadBatchTickTaskBase
+{
+public:
+	// Processes the elements [Begin, End) of the arrays, it is called for different chunks on several threads at once
+	typedef std::function<void(size_t Begin, size_t End, Types*... Arrays, const float& DeltaTime)> BatchKernel;
+
+private:
+	const BatchKernel Kernel;
+
+	size_t Size;
+	std::tuple<Types*...> Arrays;
+	std::mutex ArraysMutex;
+
+	// Arrays of the current Tick, read by the chunks without locking
+	std::tuple<Types*...> TickArrays;
+
+	template<size_t... Indices>
+	void CallKernel(size_t Begin, size_t End, const float& DeltaTime, std::index_sequence<Indices...>);
+
+protected:
+	size_t PrepareTick() override;
+
+public:
+	ThreadBatchTickTask() = delete;
+
+	// @param NewSize - number of elements in each array
+	// @param NewArrays - arrays of the same length
+	// @param NewKernel - function that processes a chunk
+	// @param NewChunkSize - number of elements per chunk, 0 - chosen by the number of threads
+	ThreadBatchTickTask(size_t NewSize, Types*... NewArrays, const BatchKernel& NewKernel, size_t NewChunkSize = 0) :
+		ThreadBatchTickTaskBase(NewChunkSize), Kernel(NewKernel), Size(NewSize), Arrays(NewArrays...), TickArrays(NewArrays...) {}
+
+	// Replaces the arrays, for example after a container has grown, they are used from the next Tick
+	// @param NewSize - number of elements in each array
+	// @param NewArrays - arrays of the same length
+	void SetArrays(size_t NewSize, Types*... NewArrays);
+	// Returns the number of elements in each array
+	size_t GetSize();
+
+	void ExecuteChunk(size_t Begin, size_t End, const float& DeltaTime) override;
+};
+
+template<typename... Types>
+template<size_t... Indices>
+inline void ThreadBatchTickTask<Types...>::CallKernel(size_t Begin, size_t End, const float& DeltaTime, std::index_sequence<Indices...>)
+{
+	Kernel(Begin, End, std::get<Indices>(TickArrays)..., DeltaTime);
+}
+
+template<typename... Types>
+inline size_t ThreadBatchTickTask<Types...>::PrepareTick()
+{
+	std::lock_guard<std::mutex> Lock(ArraysMutex);
+	TickArrays = Arrays;
+	return Size;
+}
+
+template<typename... Types>
+inline void ThreadBatchTickTask<Types...>::SetArrays(size_t NewSize, Types*... NewArrays)
+{
+	std::lock_guard<std::mutex> Lock(ArraysMutex);
+	Size = NewSize;
+	Arrays = std::tuple<Types*...>(NewArrays...);
+}
+
+template<typename... Types>
+inline size_t ThreadBatchTickTask<Types...>::GetSize()
+{
+	std::lock_guard<std::mutex> Lock(ArraysMutex);
+	return Size;
+}
+
+template<typename... Types>
+inline void ThreadBatchTickTask<Types...>::ExecuteChunk(size_t Begin, size_t End, const float& DeltaTime)
+{
+	CallKernel(Begin, End, DeltaTime, std::index_sequence_for<Types...>());
+}
@@ -0,0 +1,98 @@
+#include "ThreadBatchTickTaskBase.h"
+#include <exception>
+
+void ThreadBatchTickChunk::SetRange(size_t NewBegin, size_t NewEnd)
+{
+	Begin = NewBegin;
+	End = NewEnd;
+}
+
+void ThreadBatchTickChunk::Execute(const float& DeltaTime)
+{
+	try
+	{
+		// The schedule belongs to the batch task
+		Batch->ExecuteChunk(Begin, End, Batch->GetTickDeltaTime(DeltaTime));
+	}
+	catch (...)
+	{
+		// The handles follow the batch task, the chunk only passes the exception on to the thread
+		Batch->ReportException(std::current_exception());
+		throw;
+	}
+}
+
+
+ThreadBatchTickTaskBase::~ThreadBatchTickTaskBase()
+{
+	for (size_t i = 0; i < Chunks.size(); i++)
+	{
+		delete Chunks[i];
+	}
+	Chunks.clear();
+}
+
+void ThreadBatchTickTaskBase::Execute(const float& DeltaTime)
+{
+	const size_t Size = PrepareTick();
+	if (Size != 0)
+	{
+		ExecuteChunk(0, Size, DeltaTime);
+	}
+}
+
+void ThreadBatchTickTaskBase::PushTickEntries(std::queue<ThreadTask*>& Entries, unsigned int NumOfThreads)
+{
+	const size_t Size = PrepareTick();
+	if (Size == 0)
+	{
+		return;
+	}
+
+	size_t NumOfElementsPerChunk = GetChunkSize();
+	if (NumOfElementsPerChunk == 0)
+	{
+		const size_t NumOfChunks = static_cast<size_t>(NumOfThreads != 0 ? NumOfThreads : 1) * ChunksPerThread;
+		NumOfElementsPerChunk = (Size + NumOfChunks - 1) / NumOfChunks;
+		if (NumOfElementsPerChunk < MinAutoChunkSize)
+		{
+			NumOfElementsPerChunk = MinAutoChunkSize;
+		}
+	}
+
+	const size_t NumOfChunks = (Size + NumOfElementsPerChunk - 1) / NumOfElementsPerChunk;
+	while (Chunks.size() < NumOfChunks)
+	{
+		Chunks.push_back(new ThreadBatchTickChunk(this));
+	}
+
+	// Chunks share the properties of the task, so that traces, statistics and blocking treat them alike
+	const char* TaskName = GetName();
+	const bool bTaskBlocking = GetBlocking();
+	const unsigned long long TaskEnqueueTime = GetEnqueueTime();
+
+	for (size_t i = 0; i < NumOfChunks; i++)
+	{
+		const size_t Begin = i * NumOfElementsPerChunk;
+		const size_t End = Begin + NumOfElementsPerChunk < Size ? Begin + NumOfElementsPerChunk : Size;
+
+		ThreadBatchTickChunk* Chunk = Chunks[i];
+		Chunk->SetRange(Begin, End);
+		Chunk->SetName(TaskName);
+		Chunk->SetBlocking(bTaskBlocking);
+		Chunk->SetEnqueueTime(TaskEnqueueTime);
+		Entries.push(Chunk);
+	}
+}
+
+void ThreadBatchTickTaskBase::SetChunkSize(size_t NewChunkSize)
+{
+	std::lock_guard<std::mutex> Lock(ChunkSizeMutex);
+	ChunkSize = NewChunkSize;
+}
+
+size_t ThreadBatchTickTaskBase::GetChunkSize()
+{
+	std::lock_guard<std::mutex> Lock(ChunkSizeMutex);
+	return ChunkSize;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include "ThreadTask.h"
+
+class ThreadBatchTickTaskBase;
+
+
+// One chunk of a batch Tick task, queued by the manager in place of the task
+class ThreadBatchTickChunk final : public ThreadTask
+{
+private:
+	ThreadBatchTickTaskBase* Batch;
+
+	// Set when the chunk is queued, under the mutex of the queue, so they have no mutex of their own
+	size_t Begin;
+	size_t End;
+
+public:
+	ThreadBatchTickChunk() = delete;
+	// @param NewBatch - the task that the chunk belongs to
+	explicit ThreadBatchTickChunk(ThreadBatchTickTaskBase* NewBatch) :
+		ThreadTask(false, TaskRepeatability::EveryTick, false), Batch(NewBatch), Begin(0), End(0) {}
+
+	// Sets the elements processed by the chunk
+	// @param NewBegin - first element
+	// @param NewEnd - element after the last one
+	void SetRange(size_t NewBegin, size_t NewEnd);
+
+	void Execute(const float& DeltaTime) override;
+};
+
+
+// Tick task that processes a contiguous range of elements in chunks, each chunk is executed by one thread
+// Derived classes process one chunk, see ThreadBatchTickTask
+class ThreadBatchTickTaskBase : public ThreadTask
+{
+private:
+	// Number of elements per chunk, 0 - chosen by the number of threads
+	size_t ChunkSize;
+	std::mutex ChunkSizeMutex;
+
+	// Reused between Ticks, they are changed only while the chunks of the previous Tick are completed
+	std::vector<ThreadBatchTickChunk*> Chunks;
+
+protected:
+	// Called before the chunks are queued, takes the elements processed during this Tick
+	// @return number of elements
+	virtual size_t PrepareTick() = 0;
+
+public:
+	// Number of chunks per thread when the chunk size is chosen automatically
+	static const unsigned int ChunksPerThread = 4;
+	// Lower limit of an automatically chosen chunk, so that small arrays are not split into tiny chunks
+	static const size_t MinAutoChunkSize = 64;
+
+	ThreadBatchTickTaskBase() = delete;
+	// @param NewChunkSize - number of elements per chunk, 0 - chosen by the number of threads
+	explicit ThreadBatchTickTaskBase(size_t NewChunkSize) :
+		ThreadTask(false, TaskRepeatability::EveryTick, false), ChunkSize(NewChunkSize) {}
+
+	// Deletes the chunks
+	virtual ~ThreadBatchTickTaskBase();
+
+	// Processes all elements on the calling thread
+	void Execute(const float& DeltaTime) override;
+
+	// Processes the elements [Begin, End) taken by the last PrepareTick
+	// Called for different chunks on several threads at once
+	// @param Begin - first element
+	// @param End - element after the last one
+	// @param DeltaTime - Tick delta time
+	virtual void ExecuteChunk(size_t Begin, size_t End, const float& DeltaTime) = 0;
+
+	// Puts the chunks of the elements into the queue instead of the task
+	void PushTickEntries(std::queue<ThreadTask*>& Entries, unsigned int NumOfThreads) override;
+
+	// Sets the number of elements per chunk, it is applied from the next Tick
+	// @param NewChunkSize - number of elements, 0 - chosen by the number of threads
+	void SetChunkSize(size_t NewChunkSize);
+	size_t GetChunkSize();
+};
@@ -24,7 +24,7 @@ void ThreadFunctionTask::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackFunction();
+			RunCallback(CallbackFunction);
 		}
 
 		return;
@@ -49,7 +49,7 @@ void ThreadFunctionTask::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackFunction();
+			RunCallback(CallbackFunction);
 		}
 
 		return;
@@ -74,7 +74,7 @@ void ThreadFunctionTask::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackFunction();
+			RunCallback(CallbackFunction);
 		}
 	}
 }
@@ -14,7 +14,7 @@ void ThreadInterfaceTask::Execute(const float& DeltaTime)
 		Object->ThreadExecuteDedicated(ExecutionStopSignal);
 		if (GetNeedCallback())
 		{
-			Object->ThreadCallbackDedicated();
+			RunCallback(std::bind(&MultithreadingInterface::ThreadCallbackDedicated, Object));
 		}
 
 		return;
@@ -25,7 +25,7 @@ void ThreadInterfaceTask::Execute(const float& DeltaTime)
 		Object->ThreadExecute();
 		if (GetNeedCallback())
 		{
-			Object->ThreadCallback();
+			RunCallback(std::bind(&MultithreadingInterface::ThreadCallback, Object));
 		}
 
 		return;
@@ -36,7 +36,7 @@ void ThreadInterfaceTask::Execute(const float& DeltaTime)
 		Object->ThreadExecuteTick(DeltaTime);
 		if (GetNeedCallback())
 		{
-			Object->ThreadCallbackTick();
+			RunCallback(std::bind(&MultithreadingInterface::ThreadCallbackTick, Object));
 		}
 	}
 }
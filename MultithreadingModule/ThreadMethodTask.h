@@ -68,7 +68,7 @@ inline void ThreadMethodTask<Class>::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackMethod(*Obj);
+			RunCallback(std::bind(CallbackMethod, std::ref(*Obj)));
 		}
 
 		return;
@@ -93,7 +93,7 @@ inline void ThreadMethodTask<Class>::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackMethod(*Obj);
+			RunCallback(std::bind(CallbackMethod, std::ref(*Obj)));
 		}
 
 		return;
@@ -118,7 +118,7 @@ inline void ThreadMethodTask<Class>::Execute(const float& DeltaTime)
 
 		if (GetNeedCallback())
 		{
-			CallbackMethod(*Obj);
+			RunCallback(std::bind(CallbackMethod, std::ref(*Obj)));
 		}
 	}
 }
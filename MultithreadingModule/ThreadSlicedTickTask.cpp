@@ -0,0 +1,133 @@
+#include "ThreadSlicedTickTask.h"
+#include <chrono>
+
+void ThreadSlicedTickTask::Execute(const float&)
+{
+	std::lock_guard<std::mutex> LockFunction(FunctionMutex);
+	std::lock_guard<std::mutex> LockCallback(CallbackFunctionMutex);
+
+	if (!StepFunction)
+	{
+		return;
+	}
+
+	if (GetNeedCallback())
+	{
+		if (!CallbackFunction)
+		{
+			return;
+		}
+	}
+
+	const unsigned int SliceTimeBudget = GetTimeBudget();
+	const unsigned int SliceStepBudget = GetStepBudget();
+	const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(SliceTimeBudget);
+
+	unsigned int NumOfSliceSteps = 0;
+	bool bCompleted = false;
+	while (true)
+	{
+		bCompleted = StepFunction();
+		NumOfSliceSteps++;
+
+		if (bCompleted)
+		{
+			break;
+		}
+		if (SliceStepBudget != 0 && NumOfSliceSteps >= SliceStepBudget)
+		{
+			break;
+		}
+		if (SliceTimeBudget != 0 && std::chrono::steady_clock::now() >= Deadline)
+		{
+			break;
+		}
+	}
+
+	std::unique_lock<std::mutex> LockProgress(ProgressMutex);
+	NumOfSteps += NumOfSliceSteps;
+	NumOfFrames++;
+
+	if (!bCompleted)
+	{
+		return;
+	}
+
+	LastNumOfSteps = NumOfSteps;
+	LastNumOfFrames = NumOfFrames;
+	NumOfCompletedRuns++;
+	NumOfSteps = 0;
+	NumOfFrames = 0;
+
+	// The task stays registered without costing anything until Restart
+	// The state is changed under the mutex, so that a concurrent Restart is not lost
+	SetDormant(true);
+	LockProgress.unlock();
+
+	if (GetNeedCallback())
+	{
+		RunCallback(CallbackFunction);
+	}
+}
+
+void ThreadSlicedTickTask::Restart()
+{
+	std::lock_guard<std::mutex> LockProgress(ProgressMutex);
+	NumOfSteps = 0;
+	NumOfFrames = 0;
+	Wake();
+}
+
+void ThreadSlicedTickTask::SetBudget(unsigned int NewTimeBudget, unsigned int NewStepBudget)
+{
+	std::lock_guard<std::mutex> Lock(BudgetMutex);
+	TimeBudget = NewTimeBudget;
+	StepBudget = NewStepBudget;
+}
+
+unsigned int ThreadSlicedTickTask::GetTimeBudget()
+{
+	std::lock_guard<std::mutex> Lock(BudgetMutex);
+	return TimeBudget;
+}
+
+unsigned int ThreadSlicedTickTask::GetStepBudget()
+{
+	std::lock_guard<std::mutex> Lock(BudgetMutex);
+	return StepBudget;
+}
+
+bool ThreadSlicedTickTask::IsRunning()
+{
+	return !IsDormant();
+}
+
+unsigned long long ThreadSlicedTickTask::GetNumOfSteps()
+{
+	std::lock_guard<std::mutex> Lock(ProgressMutex);
+	return NumOfSteps;
+}
+
+unsigned int ThreadSlicedTickTask::GetNumOfFrames()
+{
+	std::lock_guard<std::mutex> Lock(ProgressMutex);
+	return NumOfFrames;
+}
+
+unsigned long long ThreadSlicedTickTask::GetLastNumOfSteps()
+{
+	std::lock_guard<std::mutex> Lock(ProgressMutex);
+	return LastNumOfSteps;
+}
+
+unsigned int ThreadSlicedTickTask::GetLastNumOfFrames()
+{
+	std::lock_guard<std::mutex> Lock(ProgressMutex);
+	return LastNumOfFrames;
+}
+
+unsigned long long ThreadSlicedTickTask::GetNumOfCompletedRuns()
+{
+	std::lock_guard<std::mutex> Lock(ProgressMutex);
+	return NumOfCompletedRuns;
+}
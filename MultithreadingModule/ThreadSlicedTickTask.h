@@ -0,0 +1,75 @@
+#pragma once
+#include <functional>
+#include "ThreadTask.h"
+
+// Tick task for work longer than one frame, for example rebuilding navigation data
+// Each Tick it executes steps of the work until the slice budget is used up, and continues from there in the next Tick,
+// so it never holds Tick longer than one slice. When the work is completed the task becomes dormant until Restart
+class ThreadSlicedTickTask final : public ThreadTask
+{
+private:
+	// Executes one step of the work, returns true when the whole work is completed
+	std::function<bool()> StepFunction;
+	// Called after the work is completed
+	std::function<void()> CallbackFunction;
+
+	std::mutex FunctionMutex;
+	std::mutex CallbackFunctionMutex;
+
+	// Limits of one slice, 0 - no limit, at least one step is executed in every slice
+	// Time in microseconds
+	unsigned int TimeBudget;
+	unsigned int StepBudget;
+	std::mutex BudgetMutex;
+
+	// Progress of the current run
+	unsigned long long NumOfSteps;
+	unsigned int NumOfFrames;
+	// Results of the completed runs
+	unsigned long long LastNumOfSteps;
+	unsigned int LastNumOfFrames;
+	unsigned long long NumOfCompletedRuns;
+	std::mutex ProgressMutex;
+
+public:
+	ThreadSlicedTickTask() = delete;
+
+	// Callback = false, Repeatability = Tick, OnDedicated = false
+	// @param NewStepFunction - executes one step of the work, returns true when the whole work is completed
+	// @param NewTimeBudget - time of one slice in microseconds, 0 - no limit
+	// @param NewStepBudget - number of steps in one slice, 0 - no limit
+	ThreadSlicedTickTask(std::function<bool()> NewStepFunction, unsigned int NewTimeBudget, unsigned int NewStepBudget) :
+		ThreadTask(false, TaskRepeatability::EveryTick, false), StepFunction(NewStepFunction), TimeBudget(NewTimeBudget), StepBudget(NewStepBudget),
+		NumOfSteps(0), NumOfFrames(0), LastNumOfSteps(0), LastNumOfFrames(0), NumOfCompletedRuns(0) {}
+	// Callback = true, Repeatability = Tick, OnDedicated = false
+	// The callback is called once after each completed run
+	ThreadSlicedTickTask(std::function<bool()> NewStepFunction, std::function<void()> NewCallbackFunction, unsigned int NewTimeBudget, unsigned int NewStepBudget) :
+		ThreadTask(true, TaskRepeatability::EveryTick, false), StepFunction(NewStepFunction), CallbackFunction(NewCallbackFunction), TimeBudget(NewTimeBudget), StepBudget(NewStepBudget),
+		NumOfSteps(0), NumOfFrames(0), LastNumOfSteps(0), LastNumOfFrames(0), NumOfCompletedRuns(0) {}
+
+	void Execute(const float& DeltaTime) override;
+
+	// Starts a new run of the work from the next Tick
+	// The state of the work belongs to the step function, it must be prepared for the new run before the call
+	void Restart();
+
+	// Sets the limits of one slice, they are applied from the next Tick
+	// @param NewTimeBudget - time of one slice in microseconds, 0 - no limit
+	// @param NewStepBudget - number of steps in one slice, 0 - no limit
+	void SetBudget(unsigned int NewTimeBudget, unsigned int NewStepBudget);
+	unsigned int GetTimeBudget();
+	unsigned int GetStepBudget();
+
+	// Returns true while the work is not completed
+	bool IsRunning();
+	// Returns the number of steps executed in the current run
+	unsigned long long GetNumOfSteps();
+	// Returns the number of Ticks spent on the current run
+	unsigned int GetNumOfFrames();
+	// Returns the number of steps of the last completed run
+	unsigned long long GetLastNumOfSteps();
+	// Returns the number of Ticks the last completed run took
+	unsigned int GetLastNumOfFrames();
+	// Returns the number of completed runs
+	unsigned long long GetNumOfCompletedRuns();
+};
@@ -0,0 +1 @@
+#include "ThreadStaticInterfaceTask.h"
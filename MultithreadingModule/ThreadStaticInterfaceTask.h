@@ -0,0 +1,115 @@
+#pragma once
+#include <type_traits>
+#include "ThreadTask.h"
+#include "MultithreadingStaticInterface.h"
+
+// Task that calls the hooks of a MultithreadingStaticInterface type directly
+// The kind of the task is a template parameter, so Execute has no virtual calls to the object, no locking and no branches on the kind
+// @param Derived - type derived from MultithreadingStaticInterface<Derived>
+// @param ExecutionRepeatability - Once or EveryTick
+// @param bOnDedicated - true to execute ThreadExecuteDedicated on a dedicated thread, only with Once
+template<typename Derived, TaskRepeatability ExecutionRepeatability = TaskRepeatability::Once, bool bOnDedicated = false>
+class ThreadStaticInterfaceTask final : public ThreadTask
+{
+private:
+	static_assert(std::is_base_of<MultithreadingStaticInterface<Derived>, Derived>::value, "The type must derive from MultithreadingStaticInterface<Type>");
+	static_assert(!bOnDedicated || ExecutionRepeatability == TaskRepeatability::Once, "Dedicated tasks are executed once");
+	static_assert(bOnDedicated || ExecutionRepeatability != TaskRepeatability::Once || HasThreadExecute<Derived>::value, "The type does not define ThreadExecute()");
+	static_assert(ExecutionRepeatability != TaskRepeatability::EveryTick || HasThreadExecuteTick<Derived>::value, "The type does not define ThreadExecuteTick(const float&)");
+	static_assert(!bOnDedicated || HasThreadExecuteDedicated<Derived>::value, "The type does not define ThreadExecuteDedicated(const TaskStopSignal&)");
+
+	// Selects the hooks of the task
+	typedef std::integral_constant<int, bOnDedicated ? 2 : (ExecutionRepeatability == TaskRepeatability::EveryTick ? 1 : 0)> HookKind;
+	typedef std::integral_constant<int, 0> OnceHooks;
+	typedef std::integral_constant<int, 1> TickHooks;
+	typedef std::integral_constant<int, 2> DedicatedHooks;
+
+	// True if the type defines the callback of the task
+	typedef std::integral_constant<bool, bOnDedicated ? HasThreadCallbackDedicated<Derived>::value :
+		(ExecutionRepeatability == TaskRepeatability::EveryTick ? HasThreadCallbackTick<Derived>::value : HasThreadCallback<Derived>::value)> HasCallback;
+
+	// Set once in the constructor, so it needs no mutex
+	Derived* const Object;
+
+	void ExecuteHook(const float& DeltaTime, OnceHooks);
+	void ExecuteHook(const float& DeltaTime, TickHooks);
+	void ExecuteHook(const float& DeltaTime, DedicatedHooks);
+
+	// Only the hooks of the kind of the task are instantiated, so the type does not have to define the others
+	void CallbackHook(std::false_type);
+	void CallbackHook(std::true_type);
+	void CallbackHook(OnceHooks);
+	void CallbackHook(TickHooks);
+	void CallbackHook(DedicatedHooks);
+
+public:
+	ThreadStaticInterfaceTask() = delete;
+
+	// Callback is needed if the type defines it
+	explicit ThreadStaticInterfaceTask(Derived* NewTaskObject) :
+		ThreadTask(HasCallback::value, ExecutionRepeatability, bOnDedicated), Object(NewTaskObject) {}
+
+	void Execute(const float& DeltaTime) override;
+};
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::Execute(const float& DeltaTime)
+{
+	if (Object == nullptr)
+	{
+		return;
+	}
+
+	ExecuteHook(DeltaTime, HookKind());
+	CallbackHook(HasCallback());
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::ExecuteHook(const float&, OnceHooks)
+{
+	Object->ThreadExecute();
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::ExecuteHook(const float& DeltaTime, TickHooks)
+{
+	Object->ThreadExecuteTick(DeltaTime);
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::ExecuteHook(const float&, DedicatedHooks)
+{
+	Object->ThreadExecuteDedicated(ExecutionStopSignal);
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::CallbackHook(std::false_type)
+{
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::CallbackHook(std::true_type)
+{
+	CallbackHook(HookKind());
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::CallbackHook(OnceHooks)
+{
+	Derived* const CallbackObject = Object;
+	RunCallback([CallbackObject]() { CallbackObject->ThreadCallback(); });
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::CallbackHook(TickHooks)
+{
+	Derived* const CallbackObject = Object;
+	RunCallback([CallbackObject]() { CallbackObject->ThreadCallbackTick(); });
+}
+
+template<typename Derived, TaskRepeatability ExecutionRepeatability, bool bOnDedicated>
+inline void ThreadStaticInterfaceTask<Derived, ExecutionRepeatability, bOnDedicated>::CallbackHook(DedicatedHooks)
+{
+	Derived* const CallbackObject = Object;
+	RunCallback([CallbackObject]() { CallbackObject->ThreadCallbackDedicated(); });
+}
@@ -1,4 +1,24 @@
 #include "ThreadTask.h"
+#include "CallbackQueue.h"
+#include <cmath>
+
+std::atomic<unsigned int> ThreadTask::NumOfScheduledTasks(0);
+
+ThreadTask::~ThreadTask()
+{
+	std::lock_guard<std::mutex> Lock(CompletionStateMutex);
+	if (CompletionState != nullptr)
+	{
+		std::lock_guard<std::mutex> LockState(CompletionState->Mutex);
+		CompletionState->bCompleted = true;
+		CompletionState->CompletedCondition.notify_all();
+	}
+}
+
+void ThreadTask::PushTickEntries(std::queue<ThreadTask*>& Entries, unsigned int)
+{
+	Entries.push(this);
+}
 
 void ThreadTask::StopDedicatedExecution()
 {
@@ -22,3 +42,308 @@ bool ThreadTask::GetExecuteOnDedicatedThread()
 	std::lock_guard<std::mutex> Lock(ExecuteOnDedicatedThreadMutex);
 	return bExecuteOnDedicatedThread;
 }
+
+void ThreadTask::SetBlocking(bool bNewState)
+{
+	std::lock_guard<std::mutex> Lock(BlockingMutex);
+	bBlocking = bNewState;
+}
+
+bool ThreadTask::GetBlocking()
+{
+	std::lock_guard<std::mutex> Lock(BlockingMutex);
+	return bBlocking;
+}
+
+void ThreadTask::SetCallbackRouting(CallbackRouting NewRouting)
+{
+	std::lock_guard<std::mutex> Lock(RoutingMutex);
+	Routing = NewRouting;
+}
+
+CallbackRouting ThreadTask::GetCallbackRouting()
+{
+	std::lock_guard<std::mutex> Lock(RoutingMutex);
+	return Routing;
+}
+
+void ThreadTask::SetCallbackQueue(CallbackQueue* NewQueue)
+{
+	std::lock_guard<std::mutex> Lock(RoutingMutex);
+	DeferredCallbacks = NewQueue;
+}
+
+void ThreadTask::RunCallback(const std::function<void()>& Callback)
+{
+	std::unique_lock<std::mutex> Lock(RoutingMutex);
+	CallbackQueue* Queue = Routing == CallbackRouting::Deferred ? DeferredCallbacks : nullptr;
+	Lock.unlock();
+
+	// A deferred task executed outside of a pool has nowhere to post the callback
+	if (Queue == nullptr)
+	{
+		Callback();
+		return;
+	}
+
+	Queue->Push(Callback);
+}
+
+void ThreadTask::SetTickInterval(unsigned int NumOfTicks)
+{
+	std::lock_guard<std::mutex> Lock(TickScheduleMutex);
+	const unsigned int NewInterval = NumOfTicks != 0 ? NumOfTicks : 1;
+	TickPhase = NumOfScheduledTasks.fetch_add(1, std::memory_order_relaxed) % NewInterval;
+	TickInterval.store(NewInterval, std::memory_order_relaxed);
+}
+
+unsigned int ThreadTask::GetTickInterval()
+{
+	return TickInterval.load(std::memory_order_relaxed);
+}
+
+void ThreadTask::SetTickRate(float Rate)
+{
+	std::lock_guard<std::mutex> Lock(TickScheduleMutex);
+	const float NewRate = Rate > 0.0f ? Rate : 0.0f;
+
+	// The golden ratio sequence spreads any number of tasks evenly over the period
+	const unsigned int Index = NumOfScheduledTasks.fetch_add(1, std::memory_order_relaxed);
+	const float Fraction = static_cast<float>(std::fmod(Index * 0.6180339887, 1.0));
+	TickRateClock = NewRate > 0.0f ? Fraction / NewRate : 0.0f;
+	TickRate.store(NewRate, std::memory_order_relaxed);
+}
+
+float ThreadTask::GetTickRate()
+{
+	return TickRate.load(std::memory_order_relaxed);
+}
+
+void ThreadTask::SetDormant(bool bNewState)
+{
+	bDormant.store(bNewState, std::memory_order_relaxed);
+}
+
+void ThreadTask::Wake()
+{
+	SetDormant(false);
+}
+
+bool ThreadTask::IsDormant()
+{
+	return bDormant.load(std::memory_order_relaxed);
+}
+
+bool ThreadTask::ScheduleTick(float DeltaTime, unsigned long long TickIndex)
+{
+	if (bDormant.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	// Most tasks have no schedule and are executed every Tick
+	if (TickInterval.load(std::memory_order_relaxed) <= 1 && TickRate.load(std::memory_order_relaxed) <= 0.0f)
+	{
+		bScheduledTick = false;
+		return true;
+	}
+
+	std::lock_guard<std::mutex> Lock(TickScheduleMutex);
+	const unsigned int CurrentInterval = TickInterval.load(std::memory_order_relaxed);
+	const float CurrentRate = TickRate.load(std::memory_order_relaxed);
+	if (CurrentRate > 0.0f)
+	{
+		SkippedDeltaTime += DeltaTime;
+		TickRateClock += DeltaTime;
+
+		const float Period = 1.0f / CurrentRate;
+		if (TickRateClock < Period)
+		{
+			return false;
+		}
+
+		// A long Tick executes the task once, the rest of the time is not made up later
+		TickRateClock -= Period;
+		if (TickRateClock >= Period)
+		{
+			TickRateClock = std::fmod(TickRateClock, Period);
+		}
+	}
+	else if (CurrentInterval > 1)
+	{
+		SkippedDeltaTime += DeltaTime;
+
+		if ((TickIndex + TickPhase) % CurrentInterval != 0)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		bScheduledTick = false;
+		return true;
+	}
+
+	ScheduledDeltaTime = SkippedDeltaTime;
+	SkippedDeltaTime = 0.0f;
+	bScheduledTick = true;
+	return true;
+}
+
+float ThreadTask::GetTickDeltaTime(float DeltaTime)
+{
+	return bScheduledTick ? ScheduledDeltaTime : DeltaTime;
+}
+
+void ThreadTask::SetEnqueueTime(unsigned long long NewEnqueueTime)
+{
+	EnqueueTime = NewEnqueueTime;
+}
+
+unsigned long long ThreadTask::GetEnqueueTime()
+{
+	return EnqueueTime;
+}
+
+void ThreadTask::SetInternal(bool bNewState)
+{
+	bInternal = bNewState;
+}
+
+bool ThreadTask::IsInternal()
+{
+	return bInternal;
+}
+
+void ThreadTask::DeclareResource(const std::string& Resource, ResourceAccessMode Mode)
+{
+	std::lock_guard<std::mutex> Lock(ResourceAccessesMutex);
+	for (size_t i = 0; i < ResourceAccesses.size(); i++)
+	{
+		if (ResourceAccesses[i].Resource == Resource)
+		{
+			if (Mode == ResourceAccessMode::Write)
+			{
+				ResourceAccesses[i].Mode = Mode;
+			}
+			return;
+		}
+	}
+
+	ResourceAccesses.push_back(ResourceAccess(Resource, Mode));
+}
+
+void ThreadTask::DeclareRead(const std::string& Resource)
+{
+	DeclareResource(Resource, ResourceAccessMode::Read);
+}
+
+void ThreadTask::DeclareWrite(const std::string& Resource)
+{
+	DeclareResource(Resource, ResourceAccessMode::Write);
+}
+
+std::vector<ResourceAccess> ThreadTask::GetResourceAccesses()
+{
+	std::lock_guard<std::mutex> Lock(ResourceAccessesMutex);
+	return ResourceAccesses;
+}
+
+bool ThreadTask::HasResourceAccesses()
+{
+	std::lock_guard<std::mutex> Lock(ResourceAccessesMutex);
+	return !ResourceAccesses.empty();
+}
+
+void ThreadTask::SetSchedulePosition(const TickSchedulePosition& NewPosition)
+{
+	SchedulePosition = NewPosition;
+}
+
+TickSchedulePosition ThreadTask::GetSchedulePosition()
+{
+	return SchedulePosition;
+}
+
+void ThreadTask::SetName(const char* NewName)
+{
+	Name = NewName;
+}
+
+const char* ThreadTask::GetName()
+{
+	return Name;
+}
+
+TaskHandle ThreadTask::GetHandle()
+{
+	std::lock_guard<std::mutex> Lock(CompletionStateMutex);
+	CreateCompletionState();
+
+	return TaskHandle(CompletionState);
+}
+
+bool ThreadTask::ReportException(std::exception_ptr Exception)
+{
+	std::lock_guard<std::mutex> Lock(CompletionStateMutex);
+	if (CompletionState == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> LockState(CompletionState->Mutex);
+	if (CompletionState->Exception == nullptr)
+	{
+		CompletionState->Exception = Exception;
+	}
+	CompletionState->NumOfExceptions++;
+
+	return true;
+}
+
+void ThreadTask::SetCancellationToken(const CancellationToken& NewToken)
+{
+	Token = NewToken;
+	bHasToken.store(true, std::memory_order_release);
+}
+
+bool ThreadTask::IsCancelled()
+{
+	const std::atomic<bool>* HandleCancelled = HandleCancelledFlag.load(std::memory_order_acquire);
+	if (HandleCancelled != nullptr && HandleCancelled->load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+
+	return bHasToken.load(std::memory_order_acquire) && Token.IsCancelled();
+}
+
+void ThreadTask::SetTickTaskId(const TickTaskId& NewId)
+{
+	std::lock_guard<std::mutex> Lock(CompletionStateMutex);
+	CreateCompletionState();
+
+	std::lock_guard<std::mutex> LockState(CompletionState->Mutex);
+	CompletionState->TickTask = NewId;
+}
+
+TickTaskId ThreadTask::GetTickTaskId()
+{
+	std::lock_guard<std::mutex> Lock(CompletionStateMutex);
+	if (CompletionState == nullptr)
+	{
+		return TickTaskId();
+	}
+
+	std::lock_guard<std::mutex> LockState(CompletionState->Mutex);
+	return CompletionState->TickTask;
+}
+
+void ThreadTask::CreateCompletionState()
+{
+	if (CompletionState == nullptr)
+	{
+		CompletionState = std::make_shared<TaskCompletionState>();
+		HandleCancelledFlag.store(&CompletionState->bCancelled, std::memory_order_release);
+	}
+}
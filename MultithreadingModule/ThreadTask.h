@@ -1,8 +1,20 @@
 #pragma once
 #include <mutex>
+#include <atomic>
+#include <queue>
+#include <functional>
+#include <string>
+#include <vector>
 #include "MultithreadingInterface.h"
 #include "TaskRepeatability.h"
 #include "TaskStopSignal.h"
+#include "TaskHandle.h"
+#include "CancellationToken.h"
+#include "CallbackRouting.h"
+#include "ResourceAccess.h"
+#include "TickSchedule.h"
+
+class CallbackQueue;
 
 
 class ThreadTask
@@ -17,20 +29,99 @@ private:
 	bool bExecuteOnDedicatedThread;
 	std::mutex ExecuteOnDedicatedThreadMutex;
 
+	bool bBlocking;
+	std::mutex BlockingMutex;
+
+	// Deferred callbacks are posted to the queue of the pool that the task was added to
+	CallbackRouting Routing;
+	CallbackQueue* DeferredCallbacks;
+	std::mutex RoutingMutex;
+
+	// A Tick task is executed every TickInterval Ticks, or TickRate times per second if it is not 0
+	// They are atomic, so that tasks without a schedule are queued without locking; they are changed under TickScheduleMutex
+	std::atomic<unsigned int> TickInterval;
+	std::atomic<float> TickRate;
+	// Offset of the task within its interval, so that tasks with the same interval are spread across Ticks
+	unsigned int TickPhase;
+	// Time of the Ticks since the previous execution, and the clock by which the rate is followed
+	float SkippedDeltaTime;
+	float TickRateClock;
+	std::mutex TickScheduleMutex;
+
+	// Read for every Tick task in every Tick, so it is atomic
+	std::atomic<bool> bDormant;
+
+	// Time passed to a Tick task on a schedule during the current Tick
+	// They are changed only when the task is queued, under the mutex of the queue, so they have no mutex of their own
+	float ScheduledDeltaTime;
+	bool bScheduledTick;
+
+	// Counts the tasks given a schedule, to spread their phases
+	static std::atomic<unsigned int> NumOfScheduledTasks;
+
+	// Resources of the Tick task, by which the manager decides which tasks are executed in parallel
+	std::vector<ResourceAccess> ResourceAccesses;
+	std::mutex ResourceAccessesMutex;
+
+	// Adds the resource or raises its access to writing
+	void DeclareResource(const std::string& Resource, ResourceAccessMode Mode);
+
+	// Position of the Tick task in the schedule of the manager
+	// It is changed only by the schedule under the mutex of the Tick tasks, so it has no mutex of its own
+	TickSchedulePosition SchedulePosition;
+
+	// Time when the task was added to the execution queue, used for statistics
+	// It is changed only under the mutex of the queue that holds the task, so it has no mutex of its own
+	unsigned long long EnqueueTime;
+
+	// Set for Once tasks of TaskGroup, Pipeline and ParallelAlgorithms, which the overflow mode of the queue must not lose
+	// It is set before the task is queued, so it has no mutex
+	bool bInternal;
+
+	// Static name of the task shown in traces
+	const char* Name;
+
+	// Created by the first GetHandle call, so tasks without handles do not allocate it
+	std::shared_ptr<TaskCompletionState> CompletionState;
+	std::mutex CompletionStateMutex;
+	// Cancellation flag of the completion state, published once so that threads read it without locking
+	std::atomic<const std::atomic<bool>*> HandleCancelledFlag;
+
+	// A task without a token can only be cancelled through its handle
+	// The token is set before the task is added for execution, so it has no mutex
+	CancellationToken Token;
+	std::atomic<bool> bHasToken;
+
+	// Creates the completion state if the task does not have it yet, CompletionStateMutex must be locked
+	void CreateCompletionState();
+
 protected:
 	TaskStopSignal ExecutionStopSignal;
 
+	// Executes the callback of the task according to its routing
+	// @param Callback - the callback, it is copied if it is deferred
+	void RunCallback(const std::function<void()>& Callback);
+
 public:
 	// Callback = false, Repeatability = Once, OnDedicated = false
-	ThreadTask() : bNeedCallback(false), Repeatability(TaskRepeatability::Once), bExecuteOnDedicatedThread(false) {};
+	ThreadTask() : bNeedCallback(false), Repeatability(TaskRepeatability::Once), bExecuteOnDedicatedThread(false), bBlocking(false), Routing(CallbackRouting::Inline), DeferredCallbacks(nullptr),
+		TickInterval(1), TickRate(0.0f), TickPhase(0), SkippedDeltaTime(0.0f), TickRateClock(0.0f), bDormant(false), ScheduledDeltaTime(0.0f), bScheduledTick(false), EnqueueTime(0), bInternal(false), Name(nullptr), HandleCancelledFlag(nullptr), Token(nullptr), bHasToken(false) {};
 	ThreadTask(bool bNewTaskNeedCallback, TaskRepeatability NewTaskRepeatability, bool bOnDedicated):
-		bNeedCallback(bNewTaskNeedCallback), Repeatability(NewTaskRepeatability), bExecuteOnDedicatedThread(bOnDedicated) {};
+		bNeedCallback(bNewTaskNeedCallback), Repeatability(NewTaskRepeatability), bExecuteOnDedicatedThread(bOnDedicated), bBlocking(false), Routing(CallbackRouting::Inline), DeferredCallbacks(nullptr),
+		TickInterval(1), TickRate(0.0f), TickPhase(0), SkippedDeltaTime(0.0f), TickRateClock(0.0f), bDormant(false), ScheduledDeltaTime(0.0f), bScheduledTick(false), EnqueueTime(0), bInternal(false), Name(nullptr), HandleCancelledFlag(nullptr), Token(nullptr), bHasToken(false) {};
 	
-	virtual ~ThreadTask() {}
+	// Completes the handles of the task
+	virtual ~ThreadTask();
 
 
 	virtual void Execute(const float& DeltaTime) = 0;
 
+	// Puts the task into the queue of Tick tasks executed by the threads during Tick, used by the manager
+	// A batch task puts its chunks instead, so that the threads share it
+	// @param Entries - the queue, locked by the caller
+	// @param NumOfThreads - number of threads that execute the queue
+	virtual void PushTickEntries(std::queue<ThreadTask*>& Entries, unsigned int NumOfThreads);
+
 	virtual void StopDedicatedExecution() final;
 
 	
@@ -39,4 +130,130 @@ public:
 	virtual TaskRepeatability GetRepeatability() final;
 
 	virtual bool GetExecuteOnDedicatedThread() final;
+
+
+	// Marks the task as blocking, for example waiting for I/O
+	// While a standard thread executes a blocking task, the pool runs a compensating thread in its place
+	// Must be called before the task is added for execution
+	// @param bNewState - true if the task blocks
+	virtual void SetBlocking(bool bNewState) final;
+	// Returns true if the task is marked as blocking
+	virtual bool GetBlocking() final;
+
+
+	// Sets where the callback of the task is executed
+	// Must be called before the task is added for execution
+	// @param NewRouting - Inline or Deferred
+	virtual void SetCallbackRouting(CallbackRouting NewRouting) final;
+	virtual CallbackRouting GetCallbackRouting() final;
+
+	// Sets the queue that receives the deferred callbacks of the task, used by the manager
+	// @param NewQueue - the queue of the pool
+	virtual void SetCallbackQueue(CallbackQueue* NewQueue) final;
+
+
+	// Executes the Tick task every NumOfTicks Ticks instead of every Tick, it receives the time of all Ticks since its previous execution
+	// Tasks with the same interval are spread evenly across Ticks
+	// @param NumOfTicks - interval in Ticks, 0 and 1 - every Tick
+	virtual void SetTickInterval(unsigned int NumOfTicks) final;
+	virtual unsigned int GetTickInterval() final;
+
+	// Executes the Tick task about Rate times per second by the sum of the Tick delta times, it receives the time since its previous execution
+	// Tasks with the same rate are spread across Ticks
+	// @param Rate - executions per second, 0 - by the Tick interval
+	virtual void SetTickRate(float Rate) final;
+	virtual float GetTickRate() final;
+
+	// Makes the Tick task dormant, the manager skips it without queuing until Wake
+	// Can be called by the task itself when it has nothing to do, the time of the skipped Ticks is not accumulated
+	// @param bNewState - true to make the task dormant
+	virtual void SetDormant(bool bNewState) final;
+	// Returns the dormant Tick task to execution from the next Tick
+	virtual void Wake() final;
+	virtual bool IsDormant() final;
+
+	// Decides whether the Tick task is executed during the current Tick, used by the manager
+	// @param DeltaTime - Tick delta time
+	// @param TickIndex - number of the Tick
+	// @return false if the task is dormant or waits for its interval
+	virtual bool ScheduleTick(float DeltaTime, unsigned long long TickIndex) final;
+	// Returns the time passed to the Tick task during the current Tick
+	// @param DeltaTime - Tick delta time, returned for tasks executed every Tick
+	virtual float GetTickDeltaTime(float DeltaTime) final;
+
+
+	// Declares a resource that the Tick task reads, such as a component type or a named buffer
+	// Tick tasks that conflict over a resource are executed in sequence in the order of addition, the others in parallel
+	// Must be called before the task is added for execution
+	// @param Resource - name of the resource
+	virtual void DeclareRead(const std::string& Resource) final;
+	// Declares a resource that the Tick task writes, the task is executed apart from all other tasks that access it
+	// Must be called before the task is added for execution
+	// @param Resource - name of the resource
+	virtual void DeclareWrite(const std::string& Resource) final;
+
+	// Declares a type, for example a component type, as a resource that the Tick task reads
+	template<typename Type>
+	void DeclareRead() { DeclareRead(GetTypeResourceName<Type>()); }
+	// Declares a type, for example a component type, as a resource that the Tick task writes
+	template<typename Type>
+	void DeclareWrite() { DeclareWrite(GetTypeResourceName<Type>()); }
+
+	// Returns the declared resources, each resource once
+	virtual std::vector<ResourceAccess> GetResourceAccesses() final;
+	// Returns true if the task has declared at least one resource
+	virtual bool HasResourceAccesses() final;
+
+	// Sets the position of the task in the Tick schedule, used by the schedule
+	// @param NewPosition - position given by the schedule
+	virtual void SetSchedulePosition(const TickSchedulePosition& NewPosition) final;
+	// Returns the position of the task in the Tick schedule
+	virtual TickSchedulePosition GetSchedulePosition() final;
+
+
+	// Sets the time when the task was added to the execution queue
+	// @param NewEnqueueTime - Time in nanoseconds from GetStatisticsTime
+	virtual void SetEnqueueTime(unsigned long long NewEnqueueTime) final;
+
+	virtual unsigned long long GetEnqueueTime() final;
+
+	// Marks the task as added by the module itself, used by the manager
+	// @param bNewState - true if the task does not count against the capacity of the Once queue and is never blocked, rejected or dropped
+	virtual void SetInternal(bool bNewState) final;
+	virtual bool IsInternal() final;
+
+
+	// Sets the name of the task shown in traces
+	// Must be called before the task is added for execution
+	// @param NewName - Static string, it must stay valid until the trace is exported
+	virtual void SetName(const char* NewName) final;
+	// Returns the name of the task, or nullptr if the task has no name
+	virtual const char* GetName() final;
+
+
+	// Returns a handle that follows the completion of the task
+	// Must be called before the task is added for execution, because the task can be deleted right after execution
+	virtual TaskHandle GetHandle() final;
+
+	// Passes an exception thrown by the task to its handles
+	// @param Exception - the thrown exception
+	// @return false if the task has no handles
+	virtual bool ReportException(std::exception_ptr Exception) final;
+
+
+	// Adds the task to the group cancelled by the token
+	// Must be called before the task is added for execution
+	// @param NewToken - the token, the task keeps its own copy
+	virtual void SetCancellationToken(const CancellationToken& NewToken) final;
+
+	// Returns true if the task was cancelled through its handle or its token
+	// It does not lock, since threads check it for every task they take
+	virtual bool IsCancelled() final;
+
+
+	// Sets the identifier of the task in the Tick task registry, used by the manager
+	// @param NewId - identifier given by the registry
+	virtual void SetTickTaskId(const TickTaskId& NewId) final;
+	// Returns the identifier of the task in the Tick task registry
+	virtual TickTaskId GetTickTaskId() final;
 };
@@ -0,0 +1,174 @@
+#include "TickSchedule.h"
+#include "ThreadTask.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+const size_t TickSchedulePosition::None;
+
+void TickSchedule::Place(ThreadTask* Task, size_t Phase, size_t Order)
+{
+	if (Phase >= Phases.size())
+	{
+		Phases.resize(Phase + 1);
+	}
+
+	TickSchedulePosition Position;
+	Position.Phase = Phase;
+	Position.Index = Phases[Phase].size();
+	Position.Order = Order;
+	Task->SetSchedulePosition(Position);
+
+	Phases[Phase].push_back(Task);
+}
+
+void TickSchedule::Build()
+{
+	// Earliest phases in which the next reader and the next writer of each resource can be executed
+	struct ResourcePhases
+	{
+		size_t NextReadPhase;
+		size_t NextWritePhase;
+
+		ResourcePhases() : NextReadPhase(0), NextWritePhase(0) {}
+	};
+	std::unordered_map<std::string, ResourcePhases> Resources;
+
+	// Tasks without resources stay in the first phase, the vectors of the other phases keep their memory between builds
+	if (!Phases.empty())
+	{
+		std::vector<ThreadTask*>& FirstPhase = Phases[0];
+		size_t NumOfKept = 0;
+		for (size_t i = 0; i < FirstPhase.size(); i++)
+		{
+			TickSchedulePosition Position = FirstPhase[i]->GetSchedulePosition();
+			if (Position.Order == TickSchedulePosition::None)
+			{
+				Position.Index = NumOfKept;
+				FirstPhase[i]->SetSchedulePosition(Position);
+				FirstPhase[NumOfKept++] = FirstPhase[i];
+			}
+		}
+		FirstPhase.resize(NumOfKept);
+	}
+	for (size_t i = 1; i < Phases.size(); i++)
+	{
+		Phases[i].clear();
+	}
+
+	size_t NumOfOrderedTasks = 0;
+	for (size_t i = 0; i < OrderedTasks.size(); i++)
+	{
+		ThreadTask* Task = OrderedTasks[i];
+		if (Task == nullptr)
+		{
+			continue;
+		}
+		OrderedTasks[NumOfOrderedTasks] = Task;
+
+		const std::vector<ResourceAccess> Accesses = Task->GetResourceAccesses();
+
+		// A reader follows the last writer, a writer follows all earlier readers and writers
+		size_t Phase = 0;
+		for (size_t j = 0; j < Accesses.size(); j++)
+		{
+			const ResourcePhases& Current = Resources[Accesses[j].Resource];
+			Phase = std::max(Phase, Accesses[j].Mode == ResourceAccessMode::Write ? Current.NextWritePhase : Current.NextReadPhase);
+		}
+
+		for (size_t j = 0; j < Accesses.size(); j++)
+		{
+			ResourcePhases& Current = Resources[Accesses[j].Resource];
+			if (Accesses[j].Mode == ResourceAccessMode::Write)
+			{
+				Current.NextReadPhase = Phase + 1;
+				Current.NextWritePhase = Phase + 1;
+			}
+			else
+			{
+				Current.NextWritePhase = std::max(Current.NextWritePhase, Phase + 1);
+			}
+		}
+
+		Place(Task, Phase, NumOfOrderedTasks);
+		NumOfOrderedTasks++;
+	}
+	OrderedTasks.resize(NumOfOrderedTasks);
+
+	// Trailing phases left empty by removed tasks are dropped
+	while (!Phases.empty() && Phases.back().empty())
+	{
+		Phases.pop_back();
+	}
+
+	bPhasesValid = true;
+	NumOfBuilds++;
+}
+
+void TickSchedule::Add(ThreadTask* Task)
+{
+	if (!Task->HasResourceAccesses())
+	{
+		Place(Task, 0, TickSchedulePosition::None);
+		return;
+	}
+
+	// The task is placed by the next build
+	TickSchedulePosition Position;
+	Position.Order = OrderedTasks.size();
+	Task->SetSchedulePosition(Position);
+
+	OrderedTasks.push_back(Task);
+	bPhasesValid = false;
+}
+
+void TickSchedule::Remove(ThreadTask* Task)
+{
+	const TickSchedulePosition Position = Task->GetSchedulePosition();
+
+	// The last task of the phase takes the place of the removed one
+	if (Position.Phase != TickSchedulePosition::None)
+	{
+		std::vector<ThreadTask*>& Phase = Phases[Position.Phase];
+		ThreadTask* Moved = Phase.back();
+		Phase[Position.Index] = Moved;
+		Phase.pop_back();
+
+		if (Moved != Task)
+		{
+			TickSchedulePosition MovedPosition = Moved->GetSchedulePosition();
+			MovedPosition.Index = Position.Index;
+			Moved->SetSchedulePosition(MovedPosition);
+		}
+	}
+
+	if (Position.Order != TickSchedulePosition::None)
+	{
+		OrderedTasks[Position.Order] = nullptr;
+		bPhasesValid = false;
+	}
+
+	Task->SetSchedulePosition(TickSchedulePosition());
+}
+
+void TickSchedule::Clear()
+{
+	OrderedTasks.clear();
+	Phases.clear();
+	bPhasesValid = true;
+}
+
+const std::vector<std::vector<ThreadTask*>>& TickSchedule::GetPhases()
+{
+	if (!bPhasesValid)
+	{
+		Build();
+	}
+
+	return Phases;
+}
+
+unsigned long long TickSchedule::GetNumOfBuilds() const
+{
+	return NumOfBuilds;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+class ThreadTask;
+
+// Position of a Tick task in the schedule, kept by the task so that it is removed in O(1)
+struct TickSchedulePosition
+{
+	static const size_t None = static_cast<size_t>(-1);
+
+	// Phase of the task and its index within the phase, None until the task is placed
+	size_t Phase;
+	size_t Index;
+	// Index among the tasks that declare resources, None for tasks without resources
+	size_t Order;
+
+	TickSchedulePosition() : Phase(None), Index(0), Order(None) {}
+};
+
+// Splits the Tick tasks into phases by the resources that they declare
+// Tasks of one phase do not conflict and are executed in parallel, the phases are executed one after another
+// Two tasks conflict if one of them writes a resource that the other one reads or writes, the task added earlier is executed first
+// Tasks without declared resources conflict with nothing, they are put into the first phase without rebuilding the phases
+// The phases are rebuilt only after a task that declares resources is added or removed
+// Not thread-safe, the owner protects it with a mutex
+class TickSchedule final
+{
+private:
+	// Tasks that declare resources in the order of addition, which decides the order of conflicting tasks
+	// Removed tasks leave null entries, which the next build drops
+	std::vector<ThreadTask*> OrderedTasks;
+
+	std::vector<std::vector<ThreadTask*>> Phases;
+	bool bPhasesValid;
+
+	unsigned long long NumOfBuilds;
+
+	// Appends a task to a phase and remembers its position
+	void Place(ThreadTask* Task, size_t Phase, size_t Order);
+
+	// Puts each task that declares resources into the first phase after all earlier tasks that conflict with it
+	void Build();
+
+public:
+	TickSchedule() : bPhasesValid(true), NumOfBuilds(0) {}
+
+	// Adds a task after all added tasks
+	// @param Task - task to add, its resources must already be declared
+	void Add(ThreadTask* Task);
+	// Removes a task, the order of the remaining tasks that declare resources does not change
+	// @param Task - task to remove
+	void Remove(ThreadTask* Task);
+	// Removes all tasks
+	void Clear();
+
+	// Returns the phases in the order of execution, rebuilding them if tasks that declare resources have changed
+	const std::vector<std::vector<ThreadTask*>>& GetPhases();
+
+	// Returns the number of times the phases have been built
+	unsigned long long GetNumOfBuilds() const;
+};
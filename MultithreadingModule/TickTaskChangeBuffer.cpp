@@ -0,0 +1,52 @@
+#include "TickTaskChangeBuffer.h"
+#include "ThreadTask.h"
+
+TickTaskChangeBuffer::TickTaskChangeBuffer() : Head(nullptr)
+{
+}
+
+TickTaskChangeBuffer::~TickTaskChangeBuffer()
+{
+	TickTaskChange* Change = TakeAll();
+	while (Change != nullptr)
+	{
+		TickTaskChange* Next = Change->Next;
+		if (Change->bAdd)
+		{
+			delete Change->Task;
+		}
+		delete Change;
+		Change = Next;
+	}
+}
+
+void TickTaskChangeBuffer::Push(TickTaskChange* Change)
+{
+	TickTaskChange* OldHead = Head.load(std::memory_order_relaxed);
+	do
+	{
+		Change->Next = OldHead;
+	} while (!Head.compare_exchange_weak(OldHead, Change, std::memory_order_release, std::memory_order_relaxed));
+}
+
+TickTaskChange* TickTaskChangeBuffer::TakeAll()
+{
+	TickTaskChange* Change = Head.exchange(nullptr, std::memory_order_acquire);
+
+	// The stack holds the newest change first, reverse it so that changes are applied in the order they were made
+	TickTaskChange* Reversed = nullptr;
+	while (Change != nullptr)
+	{
+		TickTaskChange* Next = Change->Next;
+		Change->Next = Reversed;
+		Reversed = Change;
+		Change = Next;
+	}
+
+	return Reversed;
+}
+
+bool TickTaskChangeBuffer::IsEmpty() const
+{
+	return Head.load(std::memory_order_relaxed) == nullptr;
+}
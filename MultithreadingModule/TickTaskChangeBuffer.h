@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include "TaskHandle.h"
+
+class ThreadTask;
+
+// A pending addition or removal of a Tick task
+struct TickTaskChange
+{
+	// true - add Task, false - remove the task followed by Handle
+	bool bAdd;
+	ThreadTask* Task;
+	TaskHandle Handle;
+
+	TickTaskChange* Next;
+
+	TickTaskChange() : bAdd(false), Task(nullptr), Next(nullptr) {}
+};
+
+// Lock-free buffer of Tick task additions and removals
+// Any thread can push changes without blocking, the manager takes all of them at once at the start of Tick
+class TickTaskChangeBuffer final
+{
+private:
+	// Stack of changes, the newest change is on top
+	std::atomic<TickTaskChange*> Head;
+
+public:
+	TickTaskChangeBuffer();
+	// Deletes the changes that were not taken, including the tasks waiting to be added
+	~TickTaskChangeBuffer();
+
+	TickTaskChangeBuffer(const TickTaskChangeBuffer&) = delete;
+	TickTaskChangeBuffer& operator=(const TickTaskChangeBuffer&) = delete;
+
+	// Adds a change, the buffer takes ownership of it
+	// @param Change - change created with new
+	void Push(TickTaskChange* Change);
+
+	// Takes all changes in the order they were pushed, the caller deletes them
+	// @return first change of the list linked by Next, or nullptr
+	TickTaskChange* TakeAll();
+
+	// Returns true if there are no pending changes
+	bool IsEmpty() const;
+};
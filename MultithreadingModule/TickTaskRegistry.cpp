@@ -0,0 +1,92 @@
+#include "TickTaskRegistry.h"
+
+TickTaskId TickTaskRegistry::Add(ThreadTask* Task)
+{
+	unsigned int SlotIndex = 0;
+	if (!FreeSlots.empty())
+	{
+		SlotIndex = FreeSlots.back();
+		FreeSlots.pop_back();
+	}
+	else
+	{
+		SlotIndex = static_cast<unsigned int>(Slots.size());
+		Slots.push_back(Slot{ 0, 0 });
+	}
+
+	Slots[SlotIndex].DenseIndex = static_cast<unsigned int>(Tasks.size());
+	Tasks.push_back(Task);
+	TaskSlots.push_back(SlotIndex);
+
+	return TickTaskId(SlotIndex, Slots[SlotIndex].Generation);
+}
+
+ThreadTask* TickTaskRegistry::Remove(const TickTaskId& Id)
+{
+	ThreadTask* Task = Get(Id);
+	if (Task == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Move the last task into the freed position
+	const unsigned int DenseIndex = Slots[Id.Index].DenseIndex;
+	const unsigned int LastIndex = static_cast<unsigned int>(Tasks.size() - 1);
+	if (DenseIndex != LastIndex)
+	{
+		Tasks[DenseIndex] = Tasks[LastIndex];
+		TaskSlots[DenseIndex] = TaskSlots[LastIndex];
+		Slots[TaskSlots[DenseIndex]].DenseIndex = DenseIndex;
+	}
+	Tasks.pop_back();
+	TaskSlots.pop_back();
+
+	Slots[Id.Index].Generation++;
+	FreeSlots.push_back(Id.Index);
+
+	return Task;
+}
+
+ThreadTask* TickTaskRegistry::Get(const TickTaskId& Id) const
+{
+	if (Id.Index >= Slots.size() || Slots[Id.Index].Generation != Id.Generation)
+	{
+		return nullptr;
+	}
+
+	// The generation of a free slot has not been given out yet, such identifiers are rejected by the position check
+	const unsigned int DenseIndex = Slots[Id.Index].DenseIndex;
+	if (DenseIndex >= Tasks.size() || TaskSlots[DenseIndex] != Id.Index)
+	{
+		return nullptr;
+	}
+
+	return Tasks[DenseIndex];
+}
+
+void TickTaskRegistry::Clear()
+{
+	for (size_t i = 0; i < TaskSlots.size(); i++)
+	{
+		Slots[TaskSlots[i]].Generation++;
+		FreeSlots.push_back(TaskSlots[i]);
+	}
+
+	Tasks.clear();
+	TaskSlots.clear();
+}
+
+size_t TickTaskRegistry::Size() const
+{
+	return Tasks.size();
+}
+
+bool TickTaskRegistry::IsEmpty() const
+{
+	return Tasks.empty();
+}
+
+ThreadTask* TickTaskRegistry::operator[](size_t Index) const
+{
+	return Tasks[Index];
+}
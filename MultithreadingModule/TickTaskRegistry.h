@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+class ThreadTask;
+
+// Identifies a Tick task in TickTaskRegistry
+// When the task is removed, the generation of its slot changes, so the identifier no longer matches a reused slot
+struct TickTaskId
+{
+	static const unsigned int InvalidIndex = 0xFFFFFFFF;
+
+	unsigned int Index;
+	unsigned int Generation;
+
+	TickTaskId() : Index(InvalidIndex), Generation(0) {}
+	TickTaskId(unsigned int NewIndex, unsigned int NewGeneration) : Index(NewIndex), Generation(NewGeneration) {}
+
+	// Returns true if the identifier was given by a registry
+	bool IsValid() const { return Index != InvalidIndex; }
+};
+
+// Generational slot map of Tick tasks
+// Tasks are stored densely for iteration, a removed task is replaced by the last one, so adding and removing are O(1)
+// Not thread-safe, the owner protects it with a mutex
+class TickTaskRegistry final
+{
+private:
+	struct Slot
+	{
+		// Position of the task in Tasks, if the slot is used
+		unsigned int DenseIndex;
+		unsigned int Generation;
+	};
+
+	std::vector<ThreadTask*> Tasks;
+	// Slot of each task in Tasks
+	std::vector<unsigned int> TaskSlots;
+
+	std::vector<Slot> Slots;
+	std::vector<unsigned int> FreeSlots;
+
+public:
+	// Adds a task and returns its identifier
+	// @param Task - task to add
+	TickTaskId Add(ThreadTask* Task);
+	// Removes a task, the order of the remaining tasks changes
+	// @param Id - identifier of the task
+	// @return the removed task, or nullptr if the identifier does not match a registered task
+	ThreadTask* Remove(const TickTaskId& Id);
+	// Returns the task, or nullptr if the identifier does not match a registered task
+	// @param Id - identifier of the task
+	ThreadTask* Get(const TickTaskId& Id) const;
+	// Removes all tasks, all given identifiers become invalid
+	void Clear();
+
+	// Returns the number of registered tasks
+	size_t Size() const;
+	bool IsEmpty() const;
+	// Returns the task at the given position, positions change when tasks are removed
+	// @param Index - position from 0 to Size() - 1
+	ThreadTask* operator[](size_t Index) const;
+};
@@ -0,0 +1,56 @@
+#include "WorkerCounters.h"
+
+WorkerCounters::WorkerCounters() :
+	NumOfExecutedTasks(0), NumOfExceptions(0), NumOfCancelledTasks(0),
+	BusyTime(0), AsleepTime(0),
+	NumOfSteals(0), NumOfWakeUps(0),
+	StartTime(GetStatisticsTime()),
+	NumOfTasksToNextSample(1)
+{
+}
+
+WorkerStatistics WorkerCounters::GetStatistics(ThreadState State) const
+{
+	WorkerStatistics Statistics;
+	Statistics.State = State;
+
+	Statistics.NumOfExecutedTasks = NumOfExecutedTasks.load(std::memory_order_relaxed);
+	Statistics.NumOfExceptions = NumOfExceptions.load(std::memory_order_relaxed);
+	Statistics.NumOfCancelledTasks = NumOfCancelledTasks.load(std::memory_order_relaxed);
+
+	Statistics.BusyTime = BusyTime.load(std::memory_order_relaxed);
+	Statistics.AsleepTime = AsleepTime.load(std::memory_order_relaxed);
+
+	// The idle time is whatever is left from the counted time
+	const unsigned long long CountedTime = GetStatisticsTime() - StartTime.load(std::memory_order_relaxed);
+	if (CountedTime > Statistics.BusyTime + Statistics.AsleepTime)
+	{
+		Statistics.IdleTime = CountedTime - Statistics.BusyTime - Statistics.AsleepTime;
+	}
+
+	Statistics.NumOfSteals = NumOfSteals.load(std::memory_order_relaxed);
+	Statistics.NumOfWakeUps = NumOfWakeUps.load(std::memory_order_relaxed);
+
+	Statistics.QueueWaitTime = QueueWaitTime.GetSnapshot();
+	Statistics.ExecutionTime = ExecutionTime.GetSnapshot();
+
+	return Statistics;
+}
+
+void WorkerCounters::Reset()
+{
+	NumOfExecutedTasks.store(0, std::memory_order_relaxed);
+	NumOfExceptions.store(0, std::memory_order_relaxed);
+	NumOfCancelledTasks.store(0, std::memory_order_relaxed);
+
+	BusyTime.store(0, std::memory_order_relaxed);
+	AsleepTime.store(0, std::memory_order_relaxed);
+
+	NumOfSteals.store(0, std::memory_order_relaxed);
+	NumOfWakeUps.store(0, std::memory_order_relaxed);
+
+	StartTime.store(GetStatisticsTime(), std::memory_order_relaxed);
+
+	QueueWaitTime.Reset();
+	ExecutionTime.Reset();
+}
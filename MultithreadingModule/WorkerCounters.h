@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include "MultithreadingStatistics.h"
+
+// Statistics counters of one thread
+// Only the owning thread records, so a counter is updated with a relaxed load and store instead of a locked read-modify-write
+// If statistics are disabled, recording does nothing
+class WorkerCounters final
+{
+public:
+	// Without tracing, only every N-th task is timed for the latency histograms
+	static const unsigned int TaskSamplingInterval = 16;
+
+private:
+	std::atomic<unsigned long long> NumOfExecutedTasks;
+	std::atomic<unsigned long long> NumOfExceptions;
+	std::atomic<unsigned long long> NumOfCancelledTasks;
+
+	std::atomic<unsigned long long> BusyTime;
+	std::atomic<unsigned long long> AsleepTime;
+
+	std::atomic<unsigned long long> NumOfSteals;
+	std::atomic<unsigned long long> NumOfWakeUps;
+
+	// Time when counting started, used to calculate the idle time
+	std::atomic<unsigned long long> StartTime;
+
+	LatencyHistogram QueueWaitTime;
+	LatencyHistogram ExecutionTime;
+
+	// Number of tasks left until the next sampled one, only the owning thread uses it
+	unsigned int NumOfTasksToNextSample;
+
+	static void Add(std::atomic<unsigned long long>& Counter, unsigned long long Value)
+	{
+		Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+	}
+
+public:
+	WorkerCounters();
+
+	WorkerCounters(const WorkerCounters&) = delete;
+	WorkerCounters& operator=(const WorkerCounters&) = delete;
+
+	// Records the execution of a portion of tasks
+	// @param NumOfTasks - Number of executed tasks
+	// @param Duration - Time spent executing them
+	void RecordTasks(unsigned long long NumOfTasks, unsigned long long Duration)
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		Add(NumOfExecutedTasks, NumOfTasks);
+		Add(BusyTime, Duration);
+#endif
+	}
+
+	// Returns true if the next task has to be timed for the latency histograms
+	bool ShouldSampleTask()
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		if (--NumOfTasksToNextSample != 0)
+		{
+			return false;
+		}
+
+		NumOfTasksToNextSample = TaskSamplingInterval;
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Records the latencies of one timed task
+	// @param EnqueueTime - Time when the task was added to the queue
+	// @param ExecutionStart - Time when the execution started
+	// @param ExecutionEnd - Time when the execution ended
+	void RecordTaskLatency(unsigned long long EnqueueTime, unsigned long long ExecutionStart, unsigned long long ExecutionEnd)
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		if (EnqueueTime != 0 && EnqueueTime <= ExecutionStart)
+		{
+			QueueWaitTime.Record(ExecutionStart - EnqueueTime);
+		}
+		ExecutionTime.Record(ExecutionEnd - ExecutionStart);
+#endif
+	}
+
+	// Records a sleep of the thread that ended with a wake up
+	// @param SleepStart - Time when the sleep started
+	// @param SleepEnd - Time when the sleep ended
+	void RecordSleep(unsigned long long SleepStart, unsigned long long SleepEnd)
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		Add(AsleepTime, SleepEnd - SleepStart);
+		Add(NumOfWakeUps, 1);
+#endif
+	}
+
+	// Records an exception thrown by a task
+	void RecordException()
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		Add(NumOfExceptions, 1);
+#endif
+	}
+
+	// Records a cancelled task that was skipped without execution
+	void RecordCancelledTask()
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		Add(NumOfCancelledTasks, 1);
+#endif
+	}
+
+	// Records the taking of a task portion from a shared queue
+	void RecordSteal()
+	{
+#if MULTITHREADING_ENABLE_STATISTICS
+		Add(NumOfSteals, 1);
+#endif
+	}
+
+	// Returns a copy of the counters
+	// @param State - State of the thread at the moment
+	WorkerStatistics GetStatistics(ThreadState State) const;
+
+	// Clears the counters and starts counting the idle time from the current moment
+	void Reset();
+};
@@ -0,0 +1 @@
+#include "WorkerLifecycleHooks.h"
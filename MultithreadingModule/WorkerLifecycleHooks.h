@@ -0,0 +1,25 @@
+#pragma once
+#include <functional>
+
+// Describes the worker that runs a lifecycle hook
+struct WorkerInfo
+{
+	// true for a dedicated thread, false for a standard thread
+	bool bDedicated;
+	// Number of times the thread has been started, above 1 for a thread reused from the stopped threads
+	unsigned int NumOfStarts;
+
+	WorkerInfo() : bDedicated(false), NumOfStarts(0) {}
+};
+
+// Called on the worker itself, an exception thrown by it is passed to the task error sink with a null task
+typedef std::function<void(const WorkerInfo& Info)> WorkerLifecycleHook;
+
+// Hooks of the standard and dedicated threads of a pool, for example to open per-thread resources in WorkerLocal values
+struct WorkerLifecycleHooks
+{
+	// Called before the worker executes its first task, may be empty
+	WorkerLifecycleHook OnWorkerStart;
+	// Called after the worker executes its last task, before its WorkerLocal values are destroyed, may be empty
+	WorkerLifecycleHook OnWorkerStop;
+};
@@ -0,0 +1 @@
+#include "WorkerLocal.h"
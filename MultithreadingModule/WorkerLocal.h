@@ -0,0 +1,62 @@
+#pragma once
+#include <functional>
+#include "AdvancedThread.h"
+#include "WorkerLocalStorage.h"
+
+// Variable with a separate value on each worker, for per-thread resources such as a connection or a random generator
+// The value is created on the first access on the worker and destroyed on the worker when it stops, after OnWorkerStop
+// Access is an index into the storage of the current thread, without a hash lookup
+// Threads outside the pools have values of their own, destroyed when the thread exits
+// Each variable takes a slot for the lifetime of the program, so variables are meant to be long-lived, for example static
+template<typename Type>
+class WorkerLocal
+{
+private:
+	const size_t Index;
+
+	// Creates the value of a worker, the default constructor is used if it is empty
+	const std::function<Type*()> Factory;
+
+	static void DestroyValue(void* Value);
+
+public:
+	WorkerLocal() : Index(WorkerLocalStorage::AllocateSlot()) {}
+	// @param NewFactory - creates the value of a worker with new, it is called on the worker and must not return nullptr
+	explicit WorkerLocal(const std::function<Type*()>& NewFactory) : Index(WorkerLocalStorage::AllocateSlot()), Factory(NewFactory) {}
+
+	WorkerLocal(const WorkerLocal&) = delete;
+	WorkerLocal& operator=(const WorkerLocal&) = delete;
+
+	// Returns the value of the current thread, creating it on the first access
+	Type& Get();
+
+	// Returns true if the value has been created on the current thread
+	bool IsCreated() const;
+};
+
+template<typename Type>
+inline void WorkerLocal<Type>::DestroyValue(void* Value)
+{
+	delete static_cast<Type*>(Value);
+}
+
+template<typename Type>
+inline Type& WorkerLocal<Type>::Get()
+{
+	WorkerLocalStorage& Storage = AdvancedThread::GetWorkerLocalStorage();
+
+	void* Value = Storage.Get(Index);
+	if (Value == nullptr)
+	{
+		Value = Factory ? Factory() : new Type();
+		Storage.Set(Index, Value, &WorkerLocal<Type>::DestroyValue);
+	}
+
+	return *static_cast<Type*>(Value);
+}
+
+template<typename Type>
+inline bool WorkerLocal<Type>::IsCreated() const
+{
+	return AdvancedThread::GetWorkerLocalStorage().Get(Index) != nullptr;
+}
@@ -0,0 +1,48 @@
+#include "WorkerLocalStorage.h"
+
+std::atomic<size_t> WorkerLocalStorage::NumOfSlots(0);
+
+WorkerLocalStorage::~WorkerLocalStorage()
+{
+	Clear();
+}
+
+void* WorkerLocalStorage::Get(size_t Index) const
+{
+	return Index < Slots.size() ? Slots[Index].Value : nullptr;
+}
+
+void WorkerLocalStorage::Set(size_t Index, void* Value, void (*DestroyValue)(void* Value))
+{
+	if (Index >= Slots.size())
+	{
+		Slot EmptySlot;
+		EmptySlot.Value = nullptr;
+		EmptySlot.DestroyValue = nullptr;
+		Slots.resize(Index + 1, EmptySlot);
+	}
+
+	Slots[Index].Value = Value;
+	Slots[Index].DestroyValue = DestroyValue;
+}
+
+void WorkerLocalStorage::Clear()
+{
+	// A value may still use the values created before it, such as a context that uses a connection
+	for (size_t i = Slots.size(); i > 0; i--)
+	{
+		// The slot is emptied first, the destructor of the value may access other variables
+		const Slot CurrentSlot = Slots[i - 1];
+		Slots[i - 1].Value = nullptr;
+		if (CurrentSlot.Value != nullptr && CurrentSlot.DestroyValue != nullptr)
+		{
+			CurrentSlot.DestroyValue(CurrentSlot.Value);
+		}
+	}
+	Slots.clear();
+}
+
+size_t WorkerLocalStorage::AllocateSlot()
+{
+	return NumOfSlots.fetch_add(1, std::memory_order_relaxed);
+}
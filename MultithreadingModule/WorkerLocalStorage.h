@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+// Values of the WorkerLocal variables on one thread, indexed by the slot of the variable
+class WorkerLocalStorage
+{
+private:
+	struct Slot
+	{
+		void* Value;
+		void (*DestroyValue)(void* Value);
+	};
+
+	std::vector<Slot> Slots;
+
+	// Slots are never reused, so a value can not be taken for a value of another variable
+	static std::atomic<size_t> NumOfSlots;
+
+public:
+	WorkerLocalStorage() {}
+	// Destroys the values
+	~WorkerLocalStorage();
+
+	WorkerLocalStorage(const WorkerLocalStorage&) = delete;
+	WorkerLocalStorage& operator=(const WorkerLocalStorage&) = delete;
+
+	// Returns the value in the slot, or nullptr if it has not been created on this thread
+	// @param Index - slot of the variable
+	void* Get(size_t Index) const;
+
+	// Puts a value into an empty slot
+	// @param Index - slot of the variable
+	// @param Value - the value, it belongs to the storage
+	// @param DestroyValue - function that destroys the value
+	void Set(size_t Index, void* Value, void (*DestroyValue)(void* Value));
+
+	// Destroys all values, in the reverse order of their slots
+	void Clear();
+
+	// Reserves a slot for a new variable
+	static size_t AllocateSlot();
+};
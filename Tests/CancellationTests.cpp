@@ -0,0 +1,126 @@
+// Tests of the cancellation of tasks through handles and tokens
+//
+// Usage: CancellationTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include "CancellationToken.h"
+#include "MultithreadingConfig.h"
+#include "MultithreadingModule.h"
+#include "TaskHandle.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+#include "WorkerGate.h"
+
+// Creates a pool of one thread, so that a closed WorkerGate keeps all added tasks queued
+static MultithreadingPoolConfig CreateConfig(const char* Name)
+{
+	MultithreadingPoolConfig Config(Name);
+	Config.MaxNumOfThreads = 1;
+	return Config;
+}
+
+static unsigned long long GetNumOfCancelledTasks(MultithreadingModule& Module)
+{
+	return Module.GetStatistics().Total.NumOfCancelledTasks;
+}
+
+
+static void TestCancelHandle()
+{
+	MultithreadingModule Module(CreateConfig("CancelHandle"));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	const TaskHandle Cancelled = Module.AddTaskWithHandle(new ThreadFunctionTask([&NumOfExecutions]() { NumOfExecutions++; }));
+	const TaskHandle Kept = Module.AddTaskWithHandle(new ThreadFunctionTask([&NumOfExecutions]() { NumOfExecutions++; }));
+	Check(Cancelled.IsValid() && Kept.IsValid(), "AddTaskWithHandle returns a valid handle");
+
+	Cancelled.Cancel();
+	Check(Cancelled.IsCancelled(), "The handle reports the cancellation");
+	Check(!Kept.IsCancelled(), "Cancelling one handle does not cancel another task");
+	Gate.Open();
+
+	Check(Cancelled.WaitFor(10000), "A cancelled task is completed without execution");
+	Check(Kept.WaitFor(10000), "The task that was not cancelled is completed");
+	Check(NumOfExecutions.load() == 1, "Only the task that was not cancelled is executed");
+	Check(!Cancelled.HasException(), "A cancelled task has no exception");
+#if MULTITHREADING_ENABLE_STATISTICS
+	Check(WaitUntil([&Module]() { return GetNumOfCancelledTasks(Module) == 1; }), "NumOfCancelledTasks counts the cancelled task");
+#endif
+
+	Module.StopThreads();
+}
+
+static void TestCancelSharedToken()
+{
+	const unsigned int NumOfGroupTasks = 16;
+
+	MultithreadingModule Module(CreateConfig("CancelToken"));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfGroupExecutions(0);
+	CancellationToken Token;
+	for (unsigned int i = 0; i < NumOfGroupTasks; i++)
+	{
+		ThreadTask* Task = new ThreadFunctionTask([&NumOfGroupExecutions]() { NumOfGroupExecutions++; });
+		Task->SetCancellationToken(Token);
+		Module.AddTask(Task);
+	}
+
+	std::atomic<bool> bOtherExecuted(false);
+	const TaskHandle Other = Module.AddTaskWithHandle(new ThreadFunctionTask([&bOtherExecuted]() { bOtherExecuted.store(true); }));
+
+	// Cancelling a copy cancels every task that received the token
+	CancellationToken Copy = Token;
+	Copy.Cancel();
+	Check(Token.IsCancelled(), "Copies of a token share the cancellation");
+	Gate.Open();
+
+	Check(Other.WaitFor(10000), "The task without the token is completed");
+	Check(bOtherExecuted.load(), "A task without the token is executed");
+	Check(NumOfGroupExecutions.load() == 0, "No task of the cancelled group is executed");
+#if MULTITHREADING_ENABLE_STATISTICS
+	Check(WaitUntil([&Module]() { return GetNumOfCancelledTasks(Module) == NumOfGroupTasks; }), "NumOfCancelledTasks counts every task of the group");
+#endif
+
+	Module.StopThreads();
+}
+
+static void TestCancelTickTask()
+{
+	MultithreadingModule Module(CreateConfig("CancelTick"));
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	const TaskHandle Handle = Module.AddTaskWithHandle(new ThreadFunctionTask([&NumOfExecutions](const float&) { NumOfExecutions++; }));
+
+	Module.Tick(0.0f);
+	Check(NumOfExecutions.load() == 1, "A Tick task is executed before its cancellation");
+	Check(Handle.GetTickTaskId().IsValid(), "A registered Tick task has a registry identifier");
+
+	Handle.Cancel();
+	Module.Tick(0.0f);
+	Module.Tick(0.0f);
+	Check(NumOfExecutions.load() == 1, "A cancelled Tick task is no longer executed");
+	Check(!Handle.IsCompleted(), "A cancelled Tick task stays registered until it is removed");
+
+	Module.RemoveTask(Handle);
+	Module.Tick(0.0f);
+	Check(Handle.WaitFor(10000), "A removed Tick task is completed");
+
+	Module.StopThreads();
+}
+
+int main()
+{
+	TestCancelHandle();
+	TestCancelSharedToken();
+	TestCancelTickTask();
+	return FinishChecks();
+}
@@ -0,0 +1,72 @@
+// Tests of the threads that compensate for blocked standard threads
+//
+// Usage: CompensatingThreadsTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "BlockingScope.h"
+#include "MultithreadingModule.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+
+// Blocking sections that end during a Tick retire compensating threads while the Tick waits for its threads
+static void TestTickWithEndingBlockingSections()
+{
+	const unsigned int NumOfTicks = 300;
+
+	MultithreadingModule::SetMaxNumOfThreads(4);
+	MultithreadingModule Module;
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfTickExecutions(0);
+	for (int i = 0; i < 64; i++)
+	{
+		Module.AddTask(new ThreadFunctionTask([&NumOfTickExecutions](const float&) { NumOfTickExecutions++; }));
+	}
+
+	// A hang is reported as a failure instead of blocking the test run
+	std::atomic<unsigned int> NumOfCompletedTicks(0);
+	std::thread TickThread([&Module, &NumOfCompletedTicks]()
+	{
+		for (unsigned int Tick = 0; Tick < NumOfTicks; Tick++)
+		{
+			for (int i = 0; i < 2; i++)
+			{
+				Module.AddTask(new ThreadFunctionTask([]()
+				{
+					BlockingScope Blocking;
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}));
+			}
+
+			Module.Tick(0.016f);
+			NumOfCompletedTicks++;
+		}
+	});
+
+	const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+	while (NumOfCompletedTicks.load() < NumOfTicks && std::chrono::steady_clock::now() < Deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	if (NumOfCompletedTicks.load() < NumOfTicks)
+	{
+		Check(false, "a Tick completes while blocking sections end");
+		std::_Exit(FinishChecks());
+	}
+	TickThread.join();
+
+	Check(NumOfTickExecutions.load() == 64 * NumOfTicks, "every Tick task is executed once per Tick");
+	Check(Module.GetNumOfThreads() >= 4, "retired compensating threads leave the standard threads running");
+}
+
+
+int main()
+{
+	TestTickWithEndingBlockingSections();
+
+	return FinishChecks();
+}
@@ -0,0 +1,221 @@
+// Tests of the capacity of the Once task queue and its overflow modes
+//
+// Usage: OnceQueueOverflowTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include "MultithreadingModule.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+#include "WorkerGate.h"
+
+// Creates a pool of one thread with a limited Once queue
+static MultithreadingPoolConfig CreateConfig(const std::string& Name, unsigned int Capacity, QueueOverflowMode Overflow)
+{
+	MultithreadingPoolConfig Config(Name);
+	Config.MaxNumOfThreads = 1;
+	Config.OnceQueueCapacity = Capacity;
+	Config.OnceQueueOverflow = Overflow;
+	return Config;
+}
+
+static ThreadTask* CreateCountingTask(std::atomic<unsigned int>& Counter)
+{
+	return new ThreadFunctionTask([&Counter]() { Counter++; });
+}
+
+
+static void TestBlock()
+{
+	MultithreadingModule Module(CreateConfig("Block", 2, QueueOverflowMode::Block));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	Module.AddTask(CreateCountingTask(NumOfExecutions));
+	Module.AddTask(CreateCountingTask(NumOfExecutions));
+
+	std::atomic<bool> bAdded(false);
+	std::thread Producer([&Module, &NumOfExecutions, &bAdded]()
+	{
+		Module.AddTask(CreateCountingTask(NumOfExecutions));
+		bAdded.store(true);
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	Check(!bAdded.load(), "Block waits while the queue is full");
+	Check(Module.GetStatistics().NumOfBlockedSubmissions == 1, "a waiting addition is counted as blocked");
+
+	Gate.Open();
+	Producer.join();
+	Check(WaitUntil([&NumOfExecutions]() { return NumOfExecutions.load() == 3; }), "the blocked task is added and executed once there is space");
+
+	Module.StopThreads();
+}
+
+static void TestBlockFromServingThread()
+{
+	const unsigned int NumOfTasks = 20;
+
+	MultithreadingModule Module(CreateConfig("BlockFromServingThread", 1, QueueOverflowMode::Block));
+	Module.StartThreads();
+
+	// The only thread fills its own queue, waiting for space would never end
+	std::atomic<unsigned int> NumOfExecutions(0);
+	Module.AddTask(new ThreadFunctionTask([&Module, &NumOfExecutions]()
+	{
+		for (unsigned int i = 0; i < NumOfTasks; i++)
+		{
+			Module.AddTask(CreateCountingTask(NumOfExecutions));
+		}
+	}));
+
+	Check(WaitUntil([&NumOfExecutions]() { return NumOfExecutions.load() == NumOfTasks; }), "a thread of the pool executes queued tasks instead of waiting for space");
+	Check(Module.GetStatistics().NumOfBlockedSubmissions > 0, "the additions of the thread found the queue full");
+
+	Module.StopThreads();
+}
+
+static void TestReject()
+{
+	MultithreadingModule Module(CreateConfig("Reject", 2, QueueOverflowMode::Reject));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	Module.AddTask(CreateCountingTask(NumOfExecutions));
+	Module.AddTask(CreateCountingTask(NumOfExecutions));
+	const TaskHandle Rejected = Module.AddTaskWithHandle(CreateCountingTask(NumOfExecutions));
+
+	Check(Rejected.IsCompleted() && Rejected.HasException(), "the handle of a rejected task receives an exception");
+	Check(Module.GetStatistics().NumOfRejectedTasks == 1, "a rejected task is counted");
+
+	Gate.Open();
+	Check(WaitUntil([&NumOfExecutions]() { return NumOfExecutions.load() == 2; }), "the queued tasks are executed");
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	Check(NumOfExecutions.load() == 2, "a rejected task is not executed");
+
+	Module.StopThreads();
+}
+
+static void TestDropOldest()
+{
+	MultithreadingModule Module(CreateConfig("DropOldest", 2, QueueOverflowMode::DropOldest));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	// Internal tasks in front of the user tasks do not take space and are not dropped
+	std::atomic<unsigned int> NumOfInternalExecutions(0);
+	Module.AddInternalTask(CreateCountingTask(NumOfInternalExecutions));
+	Module.AddInternalTask(CreateCountingTask(NumOfInternalExecutions));
+
+	std::atomic<unsigned int> ExecutedTasks(0);
+	TaskHandle Handles[3];
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		Handles[i] = Module.AddTaskWithHandle(new ThreadFunctionTask([&ExecutedTasks, i]() { ExecutedTasks |= 1u << i; }));
+	}
+
+	Check(Handles[0].IsCompleted() && !Handles[1].IsCompleted() && !Handles[2].IsCompleted(), "the oldest user task is dropped and its handle is completed");
+	Check(Module.GetStatistics().NumOfDroppedTasks == 1 && Module.GetStatistics().NumOfRejectedTasks == 0, "a dropped task is counted and the added one is not rejected");
+
+	Gate.Open();
+	Check(WaitUntil([&ExecutedTasks, &NumOfInternalExecutions]() { return ExecutedTasks.load() == 6 && NumOfInternalExecutions.load() == 2; }), 
+		"the internal tasks and the newer user tasks are executed, the dropped one is not");
+
+	Module.StopThreads();
+}
+
+static void TestTryAddTask()
+{
+	MultithreadingModule Module(CreateConfig("TryAddTask", 1, QueueOverflowMode::Block));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	Module.AddTask(CreateCountingTask(NumOfExecutions));
+
+	// The captured pointer tells whether the task has been deleted
+	std::shared_ptr<int> Owner = std::make_shared<int>(0);
+	ThreadTask* Task = new ThreadFunctionTask([Owner, &NumOfExecutions]() { NumOfExecutions++; });
+
+	Check(!Module.TryAddTask(Task), "TryAddTask without a timeout fails on a full queue");
+	Check(Owner.use_count() == 2, "the task of a failed TryAddTask still belongs to the caller");
+
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+	Check(!Module.TryAddTask(Task, 30), "TryAddTask fails if the queue stays full for the timeout");
+	Check(std::chrono::steady_clock::now() - Start >= std::chrono::milliseconds(30), "TryAddTask waits for the timeout");
+	Check(Owner.use_count() == 2, "the task of a timed out TryAddTask still belongs to the caller");
+	Check(Module.GetStatistics().NumOfRejectedTasks == 2, "failed TryAddTask calls are counted as rejected");
+
+	// Space made during the wait is taken
+	std::thread Opener([&Gate]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		Gate.Open();
+	});
+	Check(Module.TryAddTask(Task, 10000), "TryAddTask adds the task once there is space");
+	Opener.join();
+
+	Check(WaitUntil([&NumOfExecutions]() { return NumOfExecutions.load() == 2; }), "the task added by TryAddTask is executed");
+	Check(WaitUntil([&Owner]() { return Owner.use_count() == 1; }), "the pool deletes the added task");
+
+	Module.StopThreads();
+}
+
+static void TestStatistics()
+{
+	MultithreadingModule Module(CreateConfig("Statistics", 3, QueueOverflowMode::Reject));
+	Module.StartThreads();
+
+	WorkerGate Gate;
+	Gate.Close(Module);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	Module.AddInternalTask(CreateCountingTask(NumOfExecutions));
+	Module.AddInternalTask(CreateCountingTask(NumOfExecutions));
+	for (int i = 0; i < 3; i++)
+	{
+		Module.AddTask(CreateCountingTask(NumOfExecutions));
+	}
+
+	MultithreadingStatistics Statistics = Module.GetStatistics();
+	Check(Statistics.OnceQueueCapacity == 3, "the statistics report the capacity");
+	Check(Statistics.OnceQueueSize == 5 && Statistics.OnceQueuePeakSize == 5, "the occupancy and the peak include the internal tasks");
+	Check(Statistics.NumOfRejectedTasks == 0, "internal tasks do not take the space of user tasks");
+
+	Gate.Open();
+	Check(WaitUntil([&NumOfExecutions]() { return NumOfExecutions.load() == 5; }), "the queued tasks are executed");
+
+	Statistics = Module.GetStatistics();
+	Check(Statistics.OnceQueueSize == 0 && Statistics.OnceQueuePeakSize == 5, "the peak stays after the queue is emptied");
+
+	Module.ResetStatistics();
+	Check(Module.GetStatistics().OnceQueuePeakSize == 0, "a reset peak starts from the current occupancy");
+
+	Module.StopThreads();
+}
+
+
+int main()
+{
+	TestBlock();
+	TestBlockFromServingThread();
+	TestReject();
+	TestDropOldest();
+	TestTryAddTask();
+	TestStatistics();
+
+	return FinishChecks();
+}
@@ -0,0 +1,240 @@
+// Tests of Pipeline ordering, tokens, errors and abandoned tasks
+//
+// Usage: PipelineTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "MultithreadingModule.h"
+#include "Pipeline.h"
+#include "TestCheck.h"
+
+// Items are numbers from 1 stored in the pointers, so that no memory is owned by the stages
+static void* ToItem(unsigned int Number)
+{
+	return reinterpret_cast<void*>(static_cast<uintptr_t>(Number));
+}
+
+static unsigned int FromItem(void* Item)
+{
+	return static_cast<unsigned int>(reinterpret_cast<uintptr_t>(Item));
+}
+
+// Returns an input stage that reads the numbers from 1 to NumOfItems
+static PipelineStageFunction CreateInput(std::atomic<unsigned int>& NumOfReadItems, unsigned int NumOfItems)
+{
+	return [&NumOfReadItems, NumOfItems](void*) -> void*
+	{
+		const unsigned int Number = ++NumOfReadItems;
+		return Number <= NumOfItems ? ToItem(Number) : nullptr;
+	};
+}
+
+static MultithreadingPoolConfig CreateConfig(const std::string& Name)
+{
+	MultithreadingPoolConfig Config(Name);
+	Config.MaxNumOfThreads = 4;
+	return Config;
+}
+
+
+// Items overtake each other in the parallel stage, the SerialInOrder stage after it restores the order of the input
+static void TestSerialInOrderAfterParallel()
+{
+	const unsigned int NumOfItems = 200;
+
+	MultithreadingModule Module(CreateConfig("PipelineOrder"));
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfReadItems(0);
+	std::vector<unsigned int> Output;
+
+	Pipeline Stages(&Module);
+	Stages.AddStage(PipelineStageKind::SerialInOrder, CreateInput(NumOfReadItems, NumOfItems));
+	Stages.AddStage(PipelineStageKind::Parallel, [](void* Item) -> void*
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds((FromItem(Item) % 4) * 100));
+		return Item;
+	});
+	Stages.AddStage(PipelineStageKind::SerialInOrder, [&Output](void* Item) -> void*
+	{
+		Output.push_back(FromItem(Item));
+		return Item;
+	});
+
+	CheckCompletes([&Stages]() { Stages.Run(8); }, "a pipeline with a parallel stage completes");
+
+	bool bInOrder = Output.size() == NumOfItems;
+	for (size_t i = 0; bInOrder && i < Output.size(); i++)
+	{
+		bInOrder = Output[i] == i + 1;
+	}
+	Check(bInOrder, "the SerialInOrder stage receives the items in the order of the input");
+	Check(Stages.GetNumOfCompletedItems() == NumOfItems && Stages.GetException() == nullptr, "all items pass the pipeline without errors");
+
+	Module.StopThreads();
+}
+
+// Items are counted from the input stage to the last stage, the count never exceeds the tokens
+static void TestTokenLimit()
+{
+	const unsigned int NumOfItems = 200;
+	const unsigned int NumOfTokens = 3;
+
+	MultithreadingModule Module(CreateConfig("PipelineTokens"));
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfReadItems(0);
+	std::atomic<unsigned int> NumOfItemsInFlight(0);
+	std::atomic<unsigned int> MaxNumOfItemsInFlight(0);
+
+	Pipeline Stages(&Module);
+	Stages.AddStage(PipelineStageKind::SerialInOrder, [&NumOfReadItems, &NumOfItemsInFlight, &MaxNumOfItemsInFlight](void*) -> void*
+	{
+		const unsigned int Number = ++NumOfReadItems;
+		if (Number > NumOfItems)
+		{
+			return nullptr;
+		}
+
+		const unsigned int InFlight = ++NumOfItemsInFlight;
+		unsigned int Max = MaxNumOfItemsInFlight.load();
+		while (InFlight > Max && !MaxNumOfItemsInFlight.compare_exchange_weak(Max, InFlight))
+		{
+		}
+		return ToItem(Number);
+	});
+	Stages.AddStage(PipelineStageKind::Parallel, [](void* Item) -> void*
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		return Item;
+	});
+	Stages.AddStage(PipelineStageKind::SerialOutOfOrder, [&NumOfItemsInFlight](void* Item) -> void*
+	{
+		NumOfItemsInFlight--;
+		return Item;
+	});
+
+	CheckCompletes([&Stages]() { Stages.Run(NumOfTokens); }, "a pipeline limited by tokens completes");
+
+	Check(MaxNumOfItemsInFlight.load() >= 1 && MaxNumOfItemsInFlight.load() <= NumOfTokens, "no more items are in flight than there are tokens");
+	Check(Stages.GetNumOfCompletedItems() == NumOfItems, "all items pass the pipeline");
+
+	Module.StopThreads();
+}
+
+static void TestException()
+{
+	const unsigned int NumOfItems = 1000;
+
+	MultithreadingModule Module(CreateConfig("PipelineException"));
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfReadItems(0);
+	Pipeline Stages(&Module);
+	Stages.AddStage(PipelineStageKind::SerialInOrder, CreateInput(NumOfReadItems, NumOfItems));
+	Stages.AddStage(PipelineStageKind::Parallel, [](void* Item) -> void*
+	{
+		if (FromItem(Item) == 20)
+		{
+			throw std::runtime_error("Stage failed");
+		}
+		return Item;
+	});
+
+	CheckCompletes([&Stages]() { Stages.Run(4); }, "a pipeline with a throwing stage completes");
+	Check(Stages.GetException() != nullptr, "the exception of a stage is kept");
+	Check(Stages.GetNumOfCompletedItems() < NumOfItems - 1, "an exception stops the input");
+
+	// The next run starts without the error
+	NumOfReadItems.store(20);
+	CheckCompletes([&Stages]() { Stages.Run(4); }, "a pipeline runs again after an exception");
+	Check(Stages.GetException() == nullptr && Stages.GetNumOfCompletedItems() == NumOfItems - 20, "a new run resets the exception");
+
+	Module.StopThreads();
+}
+
+static void TestCancel()
+{
+	const unsigned int NumOfItems = 1000;
+	const unsigned int NumOfTokens = 4;
+
+	MultithreadingModule Module(CreateConfig("PipelineCancel"));
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfReadItems(0);
+	Pipeline Stages(&Module);
+	Stages.AddStage(PipelineStageKind::SerialInOrder, CreateInput(NumOfReadItems, NumOfItems));
+	Stages.AddStage(PipelineStageKind::SerialInOrder, [&Stages](void* Item) -> void*
+	{
+		if (FromItem(Item) == 10)
+		{
+			Stages.Cancel();
+		}
+		return Item;
+	});
+
+	CheckCompletes([&Stages]() { Stages.Run(NumOfTokens); }, "a cancelled pipeline completes");
+	Check(Stages.GetException() == nullptr, "Cancel is not an error");
+	Check(Stages.GetNumOfCompletedItems() >= 10 && Stages.GetNumOfCompletedItems() <= 10 + NumOfTokens, "Cancel stops the input, the items in flight still complete");
+
+	Module.StopThreads();
+}
+
+// A pool without threads executes the tasks only when the test calls ExecuteOnceTask, so the queue is known at every step
+static void TestAbandonedTasks()
+{
+	const unsigned int NumOfItems = 3;
+
+	MultithreadingModule Module(MultithreadingPoolConfig("PipelineAbandon"));
+
+	bool bHoldFirstItem = true;
+	std::atomic<unsigned int> NumOfReadItems(0);
+	Pipeline Stages(&Module);
+	Stages.AddStage(PipelineStageKind::SerialInOrder, CreateInput(NumOfReadItems, NumOfItems));
+	Stages.AddStage(PipelineStageKind::SerialInOrder, [&Module, &bHoldFirstItem](void* Item) -> void*
+	{
+		// While the first item holds the stage, the second one is read and waits for it
+		// Leaving the stage then queues a task that carries the second item on
+		if (bHoldFirstItem && FromItem(Item) == 1)
+		{
+			Module.ExecuteOnceTask();
+		}
+		return Item;
+	});
+
+	Check(Stages.Start(4), "the pipeline starts");
+	Module.ExecuteOnceTask();
+	Check(Module.GetStatistics().OnceQueueSize == 2, "the next input task and the task of the waiting item are queued");
+
+	// Both the input task and the item task are deleted without execution, their tokens must still be returned
+	Module.RemoveAllOnceTasks();
+	Check(!Stages.IsRunning(), "the run completes after its tasks are removed");
+	Check(Stages.GetException() != nullptr, "removed tasks are reported as an error");
+	Check(Stages.GetNumOfCompletedItems() == 1, "only the first item completes");
+
+	// The serial stages are released, so the next run passes all items
+	bHoldFirstItem = false;
+	NumOfReadItems.store(0);
+	Check(Stages.Start(4), "the pipeline starts again after its tasks were removed");
+	while (Module.ExecuteOnceTask())
+	{
+	}
+	Check(!Stages.IsRunning() && Stages.GetException() == nullptr && Stages.GetNumOfCompletedItems() == NumOfItems, "the next run completes all items");
+}
+
+
+int main()
+{
+	TestSerialInOrderAfterParallel();
+	TestTokenLimit();
+	TestException();
+	TestCancel();
+	TestAbandonedTasks();
+
+	return FinishChecks();
+}
@@ -0,0 +1,80 @@
+// Tests of the reset of the scratch arena of the thread that calls Tick
+//
+// Usage: ScratchArenaTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include "LinearArena.h"
+#include "MultithreadingModule.h"
+#include "TaskHandle.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+
+// Allocates from the scratch arena of the calling thread, calls Tick and returns true if the arena was reset
+static bool TickResetsCallerArena(MultithreadingModule& Module)
+{
+	MultithreadingModule::GetScratchArena().Allocate(64, 8);
+	Module.Tick(0.0f);
+	return MultithreadingModule::GetScratchArena().GetUsedSize() == 0;
+}
+
+
+static void TestCallerArenaReset()
+{
+	MultithreadingPoolConfig Config("CallerArena");
+	Config.MaxNumOfThreads = 2;
+	MultithreadingModule Module(Config);
+	Module.StartThreads();
+
+	Check(TickResetsCallerArena(Module), "A Tick without Tick tasks resets the arena of the caller");
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	const TaskHandle Handle = Module.AddTaskWithHandle(new ThreadFunctionTask([&NumOfExecutions](const float&) { NumOfExecutions++; }));
+	Check(TickResetsCallerArena(Module), "A threaded Tick resets the arena of the caller");
+
+	MultithreadingModule::SetDeterministicExecution(true, 1);
+	Check(TickResetsCallerArena(Module), "A deterministic Tick resets the arena of the caller");
+	MultithreadingModule::SetDeterministicExecution(false, 0);
+
+	Check(NumOfExecutions.load() == 2, "The Tick task is executed in both modes");
+
+	Module.RemoveTask(Handle);
+	Module.Tick(0.0f);
+	Module.StopThreads();
+}
+
+// A task of one pool that calls Tick of another pool keeps the memory of its own arena
+static void TestTickFromStandardThread()
+{
+	MultithreadingPoolConfig OuterConfig("OuterArena");
+	OuterConfig.MaxNumOfThreads = 1;
+	MultithreadingModule Outer(OuterConfig);
+	Outer.StartThreads();
+
+	MultithreadingPoolConfig InnerConfig("InnerArena");
+	InnerConfig.MaxNumOfThreads = 1;
+	MultithreadingModule Inner(InnerConfig);
+	Inner.StartThreads();
+
+	std::atomic<bool> bKept(false);
+	const TaskHandle Handle = Outer.AddTaskWithHandle(new ThreadFunctionTask([&Inner, &bKept]()
+	{
+		LinearArena& Arena = MultithreadingModule::GetScratchArena();
+		Arena.Allocate(64, 8);
+		const size_t UsedSize = Arena.GetUsedSize();
+		Inner.Tick(0.0f);
+		bKept.store(Arena.GetUsedSize() == UsedSize);
+	}));
+
+	Check(Handle.WaitFor(10000), "The task that calls Tick is completed");
+	Check(bKept.load(), "Tick does not reset the arena of a standard thread that calls it");
+
+	Inner.StopThreads();
+	Outer.StopThreads();
+}
+
+int main()
+{
+	TestCallerArenaReset();
+	TestTickFromStandardThread();
+	return FinishChecks();
+}
@@ -0,0 +1,161 @@
+// Tests of exceptions thrown by tasks
+//
+// Usage: TaskExceptionTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include "MultithreadingConfig.h"
+#include "MultithreadingModule.h"
+#include "TaskHandle.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+
+// Counts the exceptions received by the error sink by their type
+static std::atomic<unsigned int> NumOfSinkRuntimeErrors(0);
+static std::atomic<unsigned int> NumOfSinkInts(0);
+static std::atomic<unsigned int> NumOfSinkTasks(0);
+
+static void CountSinkException(ThreadTask* Task, std::exception_ptr Exception)
+{
+	if (Task != nullptr)
+	{
+		NumOfSinkTasks++;
+	}
+
+	try
+	{
+		std::rethrow_exception(Exception);
+	}
+	catch (const std::runtime_error&)
+	{
+		NumOfSinkRuntimeErrors++;
+	}
+	catch (int)
+	{
+		NumOfSinkInts++;
+	}
+	catch (...)
+	{
+	}
+}
+
+static void ResetSinkCounters()
+{
+	NumOfSinkRuntimeErrors.store(0);
+	NumOfSinkInts.store(0);
+	NumOfSinkTasks.store(0);
+}
+
+// Returns true if the handle holds an exception of the given type
+template <typename ExceptionType>
+static bool HoldsException(const TaskHandle& Handle)
+{
+	try
+	{
+		Handle.RethrowException();
+	}
+	catch (const ExceptionType&)
+	{
+		return true;
+	}
+	catch (...)
+	{
+	}
+	return false;
+}
+
+
+// A Once task that throws does not stop its thread, and the exception reaches the handle, the sink and the statistics
+static void TestOnceTaskExceptions()
+{
+	MultithreadingPoolConfig Config("OnceExceptions");
+	Config.MaxNumOfThreads = 1;
+	MultithreadingModule Module(Config);
+	Module.StartThreads();
+	const unsigned int NumOfThreads = Module.GetNumOfThreads();
+
+	ResetSinkCounters();
+	MultithreadingModule::SetTaskErrorSink(CountSinkException);
+
+	const TaskHandle StandardError = Module.AddTaskWithHandle(new ThreadFunctionTask([]() { throw std::runtime_error("Task error"); }));
+	const TaskHandle IntError = Module.AddTaskWithHandle(new ThreadFunctionTask([]() { throw 7; }));
+
+	// The only thread of the pool executes this task after both exceptions
+	std::atomic<bool> bExecutedAfter(false);
+	const TaskHandle After = Module.AddTaskWithHandle(new ThreadFunctionTask([&bExecutedAfter]() { bExecutedAfter.store(true); }));
+
+	Check(StandardError.WaitFor(10000) && IntError.WaitFor(10000), "Tasks that throw are completed");
+	Check(After.WaitFor(10000) && bExecutedAfter.load(), "The thread executes tasks after the exceptions");
+	Check(!After.HasException(), "A task that does not throw has no exception");
+	Check(Module.GetNumOfThreads() == NumOfThreads, "Exceptions do not change the number of threads");
+
+	Check(StandardError.GetNumOfExceptions() == 1 && HoldsException<std::runtime_error>(StandardError), "The handle receives a std::exception");
+	Check(IntError.GetNumOfExceptions() == 1 && HoldsException<int>(IntError), "The handle receives an exception that is not a std::exception");
+
+	Check(NumOfSinkRuntimeErrors.load() == 1, "The sink receives the std::exception");
+	Check(NumOfSinkInts.load() == 1, "The sink receives the exception that is not a std::exception");
+	Check(NumOfSinkTasks.load() == 2, "The sink receives the task that threw");
+	Check(WaitUntil([&Module]() { return Module.GetStatistics().NumOfTaskExceptions == 2; }), "NumOfTaskExceptions counts both exceptions");
+#if MULTITHREADING_ENABLE_STATISTICS
+	Check(WaitUntil([&Module]() { return Module.GetStatistics().Total.NumOfExceptions == 2; }), "The statistics of the thread count both exceptions");
+#endif
+
+	MultithreadingModule::SetTaskErrorSink(TaskErrorSink());
+	Module.StopThreads();
+}
+
+// A Tick task can throw in every Tick, each exception is reported and the task stays registered
+static void TestTickTaskExceptions()
+{
+	const unsigned int NumOfTicks = 5;
+
+	MultithreadingPoolConfig Config("TickExceptions");
+	Config.MaxNumOfThreads = 2;
+	MultithreadingModule Module(Config);
+	Module.StartThreads();
+	const unsigned int NumOfThreads = Module.GetNumOfThreads();
+
+	ResetSinkCounters();
+	MultithreadingModule::SetTaskErrorSink(CountSinkException);
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	const TaskHandle Handle = Module.AddTaskWithHandle(new ThreadFunctionTask([&NumOfExecutions](const float&)
+	{
+		// Even executions throw an int, odd ones a std::exception
+		if (NumOfExecutions++ % 2 == 0)
+		{
+			throw 3;
+		}
+		throw std::logic_error("Tick error");
+	}));
+
+	for (unsigned int i = 0; i < NumOfTicks; i++)
+	{
+		Module.Tick(0.0f);
+	}
+
+	Check(NumOfExecutions.load() == NumOfTicks, "A Tick task that throws is executed in every Tick");
+	Check(!Handle.IsCompleted(), "A Tick task that throws stays registered");
+	Check(Handle.GetNumOfExceptions() == NumOfTicks, "The handle counts an exception for every Tick");
+	Check(HoldsException<int>(Handle), "The handle keeps the first exception");
+	Check(Module.GetNumOfThreads() == NumOfThreads, "Exceptions of Tick tasks do not change the number of threads");
+
+	Check(NumOfSinkInts.load() == (NumOfTicks + 1) / 2, "The sink receives every exception that is not a std::exception");
+	Check(NumOfSinkRuntimeErrors.load() == 0, "A std::logic_error is not taken for a std::runtime_error");
+	Check(NumOfSinkTasks.load() == NumOfTicks, "The sink receives every exception of the Tick task");
+	Check(Module.GetStatistics().NumOfTaskExceptions == NumOfTicks, "NumOfTaskExceptions counts every exception of the Tick task");
+
+	MultithreadingModule::SetTaskErrorSink(TaskErrorSink());
+	Module.RemoveTask(Handle);
+	Module.Tick(0.0f);
+	Check(Handle.WaitFor(10000), "A removed Tick task is completed");
+	Module.StopThreads();
+}
+
+int main()
+{
+	TestOnceTaskExceptions();
+	TestTickTaskExceptions();
+	return FinishChecks();
+}
@@ -0,0 +1,162 @@
+// Tests of fork/join with TaskGroup
+//
+// Usage: TaskGroupTests, the exit code is the number of failed checks
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include "MultithreadingModule.h"
+#include "TaskGroup.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+
+// Every standard thread waits for a group in a Tick task, so the groups are completed only by the waiting threads themselves
+static void TestNestedForkJoinFromTickTasks()
+{
+	const unsigned int NumOfTickTasks = 8;
+	const unsigned int NumOfFunctions = 4;
+	const unsigned int NumOfTicks = 20;
+
+	MultithreadingPoolConfig Config("NestedForkJoin");
+	Config.MaxNumOfThreads = 4;
+	MultithreadingModule Module(Config);
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	for (unsigned int i = 0; i < NumOfTickTasks; i++)
+	{
+		Module.AddTask(new ThreadFunctionTask([&Module, &NumOfExecutions](const float&)
+		{
+			TaskGroup Outer(&Module);
+			for (unsigned int j = 0; j < NumOfFunctions; j++)
+			{
+				Outer.Run([&Module, &NumOfExecutions]()
+				{
+					TaskGroup Inner(&Module);
+					for (unsigned int k = 0; k < NumOfFunctions; k++)
+					{
+						Inner.Run([&NumOfExecutions]() { NumOfExecutions++; });
+					}
+					Inner.Wait();
+				});
+			}
+			Outer.Wait();
+		}));
+	}
+
+	CheckCompletes([&Module]()
+	{
+		for (unsigned int Tick = 0; Tick < NumOfTicks; Tick++)
+		{
+			Module.Tick(0.016f);
+		}
+	}, "nested groups waited for by every thread complete");
+
+	Check(NumOfExecutions.load() == NumOfTickTasks * NumOfFunctions * NumOfFunctions * NumOfTicks, "every nested function is executed once");
+
+	Module.StopThreads();
+}
+
+static void TestExceptions()
+{
+	MultithreadingPoolConfig Config("TaskGroupExceptions");
+	Config.MaxNumOfThreads = 2;
+	MultithreadingModule Module(Config);
+	Module.StartThreads();
+
+	std::atomic<unsigned int> NumOfExecutions(0);
+	TaskGroup Group(&Module);
+	for (int i = 0; i < 20; i++)
+	{
+		Group.Run([&NumOfExecutions, i]()
+		{
+			NumOfExecutions++;
+			if (i == 5)
+			{
+				throw std::runtime_error("Function failed");
+			}
+			if (i == 10)
+			{
+				throw 10;
+			}
+		});
+	}
+	Group.Wait();
+
+	Check(Group.IsCompleted() && NumOfExecutions.load() == 20, "an exception does not stop the other functions");
+
+	bool bStandardException = false;
+	bool bOtherException = false;
+	try
+	{
+		std::rethrow_exception(Group.GetException());
+	}
+	catch (const std::runtime_error&)
+	{
+		bStandardException = true;
+	}
+	catch (int)
+	{
+		bOtherException = true;
+	}
+	Check(bStandardException || bOtherException, "the group keeps the first exception");
+
+	// Exceptions of other types than std::exception are kept as well
+	TaskGroup OtherGroup(&Module);
+	OtherGroup.Run([]() { throw 10; });
+	OtherGroup.Wait();
+
+	int Thrown = 0;
+	try
+	{
+		std::rethrow_exception(OtherGroup.GetException());
+	}
+	catch (int Value)
+	{
+		Thrown = Value;
+	}
+	Check(Thrown == 10, "the group keeps an exception that is not a std::exception");
+
+	Module.StopThreads();
+}
+
+static void TestCancel()
+{
+	// Without a module the functions are executed only by Wait, so none has been started before Cancel
+	std::atomic<unsigned int> NumOfExecutions(0);
+	TaskGroup Group(nullptr);
+	for (int i = 0; i < 10; i++)
+	{
+		Group.Run([&NumOfExecutions]() { NumOfExecutions++; });
+	}
+	Check(!Group.IsCompleted(), "a group with pending functions is not completed");
+
+	Group.Cancel();
+	Check(Group.IsCompleted(), "cancelling removes the functions that have not been started");
+	Group.Wait();
+	Check(NumOfExecutions.load() == 0, "cancelled functions are not executed");
+
+	// A function can cancel the rest of its own group, Wait takes the newest function first
+	for (int i = 0; i < 5; i++)
+	{
+		Group.Run([&NumOfExecutions]() { NumOfExecutions++; });
+	}
+	Group.Run([&Group]() { Group.Cancel(); });
+	Group.Wait();
+	Check(Group.IsCompleted() && NumOfExecutions.load() == 0, "a function cancels the functions of its group that have not been started");
+
+	// The group can be used again after Cancel
+	Group.Run([&NumOfExecutions]() { NumOfExecutions++; });
+	Group.Wait();
+	Check(NumOfExecutions.load() == 1, "a cancelled group executes the functions added later");
+}
+
+
+int main()
+{
+	TestNestedForkJoinFromTickTasks();
+	TestExceptions();
+	TestCancel();
+
+	return FinishChecks();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Checks shared by the test executables
+// Every test executable is a single translation unit, so the counter of failed checks is file local
+
+static unsigned int NumOfFailures = 0;
+
+// Records a failed check
+// @param bCondition - Result of the check
+// @param Description - What the check expects, printed when it fails
+static void Check(bool bCondition, const char* Description)
+{
+	if (!bCondition)
+	{
+		std::cerr << "FAILED: " << Description << "\n";
+		NumOfFailures++;
+	}
+}
+
+// Waits until the condition is satisfied by the threads of a pool
+// @param IsSatisfied - callable that returns true when the wait is over
+// @param Timeout - maximum time in milliseconds to wait
+// @return false if the time ran out
+template<typename Condition>
+static bool WaitUntil(const Condition& IsSatisfied, unsigned int Timeout = 10000)
+{
+	const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Timeout);
+	while (!IsSatisfied())
+	{
+		if (std::chrono::steady_clock::now() >= Deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	return true;
+}
+
+// Calls a function that may hang on a separate thread
+// A hang is reported as a failed check and ends the test, since the hung thread can not be joined
+// @param Function - callable to execute
+// @param Description - what the check expects, printed when it fails
+// @param Timeout - maximum time in milliseconds to wait for the function
+template<typename Callable>
+static void CheckCompletes(const Callable& Function, const char* Description, unsigned int Timeout = 60000)
+{
+	std::atomic<bool> bCompleted(false);
+	std::thread Caller([&Function, &bCompleted]()
+	{
+		Function();
+		bCompleted.store(true);
+	});
+
+	if (!WaitUntil([&bCompleted]() { return bCompleted.load(); }, Timeout))
+	{
+		Check(false, Description);
+		std::cerr << "The test is stopped, since the function did not complete\n";
+		std::_Exit(static_cast<int>(NumOfFailures));
+	}
+	Caller.join();
+}
+
+// Prints the summary of the checks
+// @return Number of failed checks, used as the exit code of the test
+static int FinishChecks()
+{
+	if (NumOfFailures == 0)
+	{
+		std::cout << "All checks passed\n";
+	}
+
+	return static_cast<int>(NumOfFailures);
+}
@@ -0,0 +1,96 @@
+// Tests of the phase rules of TickSchedule
+//
+// Usage: TickScheduleTests, the exit code is the number of failed checks
+
+#include <vector>
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+#include "TickSchedule.h"
+
+static ThreadTask* CreateTask()
+{
+	return new ThreadFunctionTask([](const float&) {});
+}
+
+// Returns the phase of the task, or -1 if the schedule does not contain it
+static int FindPhase(const std::vector<std::vector<ThreadTask*>>& Phases, const ThreadTask* Task)
+{
+	for (size_t Phase = 0; Phase < Phases.size(); Phase++)
+	{
+		for (size_t i = 0; i < Phases[Phase].size(); i++)
+		{
+			if (Phases[Phase][i] == Task)
+			{
+				return static_cast<int>(Phase);
+			}
+		}
+	}
+
+	return -1;
+}
+
+
+static void TestSchedulePhases()
+{
+	ThreadTask* FirstWriter = CreateTask();
+	FirstWriter->DeclareWrite("A");
+	ThreadTask* FirstReader = CreateTask();
+	FirstReader->DeclareRead("A");
+	ThreadTask* SecondReader = CreateTask();
+	SecondReader->DeclareRead("A");
+	ThreadTask* SecondWriter = CreateTask();
+	SecondWriter->DeclareWrite("A");
+	ThreadTask* OtherWriter = CreateTask();
+	OtherWriter->DeclareWrite("B");
+	ThreadTask* Free = CreateTask();
+	ThreadTask* SecondFree = CreateTask();
+
+	TickSchedule Schedule;
+	Schedule.Add(FirstWriter);
+	Schedule.Add(FirstReader);
+	Schedule.Add(SecondReader);
+	Schedule.Add(SecondWriter);
+	Schedule.Add(OtherWriter);
+	Schedule.Add(Free);
+
+	const std::vector<std::vector<ThreadTask*>>& Phases = Schedule.GetPhases();
+	Check(Phases.size() == 3, "a writer, two readers and a writer of one resource take three phases");
+	Check(FindPhase(Phases, FirstWriter) == 0, "the first writer is executed first");
+	Check(FindPhase(Phases, FirstReader) == 1 && FindPhase(Phases, SecondReader) == 1, "readers follow the writer and share a phase");
+	Check(FindPhase(Phases, SecondWriter) == 2, "a writer follows all earlier readers");
+	Check(FindPhase(Phases, OtherWriter) == 0, "a writer of another resource does not wait");
+	Check(FindPhase(Phases, Free) == 0, "a task without resources is in the first phase");
+
+	// Tasks without resources do not rebuild the phases
+	const unsigned long long NumOfBuilds = Schedule.GetNumOfBuilds();
+	Schedule.Add(SecondFree);
+	Schedule.Remove(Free);
+	Check(FindPhase(Schedule.GetPhases(), SecondFree) == 0 && FindPhase(Schedule.GetPhases(), Free) == -1, "tasks without resources are added and removed in place");
+	Check(Schedule.GetNumOfBuilds() == NumOfBuilds, "tasks without resources do not rebuild the phases");
+
+	// Without the readers the second writer only follows the first one
+	Schedule.Remove(FirstReader);
+	Schedule.Remove(SecondReader);
+	Check(FindPhase(Schedule.GetPhases(), SecondWriter) == 1 && Schedule.GetPhases().size() == 2, "removing readers moves the writer to an earlier phase");
+	Check(Schedule.GetNumOfBuilds() == NumOfBuilds + 1, "removing tasks with resources rebuilds the phases once");
+	Check(FindPhase(Schedule.GetPhases(), SecondFree) == 0 && FindPhase(Schedule.GetPhases(), OtherWriter) == 0, "a rebuild keeps the other tasks in the first phase");
+
+	Schedule.Clear();
+	Check(Schedule.GetPhases().empty(), "clear removes all phases");
+
+	delete FirstWriter;
+	delete FirstReader;
+	delete SecondReader;
+	delete SecondWriter;
+	delete OtherWriter;
+	delete Free;
+	delete SecondFree;
+}
+
+
+int main()
+{
+	TestSchedulePhases();
+
+	return FinishChecks();
+}
@@ -0,0 +1,51 @@
+// Tests of the order of TickTaskChangeBuffer
+//
+// Usage: TickTaskChangeBufferTests, the exit code is the number of failed checks
+
+#include <vector>
+#include "TestCheck.h"
+#include "TickTaskChangeBuffer.h"
+
+static void TestChangeBufferOrder()
+{
+	TickTaskChangeBuffer Buffer;
+	Check(Buffer.IsEmpty() && Buffer.TakeAll() == nullptr, "a new buffer is empty");
+
+	std::vector<TickTaskChange*> Pushed;
+	for (int i = 0; i < 5; i++)
+	{
+		TickTaskChange* Change = new TickTaskChange();
+		Change->bAdd = i % 2 == 0;
+		Pushed.push_back(Change);
+		Buffer.Push(Change);
+	}
+	Check(!Buffer.IsEmpty(), "a buffer with changes is not empty");
+
+	// Changes are drained in the order they were pushed
+	TickTaskChange* Change = Buffer.TakeAll();
+	Check(Buffer.IsEmpty(), "taking the changes empties the buffer");
+
+	size_t NumOfChanges = 0;
+	bool bInOrder = true;
+	while (Change != nullptr)
+	{
+		if (NumOfChanges >= Pushed.size() || Change != Pushed[NumOfChanges])
+		{
+			bInOrder = false;
+		}
+		NumOfChanges++;
+
+		TickTaskChange* Next = Change->Next;
+		delete Change;
+		Change = Next;
+	}
+	Check(bInOrder && NumOfChanges == Pushed.size(), "changes are taken in FIFO order");
+}
+
+
+int main()
+{
+	TestChangeBufferOrder();
+
+	return FinishChecks();
+}
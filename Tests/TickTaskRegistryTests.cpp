@@ -0,0 +1,51 @@
+// Tests of the TickTaskRegistry identifiers
+//
+// Usage: TickTaskRegistryTests, the exit code is the number of failed checks
+
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+#include "TickTaskRegistry.h"
+
+static ThreadTask* CreateTask()
+{
+	return new ThreadFunctionTask([](const float&) {});
+}
+
+
+static void TestRegistryGenerations()
+{
+	ThreadTask* First = CreateTask();
+	ThreadTask* Second = CreateTask();
+	ThreadTask* Third = CreateTask();
+
+	TickTaskRegistry Registry;
+	const TickTaskId FirstId = Registry.Add(First);
+	const TickTaskId SecondId = Registry.Add(Second);
+	Check(FirstId.IsValid() && SecondId.IsValid(), "registry gives valid identifiers");
+	Check(Registry.Get(FirstId) == First && Registry.Get(SecondId) == Second, "registry finds added tasks");
+
+	Check(Registry.Remove(FirstId) == First, "registry removes a task by its identifier");
+	Check(Registry.Size() == 1 && Registry[0] == Second, "the last task takes the place of the removed one");
+	Check(Registry.Get(FirstId) == nullptr, "a removed identifier is stale");
+	Check(Registry.Remove(FirstId) == nullptr, "a stale identifier removes nothing");
+
+	// The freed slot is reused with a new generation, so the old identifier still does not match
+	const TickTaskId ThirdId = Registry.Add(Third);
+	Check(ThirdId.Index == FirstId.Index && ThirdId.Generation != FirstId.Generation, "a reused slot changes its generation");
+	Check(Registry.Get(FirstId) == nullptr && Registry.Get(ThirdId) == Third, "a stale identifier does not match the reused slot");
+
+	Registry.Clear();
+	Check(Registry.IsEmpty() && Registry.Get(SecondId) == nullptr && Registry.Get(ThirdId) == nullptr, "clear invalidates all identifiers");
+
+	delete First;
+	delete Second;
+	delete Third;
+}
+
+
+int main()
+{
+	TestRegistryGenerations();
+
+	return FinishChecks();
+}
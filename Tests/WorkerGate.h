@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "MultithreadingModule.h"
+#include "TestCheck.h"
+#include "ThreadFunctionTask.h"
+
+// Keeps the only thread of a pool busy, so that the queued tasks stay in the queue
+class WorkerGate
+{
+private:
+	std::atomic<bool> bEntered;
+	std::atomic<bool> bReleased;
+
+public:
+	WorkerGate() : bEntered(false), bReleased(false) {}
+
+	// Adds a task that occupies the thread and waits until it has been taken from the queue
+	void Close(MultithreadingModule& Module)
+	{
+		Module.AddTask(new ThreadFunctionTask([this]()
+		{
+			bEntered.store(true);
+			while (!bReleased.load())
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}));
+		WaitUntil([this]() { return bEntered.load(); });
+	}
+
+	// Lets the thread take the queued tasks
+	void Open()
+	{
+		bReleased.store(true);
+	}
+};